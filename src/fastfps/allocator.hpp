@@ -0,0 +1,193 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "fastfps/stats.hpp"
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace fastfps {
+
+namespace internal {
+
+inline constexpr size_t HUGE_PAGE = size_t(2) << 20;
+
+inline std::atomic<bool>& huge_pages_flag() {
+    static std::atomic<bool> flag = false;
+    return flag;
+}
+
+// Buffers of two huge pages or more are aligned to a huge page (and
+// freed with the same alignment, which only depends on the size).
+inline size_t alloc_align(size_t bytes, size_t align) {
+    return bytes >= 2 * HUGE_PAGE ? std::max(align, HUGE_PAGE) : align;
+}
+
+inline void* aligned_new(size_t bytes, size_t align) {
+    FASTFPS_STATS_ALLOC(bytes);
+    const size_t a = alloc_align(bytes, align);
+    void* p = ::operator new(bytes, std::align_val_t(a));
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if (a == HUGE_PAGE && huge_pages_flag().load(std::memory_order_relaxed)) {
+        madvise(p, bytes, MADV_HUGEPAGE);
+    }
+#endif
+    return p;
+}
+
+inline void aligned_delete(void* p, size_t bytes, size_t align) noexcept {
+    ::operator delete(p, std::align_val_t(alloc_align(bytes, align)));
+}
+
+}  // namespace internal
+
+// Whether buffers of 4 MiB or more (AlignedAllocator and Workspace) are
+// backed by transparent huge pages, by madvise(MADV_HUGEPAGE) on Linux.
+// With 2 MiB pages, the strided passes of a large transform do not miss the
+// TLB. Off by default, as fft_options(); it applies to the buffers allocated
+// afterwards.
+inline bool huge_pages() { return internal::huge_pages_flag(); }
+inline void set_huge_pages(bool on) { internal::huge_pages_flag() = on; }
+
+// std::allocator with ALIGN-byte aligned storage.
+// ModInt8 loads / stores are unaligned instructions, but with a 64-byte
+// aligned buffer no block of the vector crosses a cache line.
+template <class T, size_t ALIGN = 64> struct AlignedAllocator {
+    using value_type = T;
+    template <class U> struct rebind {
+        using other = AlignedAllocator<U, ALIGN>;
+    };
+
+    AlignedAllocator() = default;
+    template <class U>
+    AlignedAllocator(const AlignedAllocator<U, ALIGN>&) noexcept {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(internal::aligned_new(n * sizeof(T), ALIGN));
+    }
+    void deallocate(T* p, size_t n) noexcept {
+        internal::aligned_delete(p, n * sizeof(T), ALIGN);
+    }
+
+    template <class U>
+    friend bool operator==(const AlignedAllocator&,
+                           const AlignedAllocator<U, ALIGN>&) {
+        return true;
+    }
+};
+
+// Thread-local bump allocator for scratch buffers.
+//
+//   Workspace::Frame frame;
+//   std::span<modint8> buf = frame.alloc<modint8>(n);
+//
+// Memory allocated through a frame is released when the frame is
+// destroyed (frames must be nested). If a request does not fit, a separate
+// block is allocated (and freed with its frame) and, when the outermost
+// frame ends, the main buffer is grown to the peak usage. So after the
+// first call of an algorithm, the same call does not touch the heap.
+class Workspace {
+  public:
+    static constexpr size_t ALIGN = 64;
+
+    static Workspace& get() {
+        static thread_local Workspace ws;
+        return ws;
+    }
+
+    class Frame {
+      public:
+        Frame()
+            : ws(Workspace::get()), mark(ws.used), extras(ws.extra.size()) {
+            ws.depth++;
+        }
+        ~Frame() { ws.release(mark, extras); }
+        Frame(const Frame&) = delete;
+        Frame& operator=(const Frame&) = delete;
+
+        // n default-constructed (for ModInt8: zero) elements
+        template <class T> std::span<T> alloc(size_t n) {
+            static_assert(std::is_trivially_destructible_v<T>);
+            static_assert(alignof(T) <= ALIGN);
+            T* p = static_cast<T*>(ws.alloc(n * sizeof(T)));
+            std::uninitialized_default_construct_n(p, n);
+            return {p, n};
+        }
+
+      private:
+        Workspace& ws;
+        // used and the number of extra blocks when the frame began
+        size_t mark, extras;
+    };
+
+    // bytes of the main buffer
+    size_t capacity() const { return cap; }
+    // bytes of the blocks outside the main buffer, held by the live frames
+    size_t extra_bytes() const { return extra_size; }
+
+  private:
+    struct Deleter {
+        size_t bytes;
+        void operator()(std::byte* p) const {
+            internal::aligned_delete(p, bytes, ALIGN);
+        }
+    };
+    using Block = std::unique_ptr<std::byte, Deleter>;
+
+    Block buf;
+    size_t cap = 0, used = 0;
+    // blocks which did not fit in buf, and the total size of them
+    std::vector<Block> extra;
+    size_t extra_size = 0, peak = 0;
+    int depth = 0;
+
+    static Block new_block(size_t bytes) {
+        return Block(
+            static_cast<std::byte*>(internal::aligned_new(bytes, ALIGN)),
+            Deleter{bytes});
+    }
+
+    void* alloc(size_t bytes) {
+        assert(depth > 0);
+        bytes = (bytes + ALIGN - 1) / ALIGN * ALIGN;
+        void* p;
+        if (used + bytes <= cap) {
+            p = buf.get() + used;
+            used += bytes;
+        } else {
+            extra.push_back(new_block(std::max<size_t>(bytes, ALIGN)));
+            extra_size += extra.back().get_deleter().bytes;
+            p = extra.back().get();
+        }
+        peak = std::max(peak, used + extra_size);
+        return p;
+    }
+
+    void release(size_t mark, size_t extras) {
+        used = mark;
+        // the blocks of the frame (peak keeps their size for the regrow)
+        while (extra.size() > extras) {
+            extra_size -= extra.back().get_deleter().bytes;
+            extra.pop_back();
+        }
+        if (--depth) return;
+        assert(used == 0 && extra.empty());
+        if (cap < peak) {
+            cap = std::max(peak, 2 * cap);
+            buf = new_block(cap);
+        }
+        peak = 0;
+    }
+};
+
+}  // namespace fastfps
@@ -0,0 +1,355 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <span>
+#include <vector>
+
+#include "fastfps/factorial.hpp"
+#include "fastfps/fft.hpp"
+#include "fastfps/modvec.hpp"
+#include "fastfps/parallel.hpp"
+
+namespace fastfps {
+
+// c[k] = a[k] * b[k] for each k
+//
+// Problems are processed 8 at a time: the coefficients of the j-th problem
+// of a group are stored in lane j (transposed layout), so each butterfly is
+// a vertical operation and no in-lane shuffle (fft_single) is needed.
+template <class modint8>
+std::vector<BasicModVec<modint8>> batch_convolve(
+    std::span<const BasicModVec<modint8>> a,
+    std::span<const BasicModVec<modint8>> b) {
+    using modint = typename modint8::modint;
+    using modvec = BasicModVec<modint8>;
+
+    assert(a.size() == b.size());
+    std::vector<modvec> c(a.size());
+
+    auto len = [&](size_t k) {
+        return ssize_t(a[k].size() + b[k].size()) - 1;
+    };
+
+    // group problems of similar length
+    std::vector<size_t> ord;
+    for (size_t k = 0; k < a.size(); k++) {
+        if (a[k].size() && b[k].size()) ord.push_back(k);
+    }
+    std::stable_sort(ord.begin(), ord.end(),
+                     [&](size_t l, size_t r) { return len(l) < len(r); });
+
+    std::vector<modint8> fa, fb;
+    for (size_t start = 0; start < ord.size(); start += 8) {
+        const int cnt = int(std::min<size_t>(8, ord.size() - start));
+        const std::span<const size_t> ids(ord.data() + start, cnt);
+
+        ssize_t max_len = 0;
+        for (size_t k : ids) max_len = std::max(max_len, len(k));
+        const ssize_t m =
+            std::max<ssize_t>(8, (ssize_t)std::bit_ceil((size_t)max_len));
+
+        // dst[8 * i + l][j] = src[ids[j]][8 * i + l]
+        auto load = [&](std::span<const modvec> src,
+                        std::vector<modint8>& dst) {
+            dst.assign(m, modint8());
+            ssize_t sz = 0;
+            for (size_t k : ids) sz = std::max(sz, std::ssize(src[k].blocks()));
+            for (ssize_t i = 0; i < sz; i++) {
+                std::array<modint8, 8> buf{};
+                for (int j = 0; j < cnt; j++) {
+                    auto v = src[ids[j]].blocks();
+                    if (i < std::ssize(v)) buf[j] = v[i];
+                }
+                modint8::transpose(buf);
+                std::copy(buf.begin(), buf.end(), dst.begin() + 8 * i);
+            }
+        };
+        load(a, fa);
+        load(b, fb);
+
+        internal::fft_lanes(fa, fb);
+        for (ssize_t i = 0; i < m; i++) {
+            fa[i] *= fb[i];
+        }
+        ifft_lanes(fa);
+
+        for (size_t k : ids) c[k] = modvec(len(k));
+        const modint8 inv = modint8::set1(modint(m).inv());
+        for (ssize_t i = 0; i < (max_len + 7) / 8; i++) {
+            std::array<modint8, 8> buf;
+            for (int l = 0; l < 8; l++) {
+                buf[l] = fa[8 * i + l] * inv;
+            }
+            modint8::transpose(buf);
+            for (int j = 0; j < cnt; j++) {
+                auto v = c[ids[j]].blocks();
+                if (i < std::ssize(v)) v[i] = buf[j];
+            }
+        }
+    }
+    return c;
+}
+
+template <class modint8>
+std::vector<BasicModVec<modint8>> batch_convolve(
+    const std::vector<BasicModVec<modint8>>& a,
+    const std::vector<BasicModVec<modint8>>& b) {
+    return batch_convolve(std::span<const BasicModVec<modint8>>(a),
+                          std::span<const BasicModVec<modint8>>(b));
+}
+
+namespace internal {
+
+// out[j] = f[j] * f[j + 8] * f[j + 16] * ... (j < min(8, |f|)), each
+// product of at most len coefficients
+//
+// Lane j of acc holds the j-th product (transposed layout), and each row of
+// 8 factors is multiplied in by a schoolbook from the top, in place.
+template <class modvec>
+void product_lanes(std::span<const modvec* const> f,
+                   std::span<modvec> out,
+                   ssize_t len) {
+    using modint8 = typename modvec::modint8;
+    using modint = typename modint8::modint;
+    Workspace::Frame frame;
+    auto acc = frame.alloc<modint8>(8 * ((len + 7) / 8));
+    auto g = frame.alloc<modint8>(acc.size());
+    std::array<modint, 8> one{};
+    one[0] = modint(1);
+    acc[0] = modint8::set1(1);
+    ssize_t n = 1;
+    std::array<ssize_t, 8> lane_len;
+    lane_len.fill(1);
+    for (size_t r = 0; r < f.size(); r += 8) {
+        const int cnt = int(std::min<size_t>(8, f.size() - r));
+        ssize_t m = 0;
+        for (int j = 0; j < cnt; j++) {
+            m = std::max(m, ssize_t(f[r + j]->size()));
+            lane_len[j] += f[r + j]->size() - 1;
+        }
+        // g[i][j] = f[r + j][i], and a missing factor is 1
+        for (ssize_t b = 0; b < (m + 7) / 8; b++) {
+            std::array<modint8, 8> buf{};
+            for (int j = 0; j < 8; j++) {
+                if (j >= cnt) {
+                    if (b == 0) buf[j] = modint8(one);
+                    continue;
+                }
+                auto v = f[r + j]->blocks();
+                if (b < std::ssize(v)) buf[j] = v[b];
+            }
+            modint8::transpose(buf);
+            std::ranges::copy(buf, g.begin() + 8 * b);
+        }
+        // every lane stays within len, so the coefficients from len on are
+        // 0 (n + m - 1 sums the largest sizes of different lanes)
+        for (ssize_t k = std::min(n + m - 2, len - 1); k >= 0; k--) {
+            modint8 sum;
+            const ssize_t hi = std::min(k, m - 1);
+            for (ssize_t i = std::max<ssize_t>(0, k - n + 1); i <= hi; i++) {
+                sum += acc[k - i] * g[i];
+            }
+            acc[k] = sum;
+        }
+        n = std::min(n + m - 1, len);
+    }
+    const int cnt = int(std::min<size_t>(8, f.size()));
+    for (int j = 0; j < cnt; j++) out[j] = modvec(lane_len[j]);
+    for (ssize_t b = 0; b < (n + 7) / 8; b++) {
+        std::array<modint8, 8> buf;
+        std::ranges::copy(acc.subspan(8 * b, 8), buf.begin());
+        modint8::transpose(buf);
+        for (int j = 0; j < cnt; j++) {
+            auto v = out[j].blocks();
+            if (b < std::ssize(v)) v[b] = buf[j];
+        }
+    }
+}
+
+}  // namespace internal
+
+// fs[0] * fs[1] * ... (1 for no factors)
+//
+// The factors are sorted by size. Small ones are first multiplied 8 at a
+// time by internal::product_lanes, up to LEAF_LEN coefficients per
+// product. Then the products are merged by size: each round sorts them and
+// multiplies the 1st and 2nd smallest, the 3rd and 4th, ..., so that the
+// operands of each product stay balanced. Small products of a round go
+// through batch_convolve and large ones through operator*=. The tasks of
+// each phase run concurrently on the thread pool.
+template <class modint8>
+BasicModVec<modint8> product(std::span<const BasicModVec<modint8>> fs) {
+    using modint = typename modint8::modint;
+    using modvec = BasicModVec<modint8>;
+    constexpr size_t LEAF_LEN = 32;
+    // products up to this size go through batch_convolve
+    constexpr size_t BATCH_LEN = 256;
+    // the grain of product_lanes groups / pairs of batch_convolve per task
+    constexpr ssize_t LEAF_TASK = 16;
+    constexpr ssize_t BATCH_TASK = 256;
+
+    if (fs.empty()) return modvec({1});
+    for (const auto& f : fs) {
+        if (f.size() == 0) return modvec();
+    }
+    const u32 mod = modint::mod();
+    // the modulus of DynModInt is thread_local
+    auto set_mod = [mod] {
+        if constexpr (requires { modint::set_mod(mod); }) {
+            modint::set_mod(mod);
+        }
+    };
+
+    std::vector<const modvec*> ord;
+    for (const auto& f : fs) ord.push_back(&f);
+    std::ranges::stable_sort(ord, {}, &modvec::size);
+    size_t small = 0;
+    while (small < ord.size() && ord[small]->size() <= LEAF_LEN) small++;
+
+    // the leaf groups ord[group[t], group[t + 1]): rows of 8 factors are
+    // added while each lane stays within LEAF_LEN
+    std::vector<size_t> group = {0}, out = {0};
+    while (group.back() < small) {
+        const size_t s = group.back();
+        size_t e = s;
+        std::array<size_t, 8> lane_len;
+        lane_len.fill(1);
+        while (e < small) {
+            const size_t r = std::min(e + 8, small);
+            bool fits = true;
+            for (size_t j = e; j < r; j++) {
+                fits &= lane_len[j - e] + ord[j]->size() - 1 <= LEAF_LEN;
+            }
+            if (!fits) break;
+            for (size_t j = e; j < r; j++) {
+                lane_len[j - e] += ord[j]->size() - 1;
+            }
+            e = r;
+        }
+        group.push_back(e);
+        out.push_back(out.back() + std::min<size_t>(8, e - s));
+    }
+    const ssize_t groups = std::ssize(group) - 1;
+    std::vector<modvec> cur(out.back() + (ord.size() - small));
+    for (size_t i = small; i < ord.size(); i++) {
+        cur[out.back() + (i - small)] = *ord[i];
+    }
+    parallel_for(
+        groups,
+        [&](ssize_t i) {
+            set_mod();
+            internal::product_lanes<modvec>(
+                std::span(ord).subspan(group[i], group[i + 1] - group[i]),
+                std::span(cur).subspan(out[i]), LEAF_LEN);
+        },
+        LEAF_TASK);
+
+    while (cur.size() > 1) {
+        std::ranges::stable_sort(cur, {}, &modvec::size);
+        const ssize_t pairs = std::ssize(cur) / 2;
+        std::vector<modvec> next(pairs + cur.size() % 2);
+        if (cur.size() % 2) next.back() = std::move(cur.back());
+        // the pairs [0, batched) go through batch_convolve
+        ssize_t batched = 0;
+        while (batched < pairs &&
+               cur[2 * batched].size() + cur[2 * batched + 1].size() - 1 <=
+                   BATCH_LEN) {
+            batched++;
+        }
+        const ssize_t batches = (batched + BATCH_TASK - 1) / BATCH_TASK;
+        parallel_for(batches + pairs - batched, [&](ssize_t t) {
+            set_mod();
+            if (t < batches) {
+                const ssize_t l = t * BATCH_TASK;
+                const ssize_t r = std::min(batched, l + BATCH_TASK);
+                std::vector<modvec> a(r - l), b(r - l);
+                for (ssize_t i = l; i < r; i++) {
+                    a[i - l] = std::move(cur[2 * i]);
+                    b[i - l] = std::move(cur[2 * i + 1]);
+                }
+                auto c = batch_convolve(a, b);
+                for (ssize_t i = l; i < r; i++) next[i] = std::move(c[i - l]);
+            } else {
+                const ssize_t i = batched + (t - batches);
+                next[i] = std::move(cur[2 * i]);
+                next[i] *= std::move(cur[2 * i + 1]);
+            }
+        });
+        cur = std::move(next);
+    }
+    return std::move(cur[0]);
+}
+
+template <class modint8>
+BasicModVec<modint8> product(const std::vector<BasicModVec<modint8>>& fs) {
+    return product(std::span<const BasicModVec<modint8>>(fs));
+}
+
+namespace internal {
+
+template <class modint8>
+void batch_inv(std::span<typename modint8::modint> a) {
+    using modint = typename modint8::modint;
+    const ssize_t n = std::ssize(a), nb = (n + 7) / 8;
+    if (n == 0) return;
+    // the i-th block of a, the last one padded with 1
+    auto load = [&](ssize_t i) {
+        if (8 * i + 8 <= n) {
+            return modint8(a.subspan(8 * i).template first<8>());
+        }
+        std::array<modint, 8> b;
+        b.fill(modint(1));
+        std::ranges::copy(a.subspan(8 * i), b.begin());
+        return modint8(b);
+    };
+    auto store = [&](ssize_t i, const modint8& x) {
+        if (8 * i + 8 <= n) {
+            return x.store(a.subspan(8 * i).template first<8>());
+        }
+        std::array<modint, 8> b;
+        x.store(b);
+        std::ranges::copy_n(b.begin(), n - 8 * i, a.begin() + 8 * i);
+    };
+
+    Workspace::Frame frame;
+    auto pre = frame.alloc<modint8>(nb);
+    const auto one = modint8::set1(1);
+    // pre[i] = a[0] a[1] ... a[i - 1], lane by lane
+    modint8 prod = one;
+    for (ssize_t i = 0; i < nb; i++) {
+        pre[i] = prod;
+        prod *= load(i);
+    }
+    // 1 / prod[j] = (prod[0] ... prod[j - 1]) (prod[j + 1] ... prod[7])
+    //               / (prod[0] ... prod[7])
+    const modint total = modint(internal::lane_prefix_product(prod).val()[7]);
+    modint8 inv = internal::lane_prefix_product(blend<0b00000001>(
+                      prod.rotate(7), one)) *
+                  internal::lane_suffix_product(blend<0b10000000>(
+                      prod.rotate(1), one)) *
+                  modint8::set1(total.inv());
+    for (ssize_t i = nb - 1; i >= 0; i--) {
+        const auto x = load(i);
+        store(i, inv * pre[i]);
+        inv *= x;
+    }
+}
+
+}  // namespace internal
+
+// a[i] <- 1 / a[i], all a[i] must be invertible
+//
+// Montgomery's trick on 8 lanes: lane j takes the prefix products of
+// a[j], a[j + 8], ..., so a block costs three ModInt8 multiplications and
+// there is one scalar inversion in total.
+template <u32 MOD> void batch_inv(std::span<ModInt<MOD>> a) {
+    internal::batch_inv<ModInt8<MOD>>(a);
+}
+template <int id> void batch_inv(std::span<DynModInt<id>> a) {
+    internal::batch_inv<DynModInt8<id>>(a);
+}
+
+}  // namespace fastfps
@@ -0,0 +1,238 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <span>
+#include <vector>
+
+#include "fastfps/modint8.hpp"
+#include "fastfps/modvec.hpp"
+
+namespace fastfps {
+
+// Transforms over the index bits. a[i] holds the coefficients 8i, ..., 8i+7,
+// so bits 0..2 are in-lane stages (permutevar / blend as in fft_single) and
+// the other bits are vertical butterflies between blocks.
+
+// x[i] <- x[i ^ (1 << K)]
+template <int K, class modint8> modint8 flip_lanes(const modint8& x) {
+    std::array<u32, 8> idx;
+    for (u32 i = 0; i < 8; i++) idx[i] = i ^ (1u << K);
+    return x.permutevar(idx);
+}
+// lanes with bit K set
+template <int K> constexpr uint8_t BIT_LANES = K == 0   ? 0b10101010
+                                              : K == 1 ? 0b11001100
+                                                       : 0b11110000;
+
+// l <- l + r, r <- l - r for each pair (l, r) of indices i, i | bit
+template <class modint8> void hadamard(std::span<modint8> a) {
+    auto stage = []<int K>(modint8 x) {
+        return blend<BIT_LANES<K>>(x, -x) + flip_lanes<K>(x);
+    };
+    for (auto& x : a) {
+        x = stage.template operator()<0>(x);
+        x = stage.template operator()<1>(x);
+        x = stage.template operator()<2>(x);
+    }
+    const ssize_t n = std::ssize(a);
+    for (ssize_t len = 1; len < n; len *= 2) {
+        for (ssize_t start = 0; start < n; start += 2 * len) {
+            for (ssize_t i = start; i < start + len; i++) {
+                auto l = a[i], r = a[i + len];
+                a[i] = l + r;
+                a[i + len] = l - r;
+            }
+        }
+    }
+}
+
+// a[S] <- sum_{T subset of S} a[T] (INV: Mobius transform)
+template <bool INV = false, class modint8>
+void subset_zeta(std::span<modint8> a) {
+    auto stage = []<int K>(modint8 x) {
+        auto y = blend<BIT_LANES<K>>(modint8(), flip_lanes<K>(x));
+        return INV ? x - y : x + y;
+    };
+    for (auto& x : a) {
+        x = stage.template operator()<0>(x);
+        x = stage.template operator()<1>(x);
+        x = stage.template operator()<2>(x);
+    }
+    const ssize_t n = std::ssize(a);
+    for (ssize_t len = 1; len < n; len *= 2) {
+        for (ssize_t start = 0; start < n; start += 2 * len) {
+            for (ssize_t i = start; i < start + len; i++) {
+                if (INV) {
+                    a[i + len] -= a[i];
+                } else {
+                    a[i + len] += a[i];
+                }
+            }
+        }
+    }
+}
+
+// a[S] <- sum_{T superset of S} a[T] (INV: Mobius transform)
+template <bool INV = false, class modint8>
+void superset_zeta(std::span<modint8> a) {
+    auto stage = []<int K>(modint8 x) {
+        auto y = blend<BIT_LANES<K>>(flip_lanes<K>(x), modint8());
+        return INV ? x - y : x + y;
+    };
+    for (auto& x : a) {
+        x = stage.template operator()<0>(x);
+        x = stage.template operator()<1>(x);
+        x = stage.template operator()<2>(x);
+    }
+    const ssize_t n = std::ssize(a);
+    for (ssize_t len = 1; len < n; len *= 2) {
+        for (ssize_t start = 0; start < n; start += 2 * len) {
+            for (ssize_t i = start; i < start + len; i++) {
+                if (INV) {
+                    a[i] -= a[i + len];
+                } else {
+                    a[i] += a[i + len];
+                }
+            }
+        }
+    }
+}
+
+// c = sum a[i] b[j] x^op(i, j) with op = XOR / AND / OR; |a| = |b| = 2^k
+// transform(fa), transform(fb), fa *= fb, inverse(fa)
+template <class modint8, class F, class G>
+BasicModVec<modint8> bitwise_convolution(const BasicModVec<modint8>& a,
+                                         const BasicModVec<modint8>& b,
+                                         F transform,
+                                         G inverse) {
+    assert(a.size() == b.size() && std::has_single_bit(a.size()));
+    const ssize_t n = a.size();
+    // if n < 8, the lanes >= n stay 0 since op(i, j) < n for i, j < n
+    const ssize_t m = std::max<ssize_t>(1, n / 8);
+    std::vector<modint8> fa(m), fb(m);
+    std::ranges::copy(a.blocks(), fa.begin());
+    std::ranges::copy(b.blocks(), fb.begin());
+    transform(std::span<modint8>(fa));
+    transform(std::span<modint8>(fb));
+    for (ssize_t i = 0; i < m; i++) {
+        fa[i] *= fb[i];
+    }
+    inverse(std::span<modint8>(fa));
+
+    BasicModVec<modint8> c(n);
+    std::ranges::copy(fa, c.blocks().begin());
+    return c;
+}
+
+template <class modint8>
+BasicModVec<modint8> xor_convolution(const BasicModVec<modint8>& a,
+                                     const BasicModVec<modint8>& b) {
+    using modint = typename modint8::modint;
+    auto c = bitwise_convolution(a, b, hadamard<modint8>, hadamard<modint8>);
+    const ssize_t m = 8 * std::max<ssize_t>(1, std::ssize(c.blocks()));
+    const modint8 inv = modint8::set1(modint(m).inv());
+    for (auto& x : c.blocks()) x *= inv;
+    return c;
+}
+
+template <class modint8>
+BasicModVec<modint8> and_convolution(const BasicModVec<modint8>& a,
+                                     const BasicModVec<modint8>& b) {
+    return bitwise_convolution(a, b, superset_zeta<false, modint8>,
+                               superset_zeta<true, modint8>);
+}
+
+template <class modint8>
+BasicModVec<modint8> or_convolution(const BasicModVec<modint8>& a,
+                                    const BasicModVec<modint8>& b) {
+    return bitwise_convolution(a, b, subset_zeta<false, modint8>,
+                               subset_zeta<true, modint8>);
+}
+
+// c[S] = sum_{T subset of S} a[T] b[S \ T]; |a| = |b| = 2^k
+//
+// Ranked zeta transform. The ranks of each block are stored next to each
+// other (f[i * (k + 1) + r]), so the rank-wise product works on a
+// contiguous run and each butterfly of the transform is a unit-stride loop
+// over r.
+template <class modint8>
+BasicModVec<modint8> subset_convolution(const BasicModVec<modint8>& a,
+                                        const BasicModVec<modint8>& b) {
+    assert(a.size() == b.size() && std::has_single_bit(a.size()));
+    const ssize_t n = a.size();
+    const ssize_t m = std::max<ssize_t>(1, n / 8);
+    const int k = std::countr_zero(size_t(8 * m));
+    const int rk = k + 1;
+
+    // lanes j with popcount(j) = r
+    std::array<std::array<u32, 8>, 4> lane_rank{};
+    for (int j = 0; j < 8; j++) lane_rank[std::popcount(u32(j))][j] = 1;
+
+    auto load = [&](const BasicModVec<modint8>& src) {
+        std::vector<modint8> f(m * rk);
+        auto v = src.blocks();
+        for (ssize_t i = 0; i < std::ssize(v); i++) {
+            const int base = std::popcount(size_t(i));
+            for (int r = 0; r < 4; r++) {
+                f[i * rk + base + r] =
+                    blendvar(modint8(), v[i], lane_rank[r]);
+            }
+        }
+        return f;
+    };
+    auto fa = load(a), fb = load(b);
+
+    // zeta transform of each rank
+    auto transform = [&](std::vector<modint8>& f, auto lane, auto vertical) {
+        for (auto& x : f) x = lane(x);
+        for (ssize_t len = 1; len < m; len *= 2) {
+            for (ssize_t start = 0; start < m; start += 2 * len) {
+                for (ssize_t i = start; i < start + len; i++) {
+                    modint8* l = f.data() + i * rk;
+                    modint8* r = f.data() + (i + len) * rk;
+                    for (int t = 0; t < rk; t++) vertical(r[t], l[t]);
+                }
+            }
+        }
+    };
+    auto zeta = [](modint8 x) {
+        subset_zeta(std::span<modint8>(&x, 1));
+        return x;
+    };
+    auto mobius = [](modint8 x) {
+        subset_zeta<true>(std::span<modint8>(&x, 1));
+        return x;
+    };
+    transform(fa, zeta, [](modint8& r, const modint8& l) { r += l; });
+    transform(fb, zeta, [](modint8& r, const modint8& l) { r += l; });
+
+    // rank-wise product: fa[r] <- sum_{s <= r} fa[s] fb[r - s]
+    std::vector<modint8> h(rk);
+    for (ssize_t i = 0; i < m; i++) {
+        const modint8* x = fa.data() + i * rk;
+        const modint8* y = fb.data() + i * rk;
+        for (int r = 0; r < rk; r++) {
+            modint8 sum;
+            for (int s = 0; s <= r; s++) sum += x[s] * y[r - s];
+            h[r] = sum;
+        }
+        std::copy(h.begin(), h.end(), fa.begin() + i * rk);
+    }
+
+    transform(fa, mobius, [](modint8& r, const modint8& l) { r -= l; });
+
+    BasicModVec<modint8> c(n);
+    auto v = c.blocks();
+    for (ssize_t i = 0; i < std::ssize(v); i++) {
+        const int base = std::popcount(size_t(i));
+        for (int r = 0; r < 4; r++) {
+            v[i] = blendvar(v[i], fa[i * rk + base + r], lane_rank[r]);
+        }
+    }
+    return c;
+}
+
+}  // namespace fastfps
@@ -0,0 +1,294 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+#include "fastfps/allocator.hpp"
+#include "fastfps/factorial.hpp"
+#include "fastfps/modvec_view.hpp"
+#include "fastfps/types.hpp"
+
+namespace fastfps {
+
+namespace internal {
+
+// f'
+template <class modvec> modvec derivative(const modvec& f) {
+    using modint8 = typename modvec::modint8;
+    using modint = typename modint8::modint;
+    const ssize_t n = f.size();
+    if (n <= 1) return modvec();
+    modvec d = f.substr(1, n - 1);
+    auto k = modint8(modint(1), modint(2), modint(3), modint(4), modint(5),
+                     modint(6), modint(7), modint(8));
+    const auto step = modint8::set1(8);
+    for (auto& x : d.blocks()) {
+        x *= k;
+        k += step;
+    }
+    return d;
+}
+
+// integral of f with constant term 0
+template <class modvec> modvec integral(const modvec& f) {
+    using modint8 = typename modvec::modint8;
+    const ssize_t n = f.size();
+    const ssize_t nb = (n + 8) / 8;
+    Workspace::Frame frame;
+    auto inv = frame.alloc<modint8>(nb);
+    fill_inverses(inv);
+    // 1 / (i + 1)
+    const BasicModVecView<modint8> inv1(inv, 1, 8 * nb - 1);
+
+    modvec g = f;
+    auto v = g.blocks();
+    for (ssize_t i = 0; i < std::ssize(v); i++) v[i] *= inv1.block(i);
+    g <<= 1;
+    return g;
+}
+
+// log f mod x^m, f[0] = 1
+template <class modvec> modvec log(const modvec& f, ssize_t m) {
+    assert(f.val(0) == 1);
+    if (m <= 1) return modvec(m);
+    modvec d = derivative(f);
+    if (ssize_t(d.size()) > m - 1) d.resize(m - 1);
+    modvec r = d * f.inv(int(m - 1));
+    r.resize(m - 1);
+    return integral(r);
+}
+
+// exp f mod x^m, f[0] = 0
+// Newton iteration e <- e (1 - log e + f)
+template <class modvec> modvec exp(const modvec& f, ssize_t m) {
+    assert(f.val(0) == 0);
+    modvec e({1}), t;
+    const modvec one({1});
+    for (ssize_t len = 1; len < m; len *= 2) {
+        t.resize(0);
+        t.resize(2 * len);
+        f.copy_to(0, std::min<ssize_t>(f.size(), 2 * len), t, 0);
+        t = t - log(e, 2 * len) + one;
+        e *= t;
+        e.resize(2 * len);
+    }
+    e.resize(m);
+    return e;
+}
+
+// Bivariate polynomials A(x, y) = sum a[i][j] x^i y^j are stored in a ModVec
+// as a[i][j] at i * stride + j (stride > the degree in y), so that a
+// product of them is one ModVec product (Kronecker substitution).
+
+// rows first, first + step, ... of src, columns [0, cols), at dst_stride
+template <class modvec>
+modvec gather_rows(const modvec& src,
+                   ssize_t stride,
+                   ssize_t first,
+                   ssize_t step,
+                   ssize_t rows,
+                   ssize_t cols,
+                   ssize_t dst_stride) {
+    modvec dst(rows * dst_stride);
+    const ssize_t n = src.size();
+    for (ssize_t j = 0; j < rows; j++) {
+        const ssize_t start = (first + step * j) * stride;
+        const ssize_t len = std::min({cols, stride, n - start});
+        if (len > 0) src.copy_to(start, len, dst, j * dst_stride);
+    }
+    return dst;
+}
+
+// Graeffe iteration for Q_0(x, y) = 1 - y g(x) mod x^n (g(0) = 0):
+// Q_k(x, y) = E_k(x^2, y) + x O_k(x^2, y),
+// Q_{k+1}(x, y) = Q_k(x, y) Q_k(-x, y) = E_k(x, y)^2 - x O_k(x, y)^2
+// mod x^ceil(n_k / 2), until n_k = 1. The degree in y of Q_k is 2^k,
+// which is capped to m - 1.
+template <class modvec> struct GraeffeLevels {
+    struct Level {
+        // Q_k mod x^n, and the number of its columns
+        ssize_t n, cols;
+        // E_k and O_k with the stride 2 cols - 1
+        ssize_t stride;
+        modvec e, o;
+    };
+    std::vector<Level> levels;
+
+    GraeffeLevels(const modvec& g, ssize_t n, ssize_t m) {
+        using modint = typename modvec::modint;
+        assert(g.val(0) == 0);
+        std::vector<modint> q0(2 * n);
+        q0[0] = 1;
+        for (ssize_t i = 1; i < std::min<ssize_t>(n, g.size()); i++) {
+            q0[2 * i + 1] = modint(0) - modint(g.val(i));
+        }
+        modvec q(q0);
+        ssize_t stride = 2, cols = std::min<ssize_t>(2, m);
+        while (n > 1) {
+            Level l;
+            l.n = n;
+            l.cols = cols;
+            l.stride = 2 * cols - 1;
+            const ssize_t n2 = (n + 1) / 2;
+            l.e = gather_rows(q, stride, 0, 2, n2, cols, l.stride);
+            l.o = gather_rows(q, stride, 1, 2, n / 2, cols, l.stride);
+
+            modvec o2 = l.o * l.o;
+            o2 <<= l.stride;
+            q = l.e * l.e - o2;
+            q.resize(n2 * l.stride);
+            stride = l.stride;
+            cols = std::min(l.stride, m);
+            n = n2;
+            levels.push_back(std::move(l));
+        }
+    }
+};
+
+// a[i] = [x^(n-1)] w(x) g(x)^i for i < m (g(0) = 0, |w| <= n)
+//
+// [x^(n-1)] P(x, y) / Q(x, y) with P(x, y) = w(x), Q(x, y) = 1 - y g(x).
+// Multiplying P and Q by Q(-x, y) makes the denominator even in x, so
+// only the terms of P(x, y) Q(-x, y) of the parity of n - 1 are kept.
+// After log n steps, n = 1 and a(y) = P(0, y) / Q(0, y) = P(0, y).
+// [Kinoshita, Li: Power Series Composition in Near-Linear Time]
+template <class modvec>
+modvec power_projection(const modvec& w,
+                        const modvec& g,
+                        ssize_t n,
+                        ssize_t m) {
+    assert(ssize_t(w.size()) <= n);
+    if (n == 0 || m == 0) return modvec(m);
+    GraeffeLevels<modvec> gl(g, n, m);
+    modvec p = w;
+    p.resize(n);
+    ssize_t stride = 1, cols = 1;
+    for (const auto& l : gl.levels) {
+        // P_k(x, y) = PE(x^2, y) + x PO(x^2, y)
+        // P_k Q_k(-x, y) = (PE E - x^2 PO O) + x (PO E - PE O)
+        const ssize_t n2 = (l.n + 1) / 2;
+        const ssize_t d = cols + l.cols - 1;
+        const auto pe = gather_rows(p, stride, 0, 2, n2, cols, d);
+        const auto po = gather_rows(p, stride, 1, 2, l.n / 2, cols, d);
+        const auto e = gather_rows(l.e, l.stride, 0, 1, n2, l.cols, d);
+        const auto o = gather_rows(l.o, l.stride, 0, 1, l.n / 2, l.cols, d);
+        if ((l.n - 1) % 2 == 0) {
+            modvec t = po * o;
+            t <<= d;
+            p = pe * e - t;
+        } else {
+            p = po * e - pe * o;
+        }
+        p.resize(n2 * d);
+        stride = d;
+        cols = std::min(d, m);
+    }
+    modvec a(m);
+    p.copy_to(0, std::min<ssize_t>(m, p.size()), a, 0);
+    return a;
+}
+
+// f(g(x)) mod x^n, g(0) = 0
+//
+// The transpose of power_projection: f -> (sum_i f[i] [x^j] g^i)_j is the
+// transpose of w -> ([x^(n-1)] w g^i)_i up to reversing w. So the steps of
+// power_projection are run backwards with each product replaced by its
+// transpose (a middle product).
+template <class modvec>
+modvec compose_zero(const modvec& f, const modvec& g, ssize_t n) {
+    using modint = typename modvec::modint;
+    if (n == 0) return modvec();
+    GraeffeLevels<modvec> gl(g, n, n);
+
+    // P_K^T(0, y) = f(y)
+    modvec p(n);
+    f.copy_to(0, std::min<ssize_t>(n, f.size()), p, 0);
+    ssize_t stride = n, cols = n;
+    for (ssize_t k = std::ssize(gl.levels) - 1; k >= 0; k--) {
+        const auto& l = gl.levels[k];
+        // P_k^T[a] = sum_c P_{k+1}^T[(a + c - r) / 2] * Q_k(-x, y)[c]
+        // (* is the correlation in y, r = (n_k - 1) % 2)
+        const ssize_t n2 = (l.n + 1) / 2, r = (l.n - 1) % 2;
+        const ssize_t cols_k = std::min<ssize_t>(ssize_t(1) << k, n);
+        const ssize_t d = cols_k + l.cols - 1;
+        const auto pt = gather_rows(p, stride, 0, 1, n2, std::min(cols, d), d);
+        auto e = gather_rows(l.e, l.stride, 0, 1, n2, l.cols, d);
+        auto o = gather_rows(l.o, l.stride, 0, 1, l.n / 2, l.cols, d);
+        const ssize_t le = e.size(), lo = o.size();
+        e.reverse();
+        o.reverse();
+        // middle products: u[i] = sum_c pt[i + c] * e[c]
+        const modvec u = pt * e;
+        modvec v = pt * o;
+        v *= modint(-1);
+
+        modvec next(l.n * cols_k);
+        for (ssize_t a = 0; a < l.n; a++) {
+            if ((a - r) % 2 == 0) {
+                u.copy_to((a - r) / 2 * d + le - 1, cols_k, next, a * cols_k);
+            } else {
+                v.copy_to((a + 1 - r) / 2 * d + lo - 1, cols_k, next,
+                          a * cols_k);
+            }
+        }
+        p = std::move(next);
+        stride = cols = cols_k;
+    }
+    // P_0^T(x, 0) is f(g) reversed
+    p.resize(n);
+    p.reverse();
+    return p;
+}
+
+// f(g(x)) mod x^n
+// f(g) = f(c + (g - c)) = (f(x + c))(g - c) with c = g(0)
+template <class modvec>
+modvec compose(const modvec& f, const modvec& g, ssize_t n) {
+    using modint = typename modvec::modint;
+    const modint c = modint(g.val(0));
+    if (c == modint(0)) return compose_zero(f, g, n);
+    modvec g0 = g;
+    g0 -= modvec({c.val()});
+    return compose_zero(f.taylor_shift(c), g0, n);
+}
+
+// g mod x^n with f(g(x)) = x, f(0) = 0, f'(0) != 0
+//
+// By the Lagrange inversion,
+//   (n - 1) [x^(n-1)] f^i = i [x^(n-1-i)] (x / g)^(n-1)  (0 < i < n).
+// So a power projection gives (x / g)^(n-1) mod x^(n-1), and x / g is its
+// (n-1)-th root.
+template <class modvec>
+modvec compositional_inverse(const modvec& f, ssize_t n) {
+    using modint = typename modvec::modint;
+    assert(f.val(0) == 0);
+    if (n <= 1) return modvec(n);
+    assert(f.val(1) != 0);
+    const modint f1 = modint(f.val(1));
+    if (n == 2) return modvec({u32(0), f1.inv().val()});
+    modvec f0 = f;
+    if (ssize_t(f0.size()) > n) f0.resize(n);
+    const auto p = power_projection(modvec({1}), f0, n, n).val();
+
+    // h = (x / g)^(n-1) / f1^(n-1)
+    std::vector<modint> h(n - 1);
+    const modint k = modint(int(n - 1));
+    for (ssize_t i = 1; i < n; i++) {
+        h[n - 1 - i] = modint(p[i]) * k * modint(int(i)).inv();
+    }
+    const modint h0 = h[0].inv();
+    for (auto& x : h) x *= h0;
+
+    modvec lh = log(modvec(h), n - 1);
+    lh *= k.inv();
+    const modvec e = exp(lh, n - 1);
+    modvec g = e.inv(int(n - 1));
+    g *= f1.inv();
+    g <<= 1;
+    return g;
+}
+
+}  // namespace internal
+
+}  // namespace fastfps
@@ -0,0 +1,151 @@
+#pragma once
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include <array>
+#include <cassert>
+#include <concepts>
+#include <iostream>
+
+#include "fastfps/math.hpp"
+#include "fastfps/modint.hpp"
+#include "fastfps/types.hpp"
+
+namespace fastfps {
+
+// Montgomery constants of a modulus chosen at runtime
+struct DynModContext {
+    u32 MOD;
+    u32 INV;  // -MOD^-1 (mod 2^32)
+    u32 B2;   // 2^64 % MOD
+    std::array<u32, 65> INV_BINARY;  // inv_binary_table(MOD)
+
+#ifdef __AVX2__
+    __m256i MOD_X;
+    __m256i MOD2_X;
+    __m256i N_INV_X;
+    __m256i B2_X;
+#endif
+
+    constexpr explicit DynModContext(u32 mod)
+        : MOD(mod),
+          INV(-inv_u32(mod)),
+          B2(pow_mod_constexpr(2, 64, mod)),
+          INV_BINARY(inv_binary_table(mod))
+#ifdef __AVX2__
+          ,
+          MOD_X(set1(MOD)),
+          MOD2_X(set1(2 * MOD)),
+          N_INV_X(set1(INV)),
+          B2_X(set1(B2))
+#endif
+    {
+        assert(mod % 2 && mod <= (1U << 30) - 1);
+    }
+
+  private:
+#ifdef __AVX2__
+    static constexpr __m256i set1(u32 x) {
+        const long long y = (long long)(u64(x) << 32 | x);
+        return __m256i{y, y, y, y};
+    }
+#endif
+};
+
+// ModInt whose modulus is set at runtime by set_mod.
+// Each id (and each thread) has its own modulus, 998244353 by default.
+template <int id> struct DynModInt {
+    static u32 mod() { return ctx.MOD; }
+    static void set_mod(u32 m) {
+        assert(m % 2 && m <= (1U << 30) - 1);
+        if (ctx.MOD != m) ctx = DynModContext(m);
+    }
+    static const DynModContext& context() { return ctx; }
+
+    DynModInt() : x(0) {}
+    explicit DynModInt(u32 _x) : x(mulreduce(_x, ctx.B2)) {}
+
+    DynModInt(std::signed_integral auto _x)
+        : DynModInt((u32)(_x % (i32)mod() + mod())) {}
+    DynModInt(std::unsigned_integral auto _x) : DynModInt((u32)(_x % mod())) {}
+
+    u32 val() const {
+        u32 y = mulreduce(x, 1);
+        return y < mod() ? y : y - mod();
+    }
+    u32 internal_val() const { return x; }
+
+    DynModInt& operator+=(const DynModInt& rhs) {
+        x += rhs.x;
+        x = std::min(x, x - 2 * mod());
+        return *this;
+    }
+    friend DynModInt operator+(const DynModInt& lhs, const DynModInt& rhs) {
+        return DynModInt(lhs) += rhs;
+    }
+
+    DynModInt& operator-=(const DynModInt& rhs) {
+        x += 2 * mod() - rhs.x;
+        x = std::min(x, x - 2 * mod());
+        return *this;
+    }
+    friend DynModInt operator-(const DynModInt& lhs, const DynModInt& rhs) {
+        return DynModInt(lhs) -= rhs;
+    }
+
+    DynModInt& operator*=(const DynModInt& rhs) {
+        x = mulreduce(x, rhs.x);
+        return *this;
+    }
+    friend DynModInt operator*(const DynModInt& lhs, const DynModInt& rhs) {
+        return DynModInt(lhs) *= rhs;
+    }
+
+    friend bool operator==(const DynModInt& lhs, const DynModInt& rhs) {
+        auto lx = lhs.x;
+        if (lx >= mod()) lx -= mod();
+        auto rx = rhs.x;
+        if (rx >= mod()) rx -= mod();
+        return lx == rx;
+    }
+
+    DynModInt pow(u64 n) const {
+        DynModInt v = *this, r = 1;
+        while (n) {
+            if (n & 1) r *= v;
+            v *= v;
+            n >>= 1;
+        }
+        return r;
+    }
+    // x must be coprime to mod() (which may be composite), see ModInt::inv
+    DynModInt inv() const {
+        const auto [y, k] = inv_binary(x < mod() ? x : x - mod(), mod());
+        DynModInt r;
+        r.x = mulreduce(y, ctx.INV_BINARY[k]);
+        return r;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const DynModInt& v) {
+        return os << v.val();
+    }
+
+  private:
+    u32 x;
+
+    static inline thread_local DynModContext ctx = DynModContext(998244353);
+
+    // Input: (l * r) must be no more than (2^32 * MOD)
+    // Output: ((l * r) / 2^32) % MOD
+    static u32 mulreduce(u32 l, u32 r) {
+        u64 x = u64(1) * l * r;
+        x += u64(u32(x) * ctx.INV) * ctx.MOD;
+        return u32(x >> 32);
+    }
+};
+
+template <int id> struct is_modint<DynModInt<id>> : std::true_type {};
+
+}  // namespace fastfps
@@ -0,0 +1,428 @@
+#pragma once
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <span>
+
+#include "fastfps/dynmodint.hpp"
+#include "fastfps/modint8.hpp"
+#include "fastfps/types.hpp"
+
+namespace fastfps {
+
+#ifdef __AVX2__
+
+// ModInt8 over the runtime modulus of DynModInt<id>
+template <int id> struct DynModInt8 {
+    using modint = DynModInt<id>;
+    using m256i_u = __m256i_u;
+
+    static u32 mod() { return modint::mod(); }
+
+    DynModInt8() : x(_mm256_setzero_si256()) {}
+    DynModInt8(std::span<const i32, 8> _x)
+        : x(mul(_mm256_sub_epi32(_mm256_loadu_si256((m256i_u*)_x.data()),
+                                 _mm256_set1_epi32(INT32_MIN)),
+                ctx().B2_X)) {
+        *this -= set1(modint(u32(1) << 31));
+    }
+    DynModInt8(std::span<const u32, 8> _x)
+        : x(mul(_mm256_loadu_si256((m256i_u*)_x.data()), ctx().B2_X)) {}
+    DynModInt8(std::span<const modint, 8> _x)
+        : x(_mm256_loadu_si256((m256i_u*)_x.data())) {
+        static_assert(sizeof(modint) == 4);
+    }
+    explicit DynModInt8(modint x0,
+                        modint x1,
+                        modint x2,
+                        modint x3,
+                        modint x4,
+                        modint x5,
+                        modint x6,
+                        modint x7)
+        : x(_mm256_set_epi32(x7.internal_val(),
+                             x6.internal_val(),
+                             x5.internal_val(),
+                             x4.internal_val(),
+                             x3.internal_val(),
+                             x2.internal_val(),
+                             x1.internal_val(),
+                             x0.internal_val())) {}
+
+    static DynModInt8 set1(modint x) {
+        DynModInt8 v;
+        v.x = _mm256_set1_epi32(x.internal_val());
+        return v;
+    }
+
+    // a[i] = base[idx[i]]
+    static DynModInt8 gather(std::span<const modint> base,
+                          std::span<const u32, 8> idx) {
+        DynModInt8 v;
+        v.x = _mm256_i32gather_epi32(
+            (const int*)base.data(),
+            _mm256_loadu_si256((const m256i_u*)idx.data()), 4);
+        return v;
+    }
+
+    std::array<u32, 8> val() const {
+        auto a = mul(x, _mm256_set1_epi32(1));
+        alignas(32) std::array<u32, 8> b;
+        _mm256_storeu_si256((__m256i_u*)b.data(),
+                            min(a, _mm256_sub_epi32(a, ctx().MOD_X)));
+        return b;
+    }
+
+    // dst = this, as ModInt (the inverse of the span<const modint> ctor)
+    void store(std::span<modint, 8> dst) const {
+        _mm256_storeu_si256((m256i_u*)dst.data(), x);
+    }
+    // *dst = *this by a non-temporal store, which bypasses the caches.
+    // dst must be 32-byte aligned, see also stream_fence().
+    void stream(DynModInt8* dst) const {
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dst), x);
+    }
+
+    // the same values with the internal lanes in [0, MOD)
+    DynModInt8 normalized() const {
+        DynModInt8 v;
+        v.x = min(x, _mm256_sub_epi32(x, ctx().MOD_X));
+        return v;
+    }
+
+    // Sum of up to TERMS products l r with a scalar l, accumulated in 64-bit
+    // lanes and Montgomery-reduced once by get(). l and the lanes of r must
+    // be normalized: then the sum is below 8 MOD^2 and the reduction
+    // (+ 2^32 MOD at most) stays below 2^64 as unsigned lanes (but not below
+    // 2^63, so the lanes are added by _mm256_add_epi64, not by signed +).
+    struct LazySum {
+        static constexpr int TERMS = 8;
+
+        void add(modint l, const DynModInt8& r) {
+            const auto lx = _mm256_set1_epi32(l.internal_val());
+            even = _mm256_add_epi64(even, mul_even(lx, r.x));
+            odd = _mm256_add_epi64(
+                odd, mul_even(lx, _mm256_shuffle_epi32(r.x, 0xf5)));
+        }
+        // < 8 MOD^2 / 2^32 + MOD < 3 MOD, then < 2 MOD
+        DynModInt8 get() const {
+            DynModInt8 v;
+            v.x = _mm256_blend_epi32(_mm256_srli_epi64(reduce(even), 32),
+                                     reduce(odd), 0b10101010);
+            v.x = min(v.x, _mm256_sub_epi32(v.x, ctx().MOD2_X));
+            return v;
+        }
+
+      private:
+        m256i_u even = _mm256_setzero_si256(), odd = _mm256_setzero_si256();
+
+        // t + (t N mod 2^32) MOD, whose high halves are t / 2^32 (mod MOD)
+        static m256i_u reduce(const m256i_u& t) {
+            return _mm256_add_epi64(
+                t, mul_even(mul_even(t, ctx().N_INV_X), ctx().MOD_X));
+        }
+    };
+
+    DynModInt8& operator+=(const DynModInt8& rhs) {
+        x = _mm256_add_epi32(x, rhs.x);
+        x = min(x, _mm256_sub_epi32(x, ctx().MOD2_X));
+        return *this;
+    }
+    friend DynModInt8 operator+(const DynModInt8& lhs, const DynModInt8& rhs) {
+        return DynModInt8(lhs) += rhs;
+    }
+
+    DynModInt8& operator-=(const DynModInt8& rhs) {
+        x = _mm256_sub_epi32(x, rhs.x);
+        x = min(x, _mm256_add_epi32(x, ctx().MOD2_X));
+        return *this;
+    }
+    friend DynModInt8 operator-(const DynModInt8& lhs, const DynModInt8& rhs) {
+        return DynModInt8(lhs) -= rhs;
+    }
+
+    DynModInt8& operator*=(const DynModInt8& rhs) {
+        x = mul(x, rhs.x);
+        return *this;
+    }
+    friend DynModInt8 operator*(const DynModInt8& lhs, const DynModInt8& rhs) {
+        return DynModInt8(lhs) *= rhs;
+    }
+
+    DynModInt8 operator-() const { return DynModInt8() - *this; }
+
+    friend bool operator==(const DynModInt8& lhs, const DynModInt8& rhs) {
+        auto lx = lhs.x, rx = rhs.x;
+        lx = min(lx, _mm256_sub_epi32(lx, ctx().MOD_X));
+        rx = min(rx, _mm256_sub_epi32(rx, ctx().MOD_X));
+        auto z = _mm256_xor_si256(lx, rx);
+        return _mm256_testz_si256(z, z);
+    }
+
+    // a.permutevar(idx)[i] = a[idx[i] % 8]
+    DynModInt8 permutevar(const std::array<u32, 8>& idx) const {
+        return permutevar(_mm256_loadu_si256((m256i_u*)idx.data()));
+    }
+
+    // a[i] <- a[(middle + i) % 8]
+    DynModInt8 rotate(u32 middle) const {
+        const m256i_u base = _mm256_set_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+        return permutevar(_mm256_add_epi32(base, _mm256_set1_epi32(middle)));
+    }
+
+    template <uint8_t MASK>
+    friend DynModInt8 blend(const DynModInt8& lhs, const DynModInt8& rhs) {
+        DynModInt8 v;
+        v.x = _mm256_blend_epi32(lhs.x, rhs.x, MASK);
+        return v;
+    }
+
+    friend DynModInt8 blendvar(const DynModInt8& lhs,
+                               const DynModInt8& rhs,
+                               const std::array<u32, 8>& idx) {
+        DynModInt8 v;
+        v.x = _mm256_blendv_epi8(
+            rhs.x, lhs.x,
+            _mm256_cmpeq_epi32(_mm256_loadu_si256((m256i_u*)idx.data()),
+                               _mm256_setzero_si256()));
+        return v;
+    }
+
+    // a[i] <- (a[0][i], a[1][i], ..., a[7][i])
+    static void transpose(std::array<DynModInt8, 8>& a) {
+        m256i_u t[8], u[8];
+        for (int i = 0; i < 4; i++) {
+            t[2 * i] = _mm256_unpacklo_epi32(a[2 * i].x, a[2 * i + 1].x);
+            t[2 * i + 1] = _mm256_unpackhi_epi32(a[2 * i].x, a[2 * i + 1].x);
+        }
+        for (int i = 0; i < 2; i++) {
+            u[4 * i + 0] = _mm256_unpacklo_epi64(t[4 * i], t[4 * i + 2]);
+            u[4 * i + 1] = _mm256_unpackhi_epi64(t[4 * i], t[4 * i + 2]);
+            u[4 * i + 2] = _mm256_unpacklo_epi64(t[4 * i + 1], t[4 * i + 3]);
+            u[4 * i + 3] = _mm256_unpackhi_epi64(t[4 * i + 1], t[4 * i + 3]);
+        }
+        for (int i = 0; i < 4; i++) {
+            a[i].x = _mm256_permute2x128_si256(u[i], u[i + 4], 0x20);
+            a[i + 4].x = _mm256_permute2x128_si256(u[i], u[i + 4], 0x31);
+        }
+    }
+
+  private:
+    m256i_u x;
+
+    static const DynModContext& ctx() { return modint::context(); }
+
+    // Input: l * r <= 2^32 * MOD
+    // Output: l * r >>= 2^32
+    static m256i_u mul(const m256i_u& l, const m256i_u& r) {
+        const DynModContext& c = ctx();
+        auto x0 = mul_even(l, r);
+        auto x1 = mul_even(_mm256_shuffle_epi32(l, 0xf5),
+                           _mm256_shuffle_epi32(r, 0xf5));
+        x0 += mul_even(mul_even(x0, c.N_INV_X), c.MOD_X);
+        x1 += mul_even(mul_even(x1, c.N_INV_X), c.MOD_X);
+
+        x0 = _mm256_srli_epi64(x0, 32);
+        return _mm256_blend_epi32(x0, x1, 0b10101010);
+    }
+    // (lr[0], lr[2], lr[4], lr[6])
+    static m256i_u mul_even(const m256i_u& l, const m256i_u& r) {
+        return _mm256_mul_epu32(l, r);
+    }
+
+    static m256i_u min(const m256i_u& l, const m256i_u& r) {
+        return _mm256_min_epu32(l, r);
+    }
+
+    // a.permutevar(idx)[i] = a[idx[i] % 8]
+    DynModInt8 permutevar(const m256i_u& idx) const {
+        DynModInt8 v;
+        v.x = _mm256_permutevar8x32_epi32(x, idx);
+        return v;
+    }
+};
+
+#else
+
+template <int id> struct DynModInt8 {
+    using modint = DynModInt<id>;
+
+    static u32 mod() { return modint::mod(); }
+
+    DynModInt8() : x({}) {}
+    DynModInt8(std::span<const i32, 8> _x) {
+        for (int i = 0; i < 8; i++) {
+            x[i] = _x[i];
+        }
+    }
+    DynModInt8(std::span<const u32, 8> _x) {
+        for (int i = 0; i < 8; i++) {
+            x[i] = _x[i];
+        }
+    }
+    DynModInt8(std::span<const modint, 8> _x) {
+        for (int i = 0; i < 8; i++) {
+            x[i] = _x[i];
+        }
+    }
+    explicit DynModInt8(modint x0,
+                        modint x1,
+                        modint x2,
+                        modint x3,
+                        modint x4,
+                        modint x5,
+                        modint x6,
+                        modint x7)
+        : x({x0, x1, x2, x3, x4, x5, x6, x7}) {}
+
+    static DynModInt8 set1(modint x) {
+        return DynModInt8(x, x, x, x, x, x, x, x);
+    }
+
+    // a[i] = base[idx[i]]
+    static DynModInt8 gather(std::span<const modint> base,
+                          std::span<const u32, 8> idx) {
+        DynModInt8 v;
+        for (int i = 0; i < 8; i++) {
+            v.x[i] = base[idx[i]];
+        }
+        return v;
+    }
+
+    std::array<u32, 8> val() const {
+        std::array<u32, 8> b;
+        for (int i = 0; i < 8; i++) {
+            b[i] = x[i].val();
+        }
+        return b;
+    }
+
+    // dst = this, as ModInt (the inverse of the span<const modint> ctor)
+    void store(std::span<modint, 8> dst) const {
+        std::ranges::copy(x, dst.begin());
+    }
+    // *dst = *this (a non-temporal store with AVX2)
+    void stream(DynModInt8* dst) const { *dst = *this; }
+
+    // the same values (the internal lanes are only normalized with AVX2)
+    DynModInt8 normalized() const { return *this; }
+
+    // Sum of up to TERMS products l r with a scalar l (see the AVX2 version)
+    struct LazySum {
+        static constexpr int TERMS = 8;
+
+        void add(modint l, const DynModInt8& r) {
+            for (int i = 0; i < 8; i++) {
+                s[i] += l * r.x[i];
+            }
+        }
+        DynModInt8 get() const {
+            return DynModInt8(std::span<const modint, 8>(s));
+        }
+
+      private:
+        std::array<modint, 8> s{};
+    };
+
+    DynModInt8& operator+=(const DynModInt8& rhs) {
+        for (int i = 0; i < 8; i++) {
+            x[i] += rhs.x[i];
+        }
+        return *this;
+    }
+    friend DynModInt8 operator+(const DynModInt8& lhs, const DynModInt8& rhs) {
+        return DynModInt8(lhs) += rhs;
+    }
+
+    DynModInt8& operator-=(const DynModInt8& rhs) {
+        for (int i = 0; i < 8; i++) {
+            x[i] -= rhs.x[i];
+        }
+        return *this;
+    }
+    friend DynModInt8 operator-(const DynModInt8& lhs, const DynModInt8& rhs) {
+        return DynModInt8(lhs) -= rhs;
+    }
+
+    DynModInt8& operator*=(const DynModInt8& rhs) {
+        for (int i = 0; i < 8; i++) {
+            x[i] *= rhs.x[i];
+        }
+        return *this;
+    }
+    friend DynModInt8 operator*(const DynModInt8& lhs, const DynModInt8& rhs) {
+        return DynModInt8(lhs) *= rhs;
+    }
+
+    DynModInt8 operator-() const { return DynModInt8() - *this; }
+
+    friend bool operator==(const DynModInt8& lhs, const DynModInt8& rhs) {
+        return lhs.x == rhs.x;
+    }
+
+    // a.permutevar(idx)[i] = a[idx[i] % 8]
+    DynModInt8 permutevar(const std::array<u32, 8>& idx) const {
+        DynModInt8 v;
+        for (int i = 0; i < 8; i++) {
+            v.x[i] = x[idx[i] % 8];
+        }
+        return v;
+    }
+
+    // a[i] <- a[(middle + i) % 8]
+    DynModInt8 rotate(u32 middle) const {
+        DynModInt8 v(*this);
+        std::rotate(v.x.begin(), v.x.begin() + middle, v.x.end());
+        return v;
+    }
+
+    template <uint8_t MASK>
+    friend DynModInt8 blend(const DynModInt8& lhs, const DynModInt8& rhs) {
+        DynModInt8 v;
+        for (int i = 0; i < 8; i++) {
+            if (MASK & (1u << i)) {
+                v.x[i] = rhs.x[i];
+            } else {
+                v.x[i] = lhs.x[i];
+            }
+        }
+        return v;
+    }
+
+    friend DynModInt8 blendvar(const DynModInt8& lhs,
+                               const DynModInt8& rhs,
+                               const std::array<u32, 8>& idx) {
+        DynModInt8 v;
+        for (int i = 0; i < 8; i++) {
+            if (idx[i]) {
+                v.x[i] = rhs.x[i];
+            } else {
+                v.x[i] = lhs.x[i];
+            }
+        }
+        return v;
+    }
+
+    // a[i] <- (a[0][i], a[1][i], ..., a[7][i])
+    static void transpose(std::array<DynModInt8, 8>& a) {
+        for (int i = 0; i < 8; i++) {
+            for (int j = 0; j < i; j++) {
+                std::swap(a[i].x[j], a[j].x[i]);
+            }
+        }
+    }
+
+  private:
+    std::array<modint, 8> x;
+};
+
+#endif
+
+template <int id> struct is_modint8<DynModInt8<id>> : std::true_type {};
+
+}  // namespace fastfps
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <span>
+
+#include "fastfps/allocator.hpp"
+#include "fastfps/types.hpp"
+
+namespace fastfps {
+
+namespace internal {
+
+// prefix products of the lanes: x[i] <- x[0] x[1] ... x[i]
+template <class modint8> modint8 lane_prefix_product(modint8 x) {
+    const auto one = modint8::set1(1);
+    // x[i - s], 1 for i < s
+    x *= blend<0b00000001>(x.rotate(7), one);
+    x *= blend<0b00000011>(x.rotate(6), one);
+    x *= blend<0b00001111>(x.rotate(4), one);
+    return x;
+}
+
+// suffix products of the lanes: x[i] <- x[i] x[i + 1] ... x[7]
+template <class modint8> modint8 lane_suffix_product(modint8 x) {
+    const auto one = modint8::set1(1);
+    // x[i + s], 1 for i + s >= 8
+    x *= blend<0b10000000>(x.rotate(1), one);
+    x *= blend<0b11000000>(x.rotate(2), one);
+    x *= blend<0b11110000>(x.rotate(4), one);
+    return x;
+}
+
+template <class modint8> modint8 broadcast_lane(const modint8& x, u32 i) {
+    return x.permutevar({i, i, i, i, i, i, i, i});
+}
+
+}  // namespace internal
+
+// fact[i][j] = (8i + j)!, inv_fact[i][j] = 1 / (8i + j)!
+//
+// A block of fact is the prefix products of 8 consecutive integers times
+// the last factorial of the previous block, so there is one multiplication
+// on the critical path per block. inv_fact is the same with suffix
+// products from 1 / (8m)!, which is the only inversion.
+template <class modint8>
+void fill_factorials(std::span<modint8> fact, std::span<modint8> inv_fact) {
+    using modint = typename modint8::modint;
+    const ssize_t m = std::ssize(fact);
+    assert(std::ssize(inv_fact) == m);
+    assert(u64(8) * u64(m) < modint8::mod());
+    if (m == 0) return;
+    const auto one = modint8::set1(1), step = modint8::set1(8);
+    // 8i, ..., 8i + 7
+    auto k = modint8(modint(0), modint(1), modint(2), modint(3), modint(4),
+                     modint(5), modint(6), modint(7));
+    auto carry = one;
+    for (ssize_t i = 0; i < m; i++) {
+        // 0! = 1
+        fact[i] = internal::lane_prefix_product(i ? k : blend<1>(k, one)) *
+                  carry;
+        carry = internal::broadcast_lane(fact[i], 7);
+        k += step;
+    }
+
+    // k = 8m, ..., 8m + 7
+    carry *= k;
+    carry = modint8::set1(modint(carry.val()[0]).inv());
+    k -= step;
+    for (ssize_t i = m - 1; i >= 0; i--) {
+        // 8i + 1, ..., 8i + 8
+        inv_fact[i] = internal::lane_suffix_product(k + one) * carry;
+        carry = internal::broadcast_lane(inv_fact[i], 0);
+        k -= step;
+    }
+}
+
+// inv[i][j] = 1 / (8i + j), inv[0][0] = 0
+// 1 / k = (k - 1)! / k!, with fill_factorials.
+template <class modint8> void fill_inverses(std::span<modint8> inv) {
+    const ssize_t m = std::ssize(inv);
+    if (m == 0) return;
+    Workspace::Frame frame;
+    auto fact = frame.alloc<modint8>(m);
+    auto inv_fact = frame.alloc<modint8>(m);
+    fill_factorials(fact, inv_fact);
+    // (k - 1)!: lane 0 is lane 7 of the previous block
+    modint8 prev;
+    for (ssize_t i = 0; i < m; i++) {
+        const auto x = fact[i].rotate(7);
+        inv[i] = blend<0b00000001>(x, prev) * inv_fact[i];
+        prev = x;
+    }
+}
+
+}  // namespace fastfps
@@ -2,13 +2,20 @@
 
 #include <array>
 #include <bit>
+#include <cassert>
 #include <concepts>
+#include <cstdint>
+#include <map>
+#include <memory>
 #include <ranges>
 #include <vector>
 
+#include "fastfps/dynmodint.hpp"
+#include "fastfps/dynmodint8.hpp"
 #include "fastfps/math.hpp"
 #include "fastfps/modint.hpp"
 #include "fastfps/modint8.hpp"
+#include "fastfps/stats.hpp"
 #include "fastfps/types.hpp"
 
 namespace fastfps {
@@ -84,8 +91,10 @@ template <u32 MOD> struct FFTInfo {
         }
         return v;
     }();
-    std::array<modint8, ord2 + 1> rot16i = []() {
-        std::array<modint8, std::max(0, ord2 + 1)> v;
+    // one more entry: fft reads (and does not use) rot_shift16i of the last
+    // block, which is index ord2 + 1 for the largest transform
+    std::array<modint8, ord2 + 2> rot16i = []() {
+        std::array<modint8, std::max(0, ord2 + 2)> v;
         for (int i = 4; i <= ord2; i++) {
             std::array<modint, 8> buf;
             buf[0] = 1;
@@ -96,8 +105,8 @@ template <u32 MOD> struct FFTInfo {
         }
         return v;
     }();
-    std::array<modint8, ord2 + 1> irot16i = []() {
-        std::array<modint8, std::max(0, ord2 + 1)> v;
+    std::array<modint8, ord2 + 2> irot16i = []() {
+        std::array<modint8, std::max(0, ord2 + 2)> v;
         for (int i = 4; i <= ord2; i++) {
             std::array<modint, 8> buf;
             buf[0] = 1;
@@ -115,66 +124,226 @@ template <u32 MOD> struct FFTInfo {
     modint8 irot_shift16i(u32 i) const {
         return irot16i[std::countr_one(i >> 4) + 4];
     }
+
+    // twiddles of the in-lane stages (fft_single / ifft_single)
+    modint8 step4 = modint8(1, 1, 1, w[2], 1, 1, 1, w[2]);
+    modint8 step8 =
+        modint8(1, 1, 1, 1, 1, w[3], w[3] * w[3], w[3] * w[3] * w[3]);
+    modint8 istep4 = modint8(1, 1, 1, iw[2], 1, 1, 1, iw[2]);
+    modint8 istep8 =
+        modint8(1, 1, 1, 1, 1, iw[3], iw[3] * iw[3], iw[3] * iw[3] * iw[3]);
 };
 template <u32 MOD> const FFTInfo<MOD> fft_info = FFTInfo<MOD>();
 
-template <u32 MOD> ModInt8<MOD> fft_single(ModInt8<MOD> x) {
-    static const FFTInfo<MOD>& info = fft_info<MOD>;
-    static const ModInt<MOD> w4 = info.w[2], w8 = info.w[3];
-    static const auto step4 = ModInt8<MOD>(1, 1, 1, w4, 1, 1, 1, w4);
-    static const auto step8 =
-        ModInt8<MOD>(1, 1, 1, 1, 1, w8, w8 * w8, w8 * w8 * w8);
+// FFTInfo of a runtime modulus (modint8::mod() at construction)
+template <class _modint8> struct DynFFTInfo {
+    using modint8 = _modint8;
+    using modint = typename modint8::modint;
+
+    static constexpr int MAX_ORD2 = 29;
+
+    u32 mod;
+    u32 g;
+    int ord2;
+
+    // same as FFTInfo, valid for index <= ord2
+    std::array<modint, MAX_ORD2 + 1> w, iw;
+    std::array<modint, MAX_ORD2 + 1> rot8, irot8;
+    std::array<modint, MAX_ORD2 + 1> rot4, irot4;
+    std::array<modint8, MAX_ORD2 + 2> rot16i, irot16i;
+    modint8 step4, step8, istep4, istep8;
+
+    DynFFTInfo()
+        : mod(modint8::mod()),
+          g(primitive_root_constexpr(mod)),
+          ord2(std::countr_zero(mod - 1)) {
+        // step4 / step8 use the roots of order 4 and 8
+        assert(ord2 >= 3);
+        w[ord2] = modint(g).pow((mod - 1) >> ord2);
+        iw[ord2] = w[ord2].inv();
+        for (int i = ord2 - 1; i >= 0; i--) {
+            w[i] = w[i + 1] * w[i + 1];
+            iw[i] = iw[i + 1] * iw[i + 1];
+        }
+        for (int i = 3; i <= ord2; i++) {
+            rot8[i] = w[i];
+            irot8[i] = iw[i];
+            for (int j = 3; j < i; j++) {
+                rot8[i] *= iw[j];
+                irot8[i] *= w[j];
+            }
+        }
+        for (int i = 4; i <= ord2; i++) {
+            rot4[i] = w[i];
+            irot4[i] = iw[i];
+            for (int j = 4; j < i; j++) {
+                rot4[i] *= iw[j];
+                irot4[i] *= w[j];
+            }
+            std::array<modint, 8> buf, ibuf;
+            buf[0] = ibuf[0] = 1;
+            for (int j = 1; j < 8; j++) {
+                buf[j] = buf[j - 1] * rot4[i];
+                ibuf[j] = ibuf[j - 1] * irot4[i];
+            }
+            rot16i[i] = modint8(buf);
+            irot16i[i] = modint8(ibuf);
+        }
+        step4 = modint8(1, 1, 1, w[2], 1, 1, 1, w[2]);
+        step8 = modint8(1, 1, 1, 1, 1, w[3], w[3] * w[3], w[3] * w[3] * w[3]);
+        istep4 = modint8(1, 1, 1, iw[2], 1, 1, 1, iw[2]);
+        istep8 =
+            modint8(1, 1, 1, 1, 1, iw[3], iw[3] * iw[3], iw[3] * iw[3] * iw[3]);
+    }
+
+    modint rot_shift8(u32 i) const { return rot8[std::countr_one(i >> 3) + 3]; }
+    modint irot_shift8(u32 i) const {
+        return irot8[std::countr_one(i >> 3) + 3];
+    }
+    modint8 rot_shift16i(u32 i) const {
+        return rot16i[std::countr_one(i >> 4) + 4];
+    }
+    modint8 irot_shift16i(u32 i) const {
+        return irot16i[std::countr_one(i >> 4) + 4];
+    }
+};
+
+// FFTInfoOf<modint8>::get() : the tables used by fft / ifft over modint8
+template <class modint8> struct FFTInfoOf;
+template <u32 MOD> struct FFTInfoOf<ModInt8<MOD>> {
+    static const FFTInfo<MOD>& get() { return fft_info<MOD>; }
+};
+template <int id> struct FFTInfoOf<DynModInt8<id>> {
+    // tables are built on the first use of each modulus and cached
+    static const DynFFTInfo<DynModInt8<id>>& get() {
+        using Info = DynFFTInfo<DynModInt8<id>>;
+        static thread_local std::map<u32, std::unique_ptr<Info>> cache;
+        static thread_local const Info* last = nullptr;
+
+        const u32 mod = DynModInt<id>::mod();
+        if (last == nullptr || last->mod != mod) {
+            auto& info = cache[mod];
+            if (!info) info = std::make_unique<Info>();
+            last = info.get();
+        }
+        return *last;
+    }
+};
+
+// the largest length of fft / ifft over modint8, in blocks: the roots of
+// unity mod p have orders up to 2^ord2 for ord2 = countr_zero(p - 1)
+// (0 if ord2 < 3, e.g. a DynModInt8 modulus 10^9 + 7, which has no fft)
+template <class modint8> ssize_t max_fft_size() {
+    const int ord2 = std::countr_zero(modint8::mod() - 1);
+    return ord2 < 3 ? 0 : ssize_t(1) << (ord2 - 3);
+}
+
+// Memory tuning of fft / ifft for transforms larger than the caches, both
+// off by default. BM_fft_options of fft_benchmark measures them (and
+// huge_pages()) on the running machine. Set them before other threads use
+// fft.
+struct FFTOptions {
+    // the radix-4 passes prefetch the next group of four rows while one is
+    // processed
+    bool prefetch = false;
+    // the last pass of fft writes by non-temporal stores, so the output
+    // does not evict other data from the caches (but is not in them either)
+    bool stream_stores = false;
+};
+inline FFTOptions& fft_options() {
+    static FFTOptions options;
+    return options;
+}
 
+template <class modint8, class Info>
+modint8 fft_single(modint8 x, const Info& info) {
     x = (blend<0b11110000>(x, -x) + x.permutevar({4, 5, 6, 7, 0, 1, 2, 3})) *
-        step8;
+        info.step8;
     x = (blend<0b11001100>(x, -x) + x.permutevar({2, 3, 0, 1, 6, 7, 4, 5})) *
-        step4;
+        info.step4;
     x = (blend<0b10101010>(x, -x) + x.permutevar({1, 0, 3, 2, 5, 4, 7, 6}));
     return x;
 }
+template <class modint8>
+    requires is_modint8<modint8>::value
+modint8 fft_single(modint8 x) {
+    return fft_single(x, FFTInfoOf<modint8>::get());
+}
 
-template <u32 MOD> ModInt8<MOD> ifft_single(ModInt8<MOD> x) {
-    static const FFTInfo<MOD>& info = fft_info<MOD>;
-    static const ModInt<MOD> iw4 = info.iw[2], iw8 = info.iw[3];
-    static const auto step4 = ModInt8<MOD>(1, 1, 1, iw4, 1, 1, 1, iw4);
-    static const auto step8 =
-        ModInt8<MOD>(1, 1, 1, 1, 1, iw8, iw8 * iw8, iw8 * iw8 * iw8);
-
+template <class modint8, class Info>
+modint8 ifft_single(modint8 x, const Info& info) {
     x = (blend<0b10101010>(x, -x) + x.permutevar({1, 0, 3, 2, 5, 4, 7, 6})) *
-        step4;
+        info.istep4;
     x = (blend<0b11001100>(x, -x) + x.permutevar({2, 3, 0, 1, 6, 7, 4, 5})) *
-        step8;
+        info.istep8;
     x = (blend<0b11110000>(x, -x) + x.permutevar({4, 5, 6, 7, 0, 1, 2, 3}));
 
     return x;
 }
+template <class modint8>
+    requires is_modint8<modint8>::value
+modint8 ifft_single(modint8 x) {
+    return ifft_single(x, FFTInfoOf<modint8>::get());
+}
 
-template <std::ranges::random_access_range R>
-    requires is_modint8<std::ranges::range_value_t<R>>::value
-void fft(R&& a) {
+namespace internal {
+
+// The transforms below take one or more arrays of the same length, which
+// share the loop nest and the twiddle factors.
+
+// bf(a, i) for i < len for each array a. Short rows (the last passes, where
+// the serial twiddle chain dominates) interleave the independent
+// butterflies of the arrays. Long rows are independent anyway and are run
+// one array after another, which keeps the registers for one butterfly.
+template <class F, class... Rs>
+void butterflies(int len, const F& bf, Rs&... as) {
+    if (len >= 4) {
+        auto rows = [&](auto& a) {
+            for (int i = 0; i < len; i++) bf(a, i);
+        };
+        (rows(as), ...);
+    } else {
+        for (int i = 0; i < len; i++) (bf(as, i), ...);
+    }
+}
+
+// prefetches a[start + k len + i] (k < 4) for writing
+template <class R> void prefetch_rows(R& a, int start, int len, int i) {
+    for (int k = 0; k < 4; k++) {
+        __builtin_prefetch(&a[start + k * len + i], 1);
+    }
+}
+
+template <class R, class... Rs>
+void fft_lanes(R&& x, Rs&&... xs) {
     using modint8 = std::ranges::range_value_t<R>;
-    static constexpr u32 MOD = modint8::mod();
 
-    static const FFTInfo<MOD>& info = fft_info<MOD>;
+    const auto& info = FFTInfoOf<modint8>::get();
 
-    const int n = int(a.size());
+    const int n = int(x.size());
+    assert(((int(xs.size()) == n) && ...));
     const int lg = std::countr_zero((u32)n);
 
     int h = lg;
     if (h % 2) {
         // 2-base
         int len = n / 2;
-        for (int i = 0; i < len; i++) {
-            auto l = a[0 * len + i];
-            auto r = a[1 * len + i];
-            a[0 * len + i] = l + r;
-            a[1 * len + i] = l - r;
-        }
+        auto rows = [&](auto& a) {
+            for (int i = 0; i < len; i++) {
+                auto l = a[0 * len + i];
+                auto r = a[1 * len + i];
+                a[0 * len + i] = l + r;
+                a[1 * len + i] = l - r;
+            }
+        };
+        rows(x);
+        (rows(xs), ...);
         h--;
     }
+    const bool prefetch = fft_options().prefetch;
     while (h >= 2) {
         // 4-base
-        static const modint8 w2 = modint8::set1(info.w[2]);
+        const modint8 w2 = modint8::set1(info.w[2]);
 
         modint8 rotx = modint8::set1(1);
         for (int start = 0; start < n; start += (1 << h)) {
@@ -182,66 +351,53 @@ void fft(R&& a) {
             const modint8 rot3x = rot2x * rotx;
 
             int len = 1 << (h - 2);
-            for (int i = 0; i < len; i++) {
-                auto a0 = a[start + 0 * len + i];
-                auto a1 = a[start + 1 * len + i] * rotx;
-                auto a2 = a[start + 2 * len + i] * rot2x;
-                auto a3 = a[start + 3 * len + i] * rot3x;
-
-                auto x = (a1 - a3) * w2;
-                a[start + 0 * len + i] = (a0 + a2) + (a1 + a3);
-                a[start + 1 * len + i] = (a0 + a2) - (a1 + a3);
-                a[start + 2 * len + i] = (a0 - a2) + x;
-                a[start + 3 * len + i] = (a0 - a2) - x;
-            }
+            const int next = start + (1 << h);
+            auto bf = [&](auto& a, int i) {
+                if (prefetch && next < n) prefetch_rows(a, next, len, i);
+                auto x0 = a[start + 0 * len + i];
+                auto x1 = a[start + 1 * len + i] * rotx;
+                auto x2 = a[start + 2 * len + i] * rot2x;
+                auto x3 = a[start + 3 * len + i] * rot3x;
+
+                auto y = (x1 - x3) * w2;
+                a[start + 0 * len + i] = (x0 + x2) + (x1 + x3);
+                a[start + 1 * len + i] = (x0 + x2) - (x1 + x3);
+                a[start + 2 * len + i] = (x0 - x2) + y;
+                a[start + 3 * len + i] = (x0 - x2) - y;
+            };
+            butterflies(len, bf, x, xs...);
             rotx *= modint8::set1(info.rot_shift8(8 * (start >> h)));
         }
         h -= 2;
     }
-
-    {
-        // fft each element
-        modint8 rotxi = modint8::set1(1);
-        for (int i = 0; i < n; i++) {
-            a[i] = fft_single(a[i] * rotxi);
-            rotxi *= info.rot_shift16i(16 * i);
-        }
-    }
 }
 
-template <std::ranges::random_access_range R>
-    requires is_modint8<std::ranges::range_value_t<R>>::value
-void ifft(R&& a) {
+template <class R, class... Rs>
+void ifft_lanes(R&& x, Rs&&... xs) {
     using modint8 = std::ranges::range_value_t<R>;
-    static constexpr u32 MOD = modint8::mod();
 
-    static const FFTInfo<MOD>& info = fft_info<MOD>;
+    const auto& info = FFTInfoOf<modint8>::get();
 
-    const int n = int(a.size());
+    const int n = int(x.size());
+    assert(((int(xs.size()) == n) && ...));
     const int lg = std::countr_zero((u32)n);
 
-    {
-        // 8-base
-        modint8 irotxi = modint8::set1(1);
-        for (int i = 0; i < n; i++) {
-            a[i] = ifft_single(a[i]) * irotxi;
-            irotxi *= info.irot_shift16i(16 * i);
-        }
-    }
-
+    const bool prefetch = fft_options().prefetch;
     int h = 0;
     while (h + 2 <= lg) {
         h += 2;
 
         // 4-base
-        static const modint8 w2 = modint8::set1(info.iw[2]);
+        const modint8 w2 = modint8::set1(info.iw[2]);
 
         modint8 rotx = modint8::set1(1);
         for (int start = 0; start < n; start += (1 << h)) {
             const auto rot2x = rotx * rotx;
             const auto rot3x = rot2x * rotx;
             int len = 1 << (h - 2);
-            for (int i = 0; i < len; i++) {
+            const int next = start + (1 << h);
+            auto bf = [&](auto& a, int i) {
+                if (prefetch && next < n) prefetch_rows(a, next, len, i);
                 auto a0 = a[start + 0 * len + i];
                 auto a1 = a[start + 1 * len + i];
                 auto a2 = a[start + 2 * len + i];
@@ -256,7 +412,8 @@ void ifft(R&& a) {
                 a[start + 1 * len + i] = (x1 + x3) * rotx;
                 a[start + 2 * len + i] = (x0 - x2) * rot2x;
                 a[start + 3 * len + i] = (x1 - x3) * rot3x;
-            }
+            };
+            butterflies(len, bf, x, xs...);
             rotx *= modint8::set1(info.irot_shift8(8 * (start >> h)));
         }
     }
@@ -264,14 +421,130 @@ void ifft(R&& a) {
     if (h + 1 == lg) {
         // 2-base
         int len = n / 2;
-        for (int i = 0; i < len; i++) {
-            auto l = a[0 * len + i];
-            auto r = a[1 * len + i];
-            a[0 * len + i] = l + r;
-            a[1 * len + i] = l - r;
-        }
+        auto rows = [&](auto& a) {
+            for (int i = 0; i < len; i++) {
+                auto l = a[0 * len + i];
+                auto r = a[1 * len + i];
+                a[0 * len + i] = l + r;
+                a[1 * len + i] = l - r;
+            }
+        };
+        rows(x);
+        (rows(xs), ...);
         h++;
     }
 }
 
+template <class R, class... Rs> void fft(R&& x, Rs&&... xs) {
+    using modint8 = std::ranges::range_value_t<R>;
+
+    const auto& info = FFTInfoOf<modint8>::get();
+    const int n = int(x.size());
+    assert(n <= max_fft_size<modint8>());
+    for (size_t k = 0; k <= sizeof...(xs); k++) {
+        FASTFPS_STATS_TRANSFORM(FFT, n);
+    }
+    FASTFPS_STATS_SCOPE(FFT, 8 * n * (1 + sizeof...(xs)));
+
+    fft_lanes(x, xs...);
+
+    auto aligned = [](const auto& a) {
+        return reinterpret_cast<uintptr_t>(&a[0]) % 32 == 0;
+    };
+    if (fft_options().stream_stores && aligned(x) && (aligned(xs) && ...)) {
+        modint8 rotxi = modint8::set1(1);
+        for (int i = 0; i < n; i++) {
+            fft_single(x[i] * rotxi, info).stream(&x[i]);
+            (fft_single(xs[i] * rotxi, info).stream(&xs[i]), ...);
+            rotxi *= info.rot_shift16i(16 * i);
+        }
+        stream_fence();
+        return;
+    }
+
+    {
+        // fft each element
+        modint8 rotxi = modint8::set1(1);
+        for (int i = 0; i < n; i++) {
+            x[i] = fft_single(x[i] * rotxi, info);
+            ((xs[i] = fft_single(xs[i] * rotxi, info)), ...);
+            rotxi *= info.rot_shift16i(16 * i);
+        }
+    }
+}
+
+template <class R, class... Rs> void ifft(R&& x, Rs&&... xs) {
+    using modint8 = std::ranges::range_value_t<R>;
+
+    const auto& info = FFTInfoOf<modint8>::get();
+    const int n = int(x.size());
+    assert(n <= max_fft_size<modint8>());
+    for (size_t k = 0; k <= sizeof...(xs); k++) {
+        FASTFPS_STATS_TRANSFORM(IFFT, n);
+    }
+    FASTFPS_STATS_SCOPE(IFFT, 8 * n * (1 + sizeof...(xs)));
+
+    {
+        // 8-base
+        modint8 irotxi = modint8::set1(1);
+        for (int i = 0; i < n; i++) {
+            x[i] = ifft_single(x[i], info) * irotxi;
+            ((xs[i] = ifft_single(xs[i], info) * irotxi), ...);
+            irotxi *= info.irot_shift16i(16 * i);
+        }
+    }
+
+    ifft_lanes(x, xs...);
+}
+
+}  // namespace internal
+
+// fft of each lane independently: a[i] holds the i-th coefficients of
+// 8 sequences. The output is in the same bit-reversed order as fft.
+template <std::ranges::random_access_range R>
+    requires is_modint8<std::ranges::range_value_t<R>>::value
+void fft_lanes(R&& a) {
+    internal::fft_lanes(a);
+}
+
+// inverse of fft_lanes (without 1 / n)
+template <std::ranges::random_access_range R>
+    requires is_modint8<std::ranges::range_value_t<R>>::value
+void ifft_lanes(R&& a) {
+    internal::ifft_lanes(a);
+}
+
+template <std::ranges::random_access_range R>
+    requires is_modint8<std::ranges::range_value_t<R>>::value
+void fft(R&& a) {
+    internal::fft(a);
+}
+
+template <std::ranges::random_access_range R>
+    requires is_modint8<std::ranges::range_value_t<R>>::value
+void ifft(R&& a) {
+    internal::ifft(a);
+}
+
+// fft(a) and fft(b) for |a| = |b|, in one pass that shares the twiddle
+// factors and interleaves the butterflies of a and b
+template <std::ranges::random_access_range R1,
+          std::ranges::random_access_range R2>
+    requires is_modint8<std::ranges::range_value_t<R1>>::value &&
+             std::same_as<std::ranges::range_value_t<R1>,
+                          std::ranges::range_value_t<R2>>
+void fft2(R1&& a, R2&& b) {
+    internal::fft(a, b);
+}
+
+// ifft(a) and ifft(b) for |a| = |b| in one pass, see fft2
+template <std::ranges::random_access_range R1,
+          std::ranges::random_access_range R2>
+    requires is_modint8<std::ranges::range_value_t<R1>>::value &&
+             std::same_as<std::ranges::range_value_t<R1>,
+                          std::ranges::range_value_t<R2>>
+void ifft2(R1&& a, R2&& b) {
+    internal::ifft(a, b);
+}
+
 }  // namespace fastfps
@@ -0,0 +1,247 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <ranges>
+#include <vector>
+
+#include "fastfps/math.hpp"
+#include "fastfps/modint64.hpp"
+#include "fastfps/modint64x4.hpp"
+#include "fastfps/types.hpp"
+
+namespace fastfps {
+
+// FFTInfo for ModInt64x4 (4 lanes per element)
+template <u64 MOD> struct FFTInfo64 {
+    using modint = ModInt64<MOD>;
+    using modint4 = ModInt64x4<MOD>;
+
+    static constexpr u64 g = primitive_root64<MOD>;
+    static constexpr int ord2 = std::countr_zero(MOD - 1);
+
+    // w[i]^(2^i) == 1 : w[i] is the fft omega of n=2^i
+    static constexpr std::array<modint, ord2 + 1> w = []() {
+        std::array<modint, ord2 + 1> v;
+        v[ord2] = modint(g).pow((MOD - 1) >> ord2);
+        for (int i = ord2 - 1; i >= 0; i--) {
+            v[i] = v[i + 1] * v[i + 1];
+        }
+        return v;
+    }();
+    static constexpr std::array<modint, ord2 + 1> iw = []() {
+        std::array<modint, ord2 + 1> v;
+        v[ord2] = w[ord2].inv();
+        for (int i = ord2 - 1; i >= 0; i--) {
+            v[i] = v[i + 1] * v[i + 1];
+        }
+        return v;
+    }();
+
+    static constexpr std::array<modint, ord2 + 1> rot8 = []() {
+        std::array<modint, std::max(0, ord2 + 1)> v;
+        for (int i = 3; i <= ord2; i++) {
+            v[i] = w[i];
+            for (int j = 3; j < i; j++) {
+                v[i] *= iw[j];
+            }
+        }
+        return v;
+    }();
+    static constexpr std::array<modint, ord2 + 1> irot8 = []() {
+        std::array<modint, std::max(0, ord2 + 1)> v;
+        for (int i = 3; i <= ord2; i++) {
+            v[i] = iw[i];
+            for (int j = 3; j < i; j++) {
+                v[i] *= w[j];
+            }
+        }
+        return v;
+    }();
+    // rot[i] * rot_shift8(i) = rot[i + 8]
+    modint rot_shift8(u32 i) const { return rot8[std::countr_one(i >> 3) + 3]; }
+    modint irot_shift8(u32 i) const {
+        return irot8[std::countr_one(i >> 3) + 3];
+    }
+
+    std::array<modint4, ord2 + 1> rot8i = []() {
+        std::array<modint4, std::max(0, ord2 + 1)> v;
+        for (int i = 3; i <= ord2; i++) {
+            v[i] = modint4(1, rot8[i], rot8[i] * rot8[i],
+                           rot8[i] * rot8[i] * rot8[i]);
+        }
+        return v;
+    }();
+    std::array<modint4, ord2 + 1> irot8i = []() {
+        std::array<modint4, std::max(0, ord2 + 1)> v;
+        for (int i = 3; i <= ord2; i++) {
+            v[i] = modint4(1, irot8[i], irot8[i] * irot8[i],
+                           irot8[i] * irot8[i] * irot8[i]);
+        }
+        return v;
+    }();
+    // rot[i * j] * rot_shift8i(i)[j] = rot[(i + 8) * j]
+    modint4 rot_shift8i(u32 i) const {
+        return rot8i[std::countr_one(i >> 3) + 3];
+    }
+    modint4 irot_shift8i(u32 i) const {
+        return irot8i[std::countr_one(i >> 3) + 3];
+    }
+
+    // twiddles of the in-lane stage (fft_single / ifft_single)
+    modint4 step4 = modint4(1, 1, 1, w[2]);
+    modint4 istep4 = modint4(1, 1, 1, iw[2]);
+};
+template <u64 MOD> const FFTInfo64<MOD> fft_info64 = FFTInfo64<MOD>();
+
+// the largest length of fft / ifft over ModInt64x4<MOD>, in elements of 4
+// lanes (0 if MOD has no root of unity of order 4)
+template <u64 MOD> constexpr ssize_t max_fft64_size() {
+    constexpr int ord2 = std::countr_zero(MOD - 1);
+    return ord2 < 2 ? 0 : ssize_t(1) << (ord2 - 2);
+}
+
+template <u64 MOD> ModInt64x4<MOD> fft_single(ModInt64x4<MOD> x) {
+    static const FFTInfo64<MOD>& info = fft_info64<MOD>;
+    x = (blend<0b1100>(x, -x) + x.permutevar({2, 3, 0, 1})) * info.step4;
+    x = (blend<0b1010>(x, -x) + x.permutevar({1, 0, 3, 2}));
+    return x;
+}
+
+template <u64 MOD> ModInt64x4<MOD> ifft_single(ModInt64x4<MOD> x) {
+    static const FFTInfo64<MOD>& info = fft_info64<MOD>;
+    x = (blend<0b1010>(x, -x) + x.permutevar({1, 0, 3, 2})) * info.istep4;
+    x = (blend<0b1100>(x, -x) + x.permutevar({2, 3, 0, 1}));
+    return x;
+}
+
+template <std::ranges::random_access_range R>
+    requires is_modint64x4<std::ranges::range_value_t<R>>::value
+void fft(R&& a) {
+    using modint4 = std::ranges::range_value_t<R>;
+    static constexpr u64 MOD = modint4::mod();
+
+    static const FFTInfo64<MOD>& info = fft_info64<MOD>;
+
+    const int n = int(a.size());
+    assert(n <= max_fft64_size<MOD>());
+    const int lg = std::countr_zero((u32)n);
+
+    int h = lg;
+    if (h % 2) {
+        // 2-base
+        int len = n / 2;
+        for (int i = 0; i < len; i++) {
+            auto l = a[0 * len + i];
+            auto r = a[1 * len + i];
+            a[0 * len + i] = l + r;
+            a[1 * len + i] = l - r;
+        }
+        h--;
+    }
+    while (h >= 2) {
+        // 4-base
+        static const modint4 w2 = modint4::set1(info.w[2]);
+
+        modint4 rotx = modint4::set1(1);
+        for (int start = 0; start < n; start += (1 << h)) {
+            const modint4 rot2x = rotx * rotx;
+            const modint4 rot3x = rot2x * rotx;
+
+            int len = 1 << (h - 2);
+            for (int i = 0; i < len; i++) {
+                auto a0 = a[start + 0 * len + i];
+                auto a1 = a[start + 1 * len + i] * rotx;
+                auto a2 = a[start + 2 * len + i] * rot2x;
+                auto a3 = a[start + 3 * len + i] * rot3x;
+
+                auto x = (a1 - a3) * w2;
+                a[start + 0 * len + i] = (a0 + a2) + (a1 + a3);
+                a[start + 1 * len + i] = (a0 + a2) - (a1 + a3);
+                a[start + 2 * len + i] = (a0 - a2) + x;
+                a[start + 3 * len + i] = (a0 - a2) - x;
+            }
+            rotx *= modint4::set1(info.rot_shift8(8 * (start >> h)));
+        }
+        h -= 2;
+    }
+
+    {
+        // fft each element
+        modint4 rotxi = modint4::set1(1);
+        for (int i = 0; i < n; i++) {
+            a[i] = fft_single(a[i] * rotxi);
+            rotxi *= info.rot_shift8i(8 * i);
+        }
+    }
+}
+
+template <std::ranges::random_access_range R>
+    requires is_modint64x4<std::ranges::range_value_t<R>>::value
+void ifft(R&& a) {
+    using modint4 = std::ranges::range_value_t<R>;
+    static constexpr u64 MOD = modint4::mod();
+
+    static const FFTInfo64<MOD>& info = fft_info64<MOD>;
+
+    const int n = int(a.size());
+    assert(n <= max_fft64_size<MOD>());
+    const int lg = std::countr_zero((u32)n);
+
+    {
+        // 4-base
+        modint4 irotxi = modint4::set1(1);
+        for (int i = 0; i < n; i++) {
+            a[i] = ifft_single(a[i]) * irotxi;
+            irotxi *= info.irot_shift8i(8 * i);
+        }
+    }
+
+    int h = 0;
+    while (h + 2 <= lg) {
+        h += 2;
+
+        // 4-base
+        static const modint4 w2 = modint4::set1(info.iw[2]);
+
+        modint4 rotx = modint4::set1(1);
+        for (int start = 0; start < n; start += (1 << h)) {
+            const auto rot2x = rotx * rotx;
+            const auto rot3x = rot2x * rotx;
+            int len = 1 << (h - 2);
+            for (int i = 0; i < len; i++) {
+                auto a0 = a[start + 0 * len + i];
+                auto a1 = a[start + 1 * len + i];
+                auto a2 = a[start + 2 * len + i];
+                auto a3 = a[start + 3 * len + i];
+
+                auto x0 = a0 + a1;
+                auto x1 = a0 - a1;
+                auto x2 = a2 + a3;
+                auto x3 = (a2 - a3) * w2;
+
+                a[start + 0 * len + i] = x0 + x2;
+                a[start + 1 * len + i] = (x1 + x3) * rotx;
+                a[start + 2 * len + i] = (x0 - x2) * rot2x;
+                a[start + 3 * len + i] = (x1 - x3) * rot3x;
+            }
+            rotx *= modint4::set1(info.irot_shift8(8 * (start >> h)));
+        }
+    }
+
+    if (h + 1 == lg) {
+        // 2-base
+        int len = n / 2;
+        for (int i = 0; i < len; i++) {
+            auto l = a[0 * len + i];
+            auto r = a[1 * len + i];
+            a[0 * len + i] = l + r;
+            a[1 * len + i] = l - r;
+        }
+        h++;
+    }
+}
+
+}  // namespace fastfps
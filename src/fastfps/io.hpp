@@ -0,0 +1,214 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+
+#include "fastfps/modvec.hpp"
+#include "fastfps/types.hpp"
+
+namespace fastfps {
+
+namespace internal {
+
+constexpr std::array<u64, 20> POW10 = [] {
+    std::array<u64, 20> p{};
+    p[0] = 1;
+    for (int i = 1; i < 20; i++) p[i] = p[i - 1] * 10;
+    return p;
+}();
+
+// "00", "01", ..., "99"
+constexpr std::array<char, 200> DIGITS2 = [] {
+    std::array<char, 200> d{};
+    for (int i = 0; i < 100; i++) {
+        d[2 * i] = char('0' + i / 10);
+        d[2 * i + 1] = char('0' + i % 10);
+    }
+    return d;
+}();
+
+// number of decimal digits of x (1 for x = 0)
+inline int count_digits(u64 x) {
+    const int t = int(std::bit_width(x | 1) * 1233 >> 12);
+    return t + ((x | 1) >= POW10[t]);
+}
+
+// Parses the leading digits of the 8 bytes at p (SWAR).
+// Returns the value and sets len to the number of digits (0 to 8).
+inline u64 parse8(const char* p, int& len) {
+    u64 x;
+    std::memcpy(&x, p, 8);
+    x ^= 0x3030303030303030;  // '0'..'9' -> 0..9
+    // the high bit of a byte is set iff the byte is not a digit. A carry
+    // only goes up from a non-digit byte, so the lowest one is correct.
+    const u64 non_digit = ((x + 0x7676767676767676) | x) & 0x8080808080808080;
+    len = std::countr_zero(non_digit) / 8;
+    if (len == 0) return 0;
+    // the first digit is in the lowest byte, so shift it to be the highest
+    x <<= 8 * (8 - len);
+    x = ((x & 0x0f0f0f0f0f0f0f0f) * 2561) >> 8;
+    x = ((x & 0x00ff00ff00ff00ff) * 6553601) >> 16;
+    x = ((x & 0x0000ffff0000ffff) * 42949672960001) >> 32;
+    return x;
+}
+
+}  // namespace internal
+
+// Buffered reader of whitespace-separated decimal integers.
+//
+//   Reader in;
+//   int n = in.read<int>();
+//   ModVec<MOD> a(n);
+//   in.read(a);
+//
+// Digits are parsed 8 at a time, and ModVec elements go straight into the
+// blocks (one Montgomery conversion per 8 values).
+class Reader {
+  public:
+    explicit Reader(FILE* _fp = stdin) : fp(_fp) {}
+    Reader(const Reader&) = delete;
+    Reader& operator=(const Reader&) = delete;
+
+    template <std::integral T> T read() {
+        skip_space();
+        bool neg = false;
+        if constexpr (std::is_signed_v<T>) {
+            if (buf[pos] == '-') {
+                neg = true;
+                pos++;
+            }
+        }
+        u64 x = 0;
+        while (true) {
+            int len;
+            u64 d = internal::parse8(buf.data() + pos, len);
+            x = x * internal::POW10[len] + d;
+            pos += len;
+            if (len < 8) break;
+            ensure(LOOKAHEAD);
+        }
+        return T(neg ? 0 - x : x);
+    }
+
+    // reads a.size() values in [0, 2^32)
+    template <class modint8> void read(BasicModVec<modint8>& a) {
+        const ssize_t n = a.size();
+        auto v = a.blocks();
+        for (ssize_t i = 0; i < std::ssize(v); i++) {
+            std::array<u32, 8> b{};
+            const ssize_t m = std::min<ssize_t>(8, n - 8 * i);
+            for (ssize_t j = 0; j < m; j++) b[j] = read<u32>();
+            v[i] = modint8(b);
+        }
+    }
+
+  private:
+    static constexpr ssize_t SIZE = 1 << 16;
+    // bytes guaranteed after pos before a number is parsed. 20 digits of
+    // u64 and the 8-byte loads fit in this.
+    static constexpr ssize_t LOOKAHEAD = 64;
+
+    FILE* fp;
+    // zeros (non-digits) after end, so that parse8 can read past it
+    std::array<char, SIZE + 8> buf{};
+    ssize_t pos = 0, end = 0;
+    bool eof = false;
+
+    void ensure(ssize_t k) {
+        if (end - pos >= k || eof) return;
+        std::memmove(buf.data(), buf.data() + pos, end - pos);
+        end -= pos;
+        pos = 0;
+        const size_t r = std::fread(buf.data() + end, 1, SIZE - end, fp);
+        if (r == 0) eof = true;
+        end += ssize_t(r);
+        std::fill_n(buf.begin() + end, 8, 0);
+    }
+
+    void skip_space() {
+        while (true) {
+            ensure(LOOKAHEAD);
+            while (pos < end && (unsigned char)buf[pos] <= ' ') pos++;
+            if (pos < end || eof) break;
+        }
+        ensure(LOOKAHEAD);
+    }
+};
+
+// Buffered writer. The buffer is flushed on destruction.
+class Writer {
+  public:
+    explicit Writer(FILE* _fp = stdout) : fp(_fp) {}
+    ~Writer() { flush(); }
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+
+    void write(char c) {
+        ensure(1);
+        buf[pos++] = c;
+    }
+
+    template <std::integral T> void write(T x) {
+        ensure(21);
+        u64 y = u64(x);
+        if constexpr (std::is_signed_v<T>) {
+            if (x < 0) {
+                buf[pos++] = '-';
+                y = 0 - y;
+            }
+        }
+        const int len = internal::count_digits(y);
+        char* p = buf.data() + pos + len;
+        while (y >= 100) {
+            p -= 2;
+            std::memcpy(p, internal::DIGITS2.data() + 2 * (y % 100), 2);
+            y /= 100;
+        }
+        if (y >= 10) {
+            p -= 2;
+            std::memcpy(p, internal::DIGITS2.data() + 2 * y, 2);
+        } else {
+            *--p = char('0' + y);
+        }
+        pos += len;
+    }
+
+    // the values of a separated by sep
+    template <class modint8>
+    void write(const BasicModVec<modint8>& a, char sep = ' ') {
+        const ssize_t n = a.size();
+        auto v = a.blocks();
+        for (ssize_t i = 0; i < std::ssize(v); i++) {
+            const auto b = v[i].val();
+            const ssize_t m = std::min<ssize_t>(8, n - 8 * i);
+            for (ssize_t j = 0; j < m; j++) {
+                if (i || j) write(sep);
+                write(b[j]);
+            }
+        }
+    }
+
+    void flush() {
+        std::fwrite(buf.data(), 1, pos, fp);
+        pos = 0;
+    }
+
+  private:
+    static constexpr ssize_t SIZE = 1 << 16;
+
+    FILE* fp;
+    std::array<char, SIZE> buf;
+    ssize_t pos = 0;
+
+    void ensure(ssize_t k) {
+        if (SIZE - pos < k) flush();
+    }
+};
+
+}  // namespace fastfps
@@ -48,4 +48,54 @@ constexpr u32 primitive_root_constexpr(u32 m) {
 }
 template <u32 m> constexpr u32 primitive_root = primitive_root_constexpr(m);
 
+constexpr u64 pow_mod64_constexpr(u64 x, u64 n, u64 m) {
+    using u128 = unsigned __int128;
+    if (m == 1) return 0;
+    x %= m;
+
+    u64 r = 1;
+    while (n) {
+        if (n & 1) r = u64(u128(r) * x % m);
+        x = u64(u128(x) * x % m);
+        n >>= 1;
+    }
+
+    return r;
+}
+
+// m - 1 is factorized by trial division, so m - 1 should be
+// (small number) * 2^k as for NTT primes
+constexpr u64 primitive_root64_constexpr(u64 m) {
+    if (m == 2) return 1;
+
+    u64 divs[64] = {};
+    int cnt = 0;
+    u64 x = m - 1;
+    divs[cnt++] = 2;
+    while (x % 2 == 0) x /= 2;
+    for (u64 i = 3; i * i <= x; i += 2) {
+        if (x % i == 0) {
+            divs[cnt++] = i;
+            while (x % i == 0) {
+                x /= i;
+            }
+        }
+    }
+    if (x > 1) {
+        divs[cnt++] = x;
+    }
+    for (u64 g = 2;; g++) {
+        bool ok = true;
+        for (int i = 0; i < cnt; i++) {
+            if (pow_mod64_constexpr(g, (m - 1) / divs[i], m) == 1) {
+                ok = false;
+                break;
+            }
+        }
+        if (ok) return g;
+    }
+}
+template <u64 m>
+constexpr u64 primitive_root64 = primitive_root64_constexpr(m);
+
 }  // namespace fastfps
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <bit>
 #include <cassert>
 #include <iostream>
 
@@ -18,6 +19,56 @@ constexpr u32 inv_u32(const u32 x) {
     return inv;
 }
 
+// (y, k) with x y = 2^k (mod m), for odd m and gcd(x, m) = 1, and (0, 0)
+// for x = 0 (so inv() of 0 is 0, as x^(m-2) was)
+//
+// Binary extended gcd: (u, a) and (v, b) keep a x = u 2^k and b x = v 2^k
+// with u, v odd. Each step subtracts the smaller of u, v from the larger
+// and strips the factors of 2 by doubling the other coefficient instead of
+// halving (so no division by 2 mod m), until u = v = 1. k < 64 and
+// |a|, |b| <= m.
+struct BinaryInv {
+    u32 y;
+    int k;
+};
+constexpr BinaryInv inv_binary(u32 x, u32 m) {
+    assert(m % 2 && x < m);
+    if (x == 0) return {0, 0};
+    i64 a = 0, b = 1;
+    u32 u = m, v = x;
+    int k = std::countr_zero(v);
+    v >>= k;
+    while (u != v) {
+        // branchless swap: whether u < v is unpredictable
+        const bool swap = u < v;
+        const u32 lo = swap ? u : v, hi = swap ? v : u;
+        const i64 d = (a ^ b) & -i64(swap);
+        const i64 a2 = a ^ d, b2 = b ^ d;
+        const int t = __builtin_ctz(hi - lo);
+        u = (hi - lo) >> t;
+        v = lo;
+        a = a2 - b2;
+        b = b2 << t;
+        k += t;
+    }
+    // gcd(x, m) = u
+    assert(u == 1);
+    return {u32(b < 0 ? b + m : b), k};
+}
+
+// 2^(96 - k) mod m for k <= 64
+constexpr std::array<u32, 65> inv_binary_table(u32 m) {
+    std::array<u32, 65> t;
+    u64 x = 1;
+    for (int i = 0; i < 96; i++) x = x * 2 % m;
+    const u64 half = (m + 1) / 2;
+    for (int k = 0; k <= 64; k++) {
+        t[k] = u32(x);
+        x = x * half % m;
+    }
+    return t;
+}
+
 template <u32 MOD> struct ModInt {
     static_assert(MOD % 2 && MOD <= (1U << 30) - 1,
                   "mod must be odd and at most 2^30 - 1");
@@ -81,9 +132,14 @@ template <u32 MOD> struct ModInt {
         }
         return r;
     }
+    // x must be coprime to MOD (which may be composite)
     constexpr ModInt inv() const {
-        // TODO: for non-prime
-        return pow(MOD - 2);
+        // x = a 2^32 and x y = 2^k: 1 / a = 2^64 y 2^-k, which is
+        // mulreduce(y, 2^(96 - k))
+        const auto [y, k] = inv_binary(x < MOD ? x : x - MOD, MOD);
+        ModInt r;
+        r.x = mulreduce(y, INV_BINARY[k]);
+        return r;
     }
 
     friend std::ostream& operator<<(std::ostream& os, const ModInt& v) {
@@ -96,6 +152,7 @@ template <u32 MOD> struct ModInt {
     static constexpr u32 B = ((u64(1) << 32)) % MOD;
     static constexpr u32 B2 = u64(1) * B * B % MOD;
     static constexpr u32 INV = -inv_u32(MOD);
+    static constexpr std::array<u32, 65> INV_BINARY = inv_binary_table(MOD);
 
     // Input: (l * r) must be no more than (2^32 * MOD)
     // Output: ((l * r) / 2^32) % MOD
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <concepts>
+#include <iostream>
+#include <utility>
+
+#include "fastfps/math.hpp"
+#include "fastfps/types.hpp"
+
+namespace fastfps {
+
+// x * inv_u64(x) = 1 (mod 2^64)
+constexpr u64 inv_u64(const u64 x) {
+    assert(x % 2);
+    u64 inv = 1;
+    for (int i = 0; i < 6; i++) {
+        inv *= 2u - inv * x;
+    }
+    return inv;
+}
+
+template <u64 MOD> struct ModInt64 {
+    static_assert(MOD % 2 && MOD <= (u64(1) << 62) - 1,
+                  "mod must be odd and at most 2^62 - 1");
+
+    static constexpr u64 mod() { return MOD; }
+
+    constexpr ModInt64() : x(0) {}
+    constexpr explicit ModInt64(u64 _x) : x(mulreduce(_x, B2)) {}
+
+    constexpr ModInt64(std::signed_integral auto _x)
+        : ModInt64((u64)(_x % (i64)MOD + (i64)MOD)) {}
+    constexpr ModInt64(std::unsigned_integral auto _x)
+        : ModInt64((u64)(_x % MOD)) {}
+
+    constexpr u64 val() const {
+        u64 y = mulreduce(x, 1);
+        return y < MOD ? y : y - MOD;
+    }
+    constexpr u64 internal_val() const { return x; }
+
+    constexpr ModInt64& operator+=(const ModInt64& rhs) {
+        x += rhs.x;
+        x = std::min(x, x - 2 * MOD);
+        return *this;
+    }
+    constexpr friend ModInt64 operator+(const ModInt64& lhs,
+                                       const ModInt64& rhs) {
+        return ModInt64(lhs) += rhs;
+    }
+
+    constexpr ModInt64& operator-=(const ModInt64& rhs) {
+        x += 2 * MOD - rhs.x;
+        x = std::min(x, x - 2 * MOD);
+        return *this;
+    }
+    constexpr friend ModInt64 operator-(const ModInt64& lhs,
+                                       const ModInt64& rhs) {
+        return ModInt64(lhs) -= rhs;
+    }
+
+    constexpr ModInt64& operator*=(const ModInt64& rhs) {
+        x = mulreduce(x, rhs.x);
+        return *this;
+    }
+    constexpr friend ModInt64 operator*(const ModInt64& lhs,
+                                       const ModInt64& rhs) {
+        return ModInt64(lhs) *= rhs;
+    }
+
+    friend bool operator==(const ModInt64& lhs, const ModInt64& rhs) {
+        auto lx = lhs.x;
+        if (lx >= MOD) lx -= MOD;
+        auto rx = rhs.x;
+        if (rx >= MOD) rx -= MOD;
+        return lx == rx;
+    }
+
+    constexpr ModInt64 pow(u64 n) const {
+        ModInt64 v = *this, r = 1;
+        while (n) {
+            if (n & 1) r *= v;
+            v *= v;
+            n >>= 1;
+        }
+        return r;
+    }
+    // by the extended Euclidean algorithm, so MOD may be any odd modulus
+    // (gcd(x, MOD) must be 1; inv() of 0 is 0)
+    constexpr ModInt64 inv() const {
+        u64 u = MOD, v = val();
+        if (v == 0) return ModInt64();
+        // a val() = u, b val() = v (mod MOD), |a|, |b| <= MOD
+        i64 a = 0, b = 1;
+        while (v) {
+            const u64 q = u / v;
+            u -= q * v;
+            a -= i64(q) * b;
+            std::swap(u, v);
+            std::swap(a, b);
+        }
+        assert(u == 1);
+        return ModInt64(a);
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const ModInt64& v) {
+        return os << v.val();
+    }
+
+  private:
+    using u128 = unsigned __int128;
+
+    u64 x;
+
+    static constexpr u64 B = (-MOD) % MOD;
+    static constexpr u64 B2 = u64(u128(B) * B % MOD);
+    static constexpr u64 INV = -inv_u64(MOD);
+
+    // Input: (l * r) must be no more than (2^64 * MOD)
+    // Output: ((l * r) / 2^64) % MOD
+    static constexpr u64 mulreduce(u64 l, u64 r) {
+        u128 x = u128(l) * r;
+        x += u128(u64(x) * INV) * MOD;
+        return u64(x >> 64);
+    }
+};
+
+template <typename T> struct is_modint64 : std::false_type {};
+template <u64 MOD> struct is_modint64<ModInt64<MOD>> : std::true_type {};
+
+}  // namespace fastfps
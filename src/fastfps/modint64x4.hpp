@@ -0,0 +1,309 @@
+#pragma once
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <span>
+
+#include "fastfps/math.hpp"
+#include "fastfps/modint64.hpp"
+#include "fastfps/types.hpp"
+
+namespace fastfps {
+
+#ifdef __AVX2__
+
+template <u64 MOD> struct ModInt64x4 {
+    using modint = ModInt64<MOD>;
+    using m256i_u = __m256i_u;
+
+    static_assert(MOD % 2 && MOD <= (u64(1) << 62) - 1,
+                  "mod must be odd and at most 2^62 - 1");
+
+    static constexpr u64 mod() { return MOD; }
+
+    ModInt64x4() : x(_mm256_setzero_si256()) {}
+    ModInt64x4(std::span<const u64, 4> _x)
+        : x(mul(_mm256_loadu_si256((m256i_u*)_x.data()), B2_X)) {}
+    ModInt64x4(std::span<const modint, 4> _x)
+        : x(_mm256_loadu_si256((m256i_u*)_x.data())) {
+        static_assert(sizeof(modint) == 8);
+    }
+    explicit ModInt64x4(modint x0, modint x1, modint x2, modint x3)
+        : x(_mm256_set_epi64x(x3.internal_val(),
+                              x2.internal_val(),
+                              x1.internal_val(),
+                              x0.internal_val())) {}
+
+    static ModInt64x4 set1(modint x) {
+        ModInt64x4 v;
+        v.x = _mm256_set1_epi64x(x.internal_val());
+        return v;
+    }
+
+    std::array<u64, 4> val() const {
+        auto a = mul(x, _mm256_set1_epi64x(1));
+        alignas(32) std::array<u64, 4> b;
+        _mm256_storeu_si256((__m256i_u*)b.data(), reduce(a, MOD_X));
+        return b;
+    }
+
+    ModInt64x4& operator+=(const ModInt64x4& rhs) {
+        x = reduce(_mm256_add_epi64(x, rhs.x), MOD2_X);
+        return *this;
+    }
+    friend ModInt64x4 operator+(const ModInt64x4& lhs, const ModInt64x4& rhs) {
+        return ModInt64x4(lhs) += rhs;
+    }
+
+    ModInt64x4& operator-=(const ModInt64x4& rhs) {
+        x = _mm256_sub_epi64(x, rhs.x);
+        x = _mm256_add_epi64(x, _mm256_and_si256(negative(x), MOD2_X));
+        return *this;
+    }
+    friend ModInt64x4 operator-(const ModInt64x4& lhs, const ModInt64x4& rhs) {
+        return ModInt64x4(lhs) -= rhs;
+    }
+
+    ModInt64x4& operator*=(const ModInt64x4& rhs) {
+        x = mul(x, rhs.x);
+        return *this;
+    }
+    friend ModInt64x4 operator*(const ModInt64x4& lhs, const ModInt64x4& rhs) {
+        return ModInt64x4(lhs) *= rhs;
+    }
+
+    ModInt64x4 operator-() const { return ModInt64x4() - *this; }
+
+    friend bool operator==(const ModInt64x4& lhs, const ModInt64x4& rhs) {
+        auto z = _mm256_xor_si256(reduce(lhs.x, MOD_X), reduce(rhs.x, MOD_X));
+        return _mm256_testz_si256(z, z);
+    }
+
+    // a.permutevar(idx)[i] = a[idx[i] % 4]
+    ModInt64x4 permutevar(const std::array<u32, 4>& idx) const {
+        ModInt64x4 v;
+        v.x = _mm256_permutevar8x32_epi32(
+            x, _mm256_set_epi32(2 * idx[3] + 1, 2 * idx[3], 2 * idx[2] + 1,
+                                2 * idx[2], 2 * idx[1] + 1, 2 * idx[1],
+                                2 * idx[0] + 1, 2 * idx[0]));
+        return v;
+    }
+
+    template <uint8_t MASK>
+    friend ModInt64x4 blend(const ModInt64x4& lhs, const ModInt64x4& rhs) {
+        static_assert(MASK < 16);
+        constexpr int MASK32 = spread(MASK);
+        ModInt64x4 v;
+        v.x = _mm256_blend_epi32(lhs.x, rhs.x, MASK32);
+        return v;
+    }
+
+    friend ModInt64x4 blendvar(const ModInt64x4& lhs,
+                               const ModInt64x4& rhs,
+                               const std::array<u32, 4>& idx) {
+        ModInt64x4 v;
+        v.x = _mm256_blendv_epi8(
+            rhs.x, lhs.x,
+            _mm256_cmpeq_epi64(
+                _mm256_set_epi64x(idx[3], idx[2], idx[1], idx[0]),
+                _mm256_setzero_si256()));
+        return v;
+    }
+
+  private:
+    m256i_u x;
+
+    inline static const m256i_u MOD_X = _mm256_set1_epi64x(MOD);
+    inline static const m256i_u MOD2_X = _mm256_set1_epi64x(2 * MOD);
+    inline static const m256i_u N_INV_X = _mm256_set1_epi64x(-inv_u64(MOD));
+    inline static const m256i_u B2_X =
+        _mm256_set1_epi64x(pow_mod64_constexpr(2, 128, MOD));
+    inline static const m256i_u LOW_X = _mm256_set1_epi64x(0xffffffff);
+
+    // x in [0, 2m) -> [0, m)
+    static m256i_u reduce(const m256i_u& x, const m256i_u& m) {
+        auto y = _mm256_sub_epi64(x, m);
+        return _mm256_blendv_epi8(y, x, negative(y));
+    }
+    // all 1 if x < 0 (as signed)
+    static m256i_u negative(const m256i_u& x) {
+        return _mm256_cmpgt_epi64(_mm256_setzero_si256(), x);
+    }
+
+    // Input: l * r <= 2^64 * MOD
+    // Output: l * r >>= 2^64
+    static m256i_u mul(const m256i_u& l, const m256i_u& r) {
+        m256i_u lo;
+        auto hi = mul_full(l, r, lo);
+        auto m = mul_lo(lo, N_INV_X);
+        auto x = _mm256_add_epi64(hi, mul_hi(m, MOD_X));
+        // carry of lo + lo(m * MOD), which is 2^64 unless lo = 0
+        auto carry = _mm256_add_epi64(
+            _mm256_set1_epi64x(1),
+            _mm256_cmpeq_epi64(lo, _mm256_setzero_si256()));
+        return _mm256_add_epi64(x, carry);
+    }
+
+    // 64 x 64 -> 128 by four 32 x 32 -> 64 products
+    // Output: (l * r) >> 64, lo = (l * r) % 2^64
+    static m256i_u mul_full(const m256i_u& l, const m256i_u& r, m256i_u& lo) {
+        auto lh = _mm256_srli_epi64(l, 32), rh = _mm256_srli_epi64(r, 32);
+        auto p00 = _mm256_mul_epu32(l, r);
+        auto p01 = _mm256_mul_epu32(l, rh);
+        auto p10 = _mm256_mul_epu32(lh, r);
+        auto p11 = _mm256_mul_epu32(lh, rh);
+        auto mid = _mm256_add_epi64(
+            _mm256_add_epi64(_mm256_srli_epi64(p00, 32),
+                             _mm256_and_si256(p01, LOW_X)),
+            _mm256_and_si256(p10, LOW_X));
+        auto hi = _mm256_add_epi64(
+            _mm256_add_epi64(p11, _mm256_srli_epi64(p01, 32)),
+            _mm256_add_epi64(_mm256_srli_epi64(p10, 32),
+                             _mm256_srli_epi64(mid, 32)));
+        lo = _mm256_blend_epi32(p00, _mm256_slli_epi64(mid, 32), 0b10101010);
+        return hi;
+    }
+    // (l * r) % 2^64
+    static m256i_u mul_lo(const m256i_u& l, const m256i_u& r) {
+        auto cross = _mm256_add_epi64(
+            _mm256_mul_epu32(l, _mm256_srli_epi64(r, 32)),
+            _mm256_mul_epu32(_mm256_srli_epi64(l, 32), r));
+        return _mm256_add_epi64(_mm256_mul_epu32(l, r),
+                                _mm256_slli_epi64(cross, 32));
+    }
+    // (l * r) >> 64
+    static m256i_u mul_hi(const m256i_u& l, const m256i_u& r) {
+        m256i_u lo;
+        return mul_full(l, r, lo);
+    }
+
+    static constexpr int spread(uint8_t mask) {
+        int m = 0;
+        for (int i = 0; i < 4; i++) {
+            if (mask & (1 << i)) m |= 0b11 << (2 * i);
+        }
+        return m;
+    }
+};
+
+#else
+
+template <u64 MOD> struct ModInt64x4 {
+    using modint = ModInt64<MOD>;
+
+    static_assert(MOD % 2 && MOD <= (u64(1) << 62) - 1,
+                  "mod must be odd and at most 2^62 - 1");
+
+    static constexpr u64 mod() { return MOD; }
+
+    ModInt64x4() : x({}) {}
+    ModInt64x4(std::span<const u64, 4> _x) {
+        for (int i = 0; i < 4; i++) {
+            x[i] = _x[i];
+        }
+    }
+    ModInt64x4(std::span<const modint, 4> _x) {
+        for (int i = 0; i < 4; i++) {
+            x[i] = _x[i];
+        }
+    }
+    explicit ModInt64x4(modint x0, modint x1, modint x2, modint x3)
+        : x({x0, x1, x2, x3}) {}
+
+    static ModInt64x4 set1(modint x) { return ModInt64x4(x, x, x, x); }
+
+    std::array<u64, 4> val() const {
+        std::array<u64, 4> b;
+        for (int i = 0; i < 4; i++) {
+            b[i] = x[i].val();
+        }
+        return b;
+    }
+
+    ModInt64x4& operator+=(const ModInt64x4& rhs) {
+        for (int i = 0; i < 4; i++) {
+            x[i] += rhs.x[i];
+        }
+        return *this;
+    }
+    friend ModInt64x4 operator+(const ModInt64x4& lhs, const ModInt64x4& rhs) {
+        return ModInt64x4(lhs) += rhs;
+    }
+
+    ModInt64x4& operator-=(const ModInt64x4& rhs) {
+        for (int i = 0; i < 4; i++) {
+            x[i] -= rhs.x[i];
+        }
+        return *this;
+    }
+    friend ModInt64x4 operator-(const ModInt64x4& lhs, const ModInt64x4& rhs) {
+        return ModInt64x4(lhs) -= rhs;
+    }
+
+    ModInt64x4& operator*=(const ModInt64x4& rhs) {
+        for (int i = 0; i < 4; i++) {
+            x[i] *= rhs.x[i];
+        }
+        return *this;
+    }
+    friend ModInt64x4 operator*(const ModInt64x4& lhs, const ModInt64x4& rhs) {
+        return ModInt64x4(lhs) *= rhs;
+    }
+
+    ModInt64x4 operator-() const { return ModInt64x4() - *this; }
+
+    friend bool operator==(const ModInt64x4& lhs, const ModInt64x4& rhs) {
+        return lhs.x == rhs.x;
+    }
+
+    // a.permutevar(idx)[i] = a[idx[i] % 4]
+    ModInt64x4 permutevar(const std::array<u32, 4>& idx) const {
+        ModInt64x4 v;
+        for (int i = 0; i < 4; i++) {
+            v.x[i] = x[idx[i] % 4];
+        }
+        return v;
+    }
+
+    template <uint8_t MASK>
+    friend ModInt64x4 blend(const ModInt64x4& lhs, const ModInt64x4& rhs) {
+        ModInt64x4 v;
+        for (int i = 0; i < 4; i++) {
+            if (MASK & (1u << i)) {
+                v.x[i] = rhs.x[i];
+            } else {
+                v.x[i] = lhs.x[i];
+            }
+        }
+        return v;
+    }
+
+    friend ModInt64x4 blendvar(const ModInt64x4& lhs,
+                               const ModInt64x4& rhs,
+                               const std::array<u32, 4>& idx) {
+        ModInt64x4 v;
+        for (int i = 0; i < 4; i++) {
+            if (idx[i]) {
+                v.x[i] = rhs.x[i];
+            } else {
+                v.x[i] = lhs.x[i];
+            }
+        }
+        return v;
+    }
+
+  private:
+    std::array<modint, 4> x;
+};
+
+#endif
+
+template <typename T> struct is_modint64x4 : std::false_type {};
+template <u64 MOD> struct is_modint64x4<ModInt64x4<MOD>> : std::true_type {};
+
+}  // namespace fastfps
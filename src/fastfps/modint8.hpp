@@ -15,6 +15,14 @@
 
 namespace fastfps {
 
+// orders the preceding non-temporal stores (ModInt8::stream) before the
+// following stores
+inline void stream_fence() {
+#ifdef __AVX2__
+    _mm_sfence();
+#endif
+}
+
 #ifdef __AVX2__
 
 template <u32 MOD> struct ModInt8 {
@@ -64,6 +72,16 @@ template <u32 MOD> struct ModInt8 {
         return v;
     }
 
+    // a[i] = base[idx[i]]
+    static ModInt8 gather(std::span<const modint> base,
+                       std::span<const u32, 8> idx) {
+        ModInt8 v;
+        v.x = _mm256_i32gather_epi32(
+            (const int*)base.data(),
+            _mm256_loadu_si256((const m256i_u*)idx.data()), 4);
+        return v;
+    }
+
     std::array<u32, 8> val() const {
         auto a = mul(x, _mm256_set1_epi32(1));
         alignas(32) std::array<u32, 8> b;
@@ -72,6 +90,56 @@ template <u32 MOD> struct ModInt8 {
         return b;
     }
 
+    // dst = this, as ModInt (the inverse of the span<const modint> ctor)
+    void store(std::span<modint, 8> dst) const {
+        _mm256_storeu_si256((m256i_u*)dst.data(), x);
+    }
+    // *dst = *this by a non-temporal store, which bypasses the caches.
+    // dst must be 32-byte aligned, see also stream_fence().
+    void stream(ModInt8* dst) const {
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dst), x);
+    }
+
+    // the same values with the internal lanes in [0, MOD)
+    ModInt8 normalized() const {
+        ModInt8 v;
+        v.x = min(x, _mm256_sub_epi32(x, MOD_X));
+        return v;
+    }
+
+    // Sum of up to TERMS products l r with a scalar l, accumulated in 64-bit
+    // lanes and Montgomery-reduced once by get(). l and the lanes of r must
+    // be normalized: then the sum is below 8 MOD^2 and the reduction
+    // (+ 2^32 MOD at most) stays below 2^64 as unsigned lanes (but not below
+    // 2^63, so the lanes are added by _mm256_add_epi64, not by signed +).
+    struct LazySum {
+        static constexpr int TERMS = 8;
+
+        void add(modint l, const ModInt8& r) {
+            const auto lx = _mm256_set1_epi32(l.internal_val());
+            even = _mm256_add_epi64(even, mul_even(lx, r.x));
+            odd = _mm256_add_epi64(
+                odd, mul_even(lx, _mm256_shuffle_epi32(r.x, 0xf5)));
+        }
+        // < 8 MOD^2 / 2^32 + MOD < 3 MOD, then < 2 MOD
+        ModInt8 get() const {
+            ModInt8 v;
+            v.x = _mm256_blend_epi32(_mm256_srli_epi64(reduce(even), 32),
+                                     reduce(odd), 0b10101010);
+            v.x = min(v.x, _mm256_sub_epi32(v.x, MOD2_X));
+            return v;
+        }
+
+      private:
+        m256i_u even = _mm256_setzero_si256(), odd = _mm256_setzero_si256();
+
+        // t + (t N mod 2^32) MOD, whose high halves are t / 2^32 (mod MOD)
+        static m256i_u reduce(const m256i_u& t) {
+            return _mm256_add_epi64(
+                t, mul_even(mul_even(t, N_INV_X), MOD_X));
+        }
+    };
+
     ModInt8& operator+=(const ModInt8& rhs) {
         x = _mm256_add_epi32(x, rhs.x);
         x = min(x, _mm256_sub_epi32(x, MOD2_X));
@@ -137,6 +205,25 @@ template <u32 MOD> struct ModInt8 {
         return v;
     }
 
+    // a[i] <- (a[0][i], a[1][i], ..., a[7][i])
+    static void transpose(std::array<ModInt8, 8>& a) {
+        m256i_u t[8], u[8];
+        for (int i = 0; i < 4; i++) {
+            t[2 * i] = _mm256_unpacklo_epi32(a[2 * i].x, a[2 * i + 1].x);
+            t[2 * i + 1] = _mm256_unpackhi_epi32(a[2 * i].x, a[2 * i + 1].x);
+        }
+        for (int i = 0; i < 2; i++) {
+            u[4 * i + 0] = _mm256_unpacklo_epi64(t[4 * i], t[4 * i + 2]);
+            u[4 * i + 1] = _mm256_unpackhi_epi64(t[4 * i], t[4 * i + 2]);
+            u[4 * i + 2] = _mm256_unpacklo_epi64(t[4 * i + 1], t[4 * i + 3]);
+            u[4 * i + 3] = _mm256_unpackhi_epi64(t[4 * i + 1], t[4 * i + 3]);
+        }
+        for (int i = 0; i < 4; i++) {
+            a[i].x = _mm256_permute2x128_si256(u[i], u[i + 4], 0x20);
+            a[i + 4].x = _mm256_permute2x128_si256(u[i], u[i + 4], 0x31);
+        }
+    }
+
   private:
     m256i_u x;
 
@@ -218,6 +305,16 @@ template <u32 MOD> struct ModInt8 {
 
     static ModInt8 set1(modint x) { return ModInt8(x, x, x, x, x, x, x, x); }
 
+    // a[i] = base[idx[i]]
+    static ModInt8 gather(std::span<const modint> base,
+                       std::span<const u32, 8> idx) {
+        ModInt8 v;
+        for (int i = 0; i < 8; i++) {
+            v.x[i] = base[idx[i]];
+        }
+        return v;
+    }
+
     std::array<u32, 8> val() const {
         std::array<u32, 8> b;
         for (int i = 0; i < 8; i++) {
@@ -226,6 +323,31 @@ template <u32 MOD> struct ModInt8 {
         return b;
     }
 
+    // dst = this, as ModInt (the inverse of the span<const modint> ctor)
+    void store(std::span<modint, 8> dst) const {
+        std::ranges::copy(x, dst.begin());
+    }
+    // *dst = *this (a non-temporal store with AVX2)
+    void stream(ModInt8* dst) const { *dst = *this; }
+
+    // the same values (the internal lanes are only normalized with AVX2)
+    ModInt8 normalized() const { return *this; }
+
+    // Sum of up to TERMS products l r with a scalar l (see the AVX2 version)
+    struct LazySum {
+        static constexpr int TERMS = 8;
+
+        void add(modint l, const ModInt8& r) {
+            for (int i = 0; i < 8; i++) {
+                s[i] += l * r.x[i];
+            }
+        }
+        ModInt8 get() const { return ModInt8(std::span<const modint, 8>(s)); }
+
+      private:
+        std::array<modint, 8> s{};
+    };
+
     ModInt8& operator+=(const ModInt8& rhs) {
         for (int i = 0; i < 8; i++) {
             x[i] += rhs.x[i];
@@ -309,6 +431,15 @@ template <u32 MOD> struct ModInt8 {
         return v;
     }
 
+    // a[i] <- (a[0][i], a[1][i], ..., a[7][i])
+    static void transpose(std::array<ModInt8, 8>& a) {
+        for (int i = 0; i < 8; i++) {
+            for (int j = 0; j < i; j++) {
+                std::swap(a[i].x[j], a[j].x[i]);
+            }
+        }
+    }
+
   private:
     std::array<modint, 8> x;
 };
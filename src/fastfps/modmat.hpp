@@ -0,0 +1,214 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <iostream>
+#include <ranges>
+#include <span>
+#include <vector>
+
+#include "fastfps/fft.hpp"
+#include "fastfps/modint.hpp"
+#include "fastfps/modint8.hpp"
+#include "fastfps/modvec.hpp"
+
+namespace fastfps {
+
+// v[i] = first[i * stride] (0 <= i < n) as a random access range
+template <class T> auto strided_view(T* first, ssize_t stride, ssize_t n) {
+    return std::views::iota(ssize_t(0), n) |
+           std::views::transform(
+               [first, stride](ssize_t i) -> T& { return first[i * stride]; });
+}
+
+// bivariate polynomial sum a[i][j] x^i y^j (0 <= i < height, 0 <= j < width)
+template <class _modint8> struct BasicModMat {
+    using modint8 = _modint8;
+    using modint = typename modint8::modint;
+
+  public:
+    BasicModMat() : h(0), w(0), v() {}
+    BasicModMat(ssize_t _h, ssize_t _w) : h(_h), w(_w), v(h * vsize(w)) {}
+    BasicModMat(const std::vector<std::vector<u32>>& _v)
+        : h(std::ssize(_v)), w(h ? std::ssize(_v[0]) : 0), v(h * vsize(w)) {
+        const ssize_t wb = vsize(w);
+        for (int i = 0; i < h; i++) {
+            assert(std::ssize(_v[i]) == w);
+            for (int j = 0; j < wb; j++) {
+                std::array<u32, 8> buf{};
+                for (int k = 0; k < 8 && (j * 8 + k) < w; k++) {
+                    buf[k] = _v[i][j * 8 + k];
+                }
+                v[i * wb + j] = modint8(buf);
+            }
+        }
+    }
+
+    ssize_t height() const { return h; }
+    ssize_t width() const { return w; }
+
+    std::vector<std::vector<u32>> val() const {
+        std::vector<std::vector<u32>> _v(h, std::vector<u32>(w));
+        const ssize_t wb = vsize(w);
+        for (int i = 0; i < h; i++) {
+            for (int j = 0; j < wb; j++) {
+                std::array<u32, 8> buf = v[i * wb + j].val();
+                for (int k = 0; k < 8 && (j * 8 + k) < w; k++) {
+                    _v[i][j * 8 + k] = buf[k];
+                }
+            }
+        }
+        return _v;
+    }
+    u32 val(ssize_t i, ssize_t j) const {
+        if (i < 0 || h <= i || j < 0 || w <= j) return 0;
+        return v[i * vsize(w) + j / 8].val()[j % 8];
+    }
+
+    void resize(ssize_t _h, ssize_t _w) {
+        BasicModMat res(_h, _w);
+        const ssize_t wb = vsize(w), wb2 = vsize(_w);
+        for (int i = 0; i < std::min(h, _h); i++) {
+            std::copy_n(v.begin() + i * wb, std::min(wb, wb2),
+                        res.v.begin() + i * wb2);
+        }
+        res.clear_last();
+        *this = std::move(res);
+    }
+
+    BasicModMat& operator+=(const BasicModMat& rhs) {
+        if (h < rhs.h || w < rhs.w) {
+            resize(std::max(h, rhs.h), std::max(w, rhs.w));
+        }
+        const ssize_t wb = vsize(w), rwb = vsize(rhs.w);
+        for (int i = 0; i < rhs.h; i++) {
+            for (int j = 0; j < rwb; j++) {
+                v[i * wb + j] += rhs.v[i * rwb + j];
+            }
+        }
+        return *this;
+    }
+    friend BasicModMat operator+(const BasicModMat& lhs,
+                                 const BasicModMat& rhs) {
+        return BasicModMat(lhs) += rhs;
+    }
+
+    BasicModMat& operator-=(const BasicModMat& rhs) {
+        if (h < rhs.h || w < rhs.w) {
+            resize(std::max(h, rhs.h), std::max(w, rhs.w));
+        }
+        const ssize_t wb = vsize(w), rwb = vsize(rhs.w);
+        for (int i = 0; i < rhs.h; i++) {
+            for (int j = 0; j < rwb; j++) {
+                v[i * wb + j] -= rhs.v[i * rwb + j];
+            }
+        }
+        return *this;
+    }
+    friend BasicModMat operator-(const BasicModMat& lhs,
+                                 const BasicModMat& rhs) {
+        return BasicModMat(lhs) -= rhs;
+    }
+
+    friend bool operator==(const BasicModMat& lhs, const BasicModMat& rhs) {
+        return lhs.h == rhs.h && lhs.w == rhs.w && lhs.v == rhs.v;
+    }
+
+    // 2-D convolution: fft of each row, then fft_lanes of each column of
+    // blocks (8 columns at once) through a strided view
+    BasicModMat& operator*=(const BasicModMat& rhs) {
+        if (h == 0 || w == 0 || rhs.h == 0 || rhs.w == 0) {
+            *this = BasicModMat();
+            return *this;
+        }
+        const ssize_t nh = h + rhs.h - 1, nw = w + rhs.w - 1;
+        const ssize_t p = (ssize_t)std::bit_ceil((size_t)nh);
+        const ssize_t q = (ssize_t)std::bit_ceil((size_t)vsize(nw));
+
+        auto fa = transform(p, q), fb = rhs.transform(p, q);
+        for (int i = 0; i < p * q; i++) {
+            fa[i] *= fb[i];
+        }
+        for (int j = 0; j < q; j++) {
+            ifft_lanes(strided_view(fa.data() + j, q, p));
+        }
+        for (int i = 0; i < nh; i++) {
+            ifft(std::span<modint8>(fa.data() + i * q, q));
+        }
+
+        h = nh;
+        w = nw;
+        const ssize_t wb = vsize(w);
+        v.resize(h * wb);
+        const modint8 inv = modint8::set1(modint(8 * p * q).inv());
+        for (int i = 0; i < h; i++) {
+            for (int j = 0; j < wb; j++) {
+                v[i * wb + j] = fa[i * q + j] * inv;
+            }
+        }
+        clear_last();
+        return *this;
+    }
+    friend BasicModMat operator*(const BasicModMat& lhs,
+                                 const BasicModMat& rhs) {
+        return BasicModMat(lhs) *= rhs;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const BasicModMat& r) {
+        auto r2 = r.val();
+
+        os << "[";
+        for (int i = 0; i < std::ssize(r2); i++) {
+            if (i) os << ", ";
+            os << "[";
+            for (int j = 0; j < std::ssize(r2[i]); j++) {
+                if (j) os << ", ";
+                os << r2[i][j];
+            }
+            os << "]";
+        }
+        return os << "]";
+    }
+
+  private:
+    ssize_t h, w;
+    // row i is v[i * vsize(w), (i + 1) * vsize(w))
+    std::vector<modint8> v;
+
+    static ssize_t vsize(ssize_t n) { return (n + 7) / 8; }
+
+    // 2-D fft in the (p x 8q) grid
+    std::vector<modint8> transform(ssize_t p, ssize_t q) const {
+        const ssize_t wb = vsize(w);
+        std::vector<modint8> f(p * q);
+        for (int i = 0; i < h; i++) {
+            std::copy_n(v.begin() + i * wb, wb, f.begin() + i * q);
+            fft(std::span<modint8>(f.data() + i * q, q));
+        }
+        for (int j = 0; j < q; j++) {
+            fft_lanes(strided_view(f.data() + j, q, p));
+        }
+        return f;
+    }
+
+    void clear_last() {
+        if (w % 8 == 0) return;
+        const ssize_t wb = vsize(w);
+        const auto mask = [&]() {
+            std::array<u32, 8> b;
+            for (int i = 0; i < 8; i++) {
+                b[i] = ((w % 8) <= i);
+            }
+            return b;
+        }();
+        for (int i = 0; i < h; i++) {
+            v[i * wb + wb - 1] = blendvar(v[i * wb + wb - 1], modint8(), mask);
+        }
+    }
+};
+
+template <int MOD> using ModMat = BasicModMat<ModInt8<MOD>>;
+
+}  // namespace fastfps
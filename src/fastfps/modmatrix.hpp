@@ -0,0 +1,427 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <iostream>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "fastfps/allocator.hpp"
+#include "fastfps/dynmodint8.hpp"
+#include "fastfps/modint.hpp"
+#include "fastfps/modint8.hpp"
+#include "fastfps/modvec.hpp"
+#include "fastfps/types.hpp"
+
+namespace fastfps {
+
+// dense h x w matrix over modint (the elimination needs a prime modulus)
+//
+// Row i is stored as the blocks v[i * wb, (i + 1) * wb) with
+// wb = vsize(w), and the lanes beyond w are zero.
+template <class _modint8> struct BasicModMatrix {
+    using modint8 = _modint8;
+    using modint = typename modint8::modint;
+    using modvec = BasicModVec<modint8>;
+
+  public:
+    BasicModMatrix() : h(0), w(0), wb(0), v() {}
+    BasicModMatrix(ssize_t _h, ssize_t _w)
+        : h(_h), w(_w), wb(vsize(_w)), v(h * wb) {}
+    BasicModMatrix(const std::vector<std::vector<u32>>& _v)
+        : BasicModMatrix(std::ssize(_v), _v.empty() ? 0 : std::ssize(_v[0])) {
+        for (ssize_t i = 0; i < h; i++) {
+            assert(std::ssize(_v[i]) == w);
+            for (ssize_t j = 0; j < wb; j++) {
+                std::array<u32, 8> buf{};
+                for (ssize_t k = 0; k < 8 && j * 8 + k < w; k++) {
+                    buf[k] = _v[i][j * 8 + k];
+                }
+                v[i * wb + j] = modint8(buf);
+            }
+        }
+    }
+
+    static BasicModMatrix identity(ssize_t n) {
+        BasicModMatrix a(n, n);
+        for (ssize_t i = 0; i < n; i++) a.set(i, i, modint(1));
+        return a;
+    }
+
+    ssize_t height() const { return h; }
+    ssize_t width() const { return w; }
+
+    std::vector<std::vector<u32>> val() const {
+        std::vector<std::vector<u32>> _v(h, std::vector<u32>(w));
+        for (ssize_t i = 0; i < h; i++) {
+            for (ssize_t j = 0; j < wb; j++) {
+                const std::array<u32, 8> buf = v[i * wb + j].val();
+                for (ssize_t k = 0; k < 8 && j * 8 + k < w; k++) {
+                    _v[i][j * 8 + k] = buf[k];
+                }
+            }
+        }
+        return _v;
+    }
+    u32 val(ssize_t i, ssize_t j) const {
+        if (i < 0 || h <= i || j < 0 || w <= j) return 0;
+        return get(i, j).val();
+    }
+
+    BasicModMatrix& operator+=(const BasicModMatrix& rhs) {
+        assert(h == rhs.h && w == rhs.w);
+        for (ssize_t i = 0; i < std::ssize(v); i++) v[i] += rhs.v[i];
+        return *this;
+    }
+    friend BasicModMatrix operator+(const BasicModMatrix& lhs,
+                                    const BasicModMatrix& rhs) {
+        return BasicModMatrix(lhs) += rhs;
+    }
+
+    BasicModMatrix& operator-=(const BasicModMatrix& rhs) {
+        assert(h == rhs.h && w == rhs.w);
+        for (ssize_t i = 0; i < std::ssize(v); i++) v[i] -= rhs.v[i];
+        return *this;
+    }
+    friend BasicModMatrix operator-(const BasicModMatrix& lhs,
+                                    const BasicModMatrix& rhs) {
+        return BasicModMatrix(lhs) -= rhs;
+    }
+
+    // C = A B
+    //
+    // B is packed by column blocks with normalized lanes, and a kernel of 4
+    // rows of A accumulates LazySum::TERMS products per Montgomery reduction.
+    // For KC rows of B at a time, 4 x KC of A stay in L1 over all column
+    // blocks, and the packed B (KC x w) in L2 over all rows of A.
+    friend BasicModMatrix operator*(const BasicModMatrix& lhs,
+                                    const BasicModMatrix& rhs) {
+        assert(lhs.w == rhs.h);
+        const ssize_t n = lhs.h, k = lhs.w, mb = rhs.wb;
+        if (n == 0 || k == 0 || mb == 0) return BasicModMatrix(n, rhs.w);
+        // the kernel takes 4 rows, so c and a have n4 >= n rows
+        const ssize_t n4 = (n + 3) / 4 * 4;
+        BasicModMatrix c(n4, rhs.w);
+
+        Workspace::Frame frame;
+        // a[i * as + l] = lhs[i][l], bp[j * k + l] = rhs[l][8j, 8j + 8)
+        const ssize_t as = 8 * lhs.wb;
+        auto a = frame.alloc<modint>(n4 * as);
+        for (ssize_t i = 0; i < n * lhs.wb; i++) {
+            lhs.v[i].normalized().store(
+                a.subspan(8 * i).template first<8>());
+        }
+        auto bp = frame.alloc<modint8>(mb * k);
+        for (ssize_t l = 0; l < k; l++) {
+            for (ssize_t j = 0; j < mb; j++) {
+                bp[j * k + l] = rhs.v[l * mb + j].normalized();
+            }
+        }
+
+        constexpr ssize_t KC = 128;
+        for (ssize_t l0 = 0; l0 < k; l0 += KC) {
+            const ssize_t len = std::min(KC, k - l0);
+            for (ssize_t i = 0; i < n4; i += 4) {
+                for (ssize_t j = 0; j < mb; j++) {
+                    mul_kernel(a.data() + i * as + l0, as,
+                               bp.data() + j * k + l0, len,
+                               c.v.data() + i * mb + j, mb);
+                }
+            }
+        }
+        c.h = n;
+        c.v.resize(n * mb);
+        return c;
+    }
+    BasicModMatrix& operator*=(const BasicModMatrix& rhs) {
+        return *this = *this * rhs;
+    }
+
+    friend bool operator==(const BasicModMatrix& lhs,
+                           const BasicModMatrix& rhs) {
+        return lhs.h == rhs.h && lhs.w == rhs.w && lhs.v == rhs.v;
+    }
+
+    // A^k
+    BasicModMatrix pow(u64 k) const {
+        assert(h == w);
+        BasicModMatrix r = identity(h), x = *this;
+        while (k) {
+            if (k & 1) r *= x;
+            k >>= 1;
+            if (k) x *= x;
+        }
+        return r;
+    }
+
+    modint det() const {
+        assert(h == w);
+        BasicModMatrix a(*this);
+        const auto e = a.eliminate(w, false);
+        return std::ssize(e.pivots) == h ? e.det : modint(0);
+    }
+
+    ssize_t rank() const {
+        BasicModMatrix a(*this);
+        return std::ssize(a.eliminate(w, false).pivots);
+    }
+
+    // A^-1, if A is regular
+    std::optional<BasicModMatrix> inv() const {
+        assert(h == w);
+        // [A | I], with I from the column 8 wb to keep it block aligned
+        BasicModMatrix a(h, 8 * wb + w);
+        for (ssize_t i = 0; i < h; i++) {
+            std::ranges::copy(row(i), a.row(i).begin());
+            a.set(i, 8 * wb + i, modint(1));
+        }
+        if (std::ssize(a.eliminate(w, true).pivots) < h) return std::nullopt;
+        BasicModMatrix r(h, w);
+        for (ssize_t i = 0; i < h; i++) {
+            std::ranges::copy(a.row(i).subspan(wb), r.row(i).begin());
+        }
+        return r;
+    }
+
+    // x with A x = b, if any (the free variables are 0)
+    std::optional<std::vector<u32>> solve(const std::vector<u32>& b) const {
+        assert(std::ssize(b) == h);
+        BasicModMatrix a(h, 8 * wb + 1);
+        for (ssize_t i = 0; i < h; i++) {
+            std::ranges::copy(row(i), a.row(i).begin());
+            a.set(i, 8 * wb, modint(b[i]));
+        }
+        const auto e = a.eliminate(w, true);
+        const ssize_t r = std::ssize(e.pivots);
+        for (ssize_t i = r; i < h; i++) {
+            if (a.get(i, 8 * wb) != modint(0)) return std::nullopt;
+        }
+        std::vector<u32> x(w);
+        for (ssize_t i = 0; i < r; i++) {
+            x[e.pivots[i]] = a.get(i, 8 * wb).val();
+        }
+        return x;
+    }
+
+    // det(x I - A)
+    //
+    // A is reduced to the upper Hessenberg form H by similarity transforms,
+    // and p_k = det(x I - H[0, k)[0, k)) satisfies
+    //   p_{k+1} = (x - h[k][k]) p_k
+    //             - sum_{i < k} h[i][k] h[i+1][i] ... h[k][k-1] p_i.
+    modvec charpoly() const {
+        assert(h == w);
+        const ssize_t n = h;
+        BasicModMatrix a(*this);
+        a.hessenberg();
+
+        std::vector<modint> hs(n * n);
+        for (ssize_t i = 0; i < n; i++) {
+            for (ssize_t j = std::max<ssize_t>(0, i - 1); j < n; j++) {
+                hs[i * n + j] = a.get(i, j);
+            }
+        }
+        // p[k] = p_k in nb blocks
+        const ssize_t nb = vsize(n + 1);
+        std::vector<std::vector<modint8>> p(n + 1,
+                                            std::vector<modint8>(nb));
+        p[0][0] = modint8(modint(1), modint(), modint(), modint(), modint(),
+                          modint(), modint(), modint());
+        for (ssize_t k = 0; k < n; k++) {
+            const ssize_t kb = vsize(k + 2);
+            auto& q = p[k + 1];
+            // x p_k
+            modint8 prev;
+            for (ssize_t b = 0; b < kb; b++) {
+                const modint8 cur = p[k][b].rotate(7);
+                q[b] = blend<0b00000001>(cur, prev);
+                prev = cur;
+            }
+            axpy(q, modint(0) - hs[k * n + k], p[k], kb);
+            modint t(1);
+            for (ssize_t i = k - 1; i >= 0; i--) {
+                t *= hs[(i + 1) * n + i];
+                if (t == modint(0)) break;
+                axpy(q, modint(0) - hs[i * n + k] * t, p[i], vsize(i + 1));
+            }
+        }
+        modvec r(n + 1);
+        std::ranges::copy(p[n], r.blocks().begin());
+        return r;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os,
+                                    const BasicModMatrix& r) {
+        auto r2 = r.val();
+
+        os << "[";
+        for (int i = 0; i < std::ssize(r2); i++) {
+            if (i) os << ", ";
+            os << "[";
+            for (int j = 0; j < std::ssize(r2[i]); j++) {
+                if (j) os << ", ";
+                os << r2[i][j];
+            }
+            os << "]";
+        }
+        return os << "]";
+    }
+
+  private:
+    ssize_t h, w, wb;
+    std::vector<modint8, AlignedAllocator<modint8>> v;
+
+    static ssize_t vsize(ssize_t n) { return (n + 7) / 8; }
+
+    std::span<modint8> row(ssize_t i) {
+        return {v.data() + i * wb, size_t(wb)};
+    }
+    std::span<const modint8> row(ssize_t i) const {
+        return {v.data() + i * wb, size_t(wb)};
+    }
+
+    modint get(ssize_t i, ssize_t j) const {
+        std::array<modint, 8> b;
+        v[i * wb + j / 8].store(b);
+        return b[j % 8];
+    }
+    void set(ssize_t i, ssize_t j, modint x) {
+        std::array<modint, 8> b;
+        modint8& block = v[i * wb + j / 8];
+        block.store(b);
+        b[j % 8] = x;
+        block = modint8(b);
+    }
+
+    void swap_rows(ssize_t i, ssize_t j) {
+        std::swap_ranges(row(i).begin(), row(i).end(), row(j).begin());
+    }
+    void swap_cols(ssize_t i, ssize_t j) {
+        for (ssize_t k = 0; k < h; k++) {
+            const modint x = get(k, i);
+            set(k, i, get(k, j));
+            set(k, j, x);
+        }
+    }
+
+    // y[0, len) += c x[0, len)
+    static void axpy(std::span<modint8> y,
+                     modint c,
+                     std::span<const modint8> x,
+                     ssize_t len) {
+        const modint8 c8 = modint8::set1(c);
+        for (ssize_t b = 0; b < len; b++) y[b] += c8 * x[b];
+    }
+
+    // c[r * cs] += sum_{l < len} a[r * as + l] b[l] (r < 4)
+    static void mul_kernel(const modint* a,
+                           ssize_t as,
+                           const modint8* b,
+                           ssize_t len,
+                           modint8* c,
+                           ssize_t cs) {
+        using LazySum = typename modint8::LazySum;
+        for (ssize_t l0 = 0; l0 < len; l0 += LazySum::TERMS) {
+            const ssize_t l1 = std::min<ssize_t>(len, l0 + LazySum::TERMS);
+            LazySum s0, s1, s2, s3;
+            for (ssize_t l = l0; l < l1; l++) {
+                s0.add(a[l], b[l]);
+                s1.add(a[as + l], b[l]);
+                s2.add(a[2 * as + l], b[l]);
+                s3.add(a[3 * as + l], b[l]);
+            }
+            c[0] += s0.get();
+            c[cs] += s1.get();
+            c[2 * cs] += s2.get();
+            c[3 * cs] += s3.get();
+        }
+    }
+
+    struct Echelon {
+        // the pivot column of each row
+        std::vector<ssize_t> pivots;
+        // the product of the pivots, negated for each row swap
+        modint det;
+    };
+    // Gaussian elimination of the columns [0, cols) into the row echelon
+    // form with unit pivots. With jordan, the entries above the pivots are
+    // cleared as well (the reduced row echelon form).
+    Echelon eliminate(ssize_t cols, bool jordan) {
+        Echelon e{{}, modint(1)};
+        ssize_t r = 0;
+        for (ssize_t c = 0; c < cols && r < h; c++) {
+            ssize_t p = r;
+            while (p < h && get(p, c) == modint(0)) p++;
+            if (p == h) continue;
+            if (p != r) {
+                swap_rows(p, r);
+                e.det = modint(0) - e.det;
+            }
+            const modint x = get(r, c);
+            e.det *= x;
+            const ssize_t b0 = c / 8;
+            const auto pr = row(r).subspan(b0);
+            const modint8 xi = modint8::set1(x.inv());
+            for (auto& y : pr) y *= xi;
+            for (ssize_t i = jordan ? 0 : r + 1; i < h; i++) {
+                if (i == r) continue;
+                const modint f = get(i, c);
+                if (f == modint(0)) continue;
+                axpy(row(i).subspan(b0), modint(0) - f, pr, wb - b0);
+            }
+            e.pivots.push_back(c);
+            r++;
+        }
+        return e;
+    }
+
+    // similarity transforms into the upper Hessenberg form
+    // (a[i][j] = 0 for i > j + 1)
+    void hessenberg() {
+        const ssize_t n = h;
+        std::vector<modint> f(8 * wb);
+        for (ssize_t c = 0; c + 2 < n; c++) {
+            ssize_t p = c + 1;
+            while (p < n && get(p, c) == modint(0)) p++;
+            if (p == n) continue;
+            if (p != c + 1) {
+                swap_rows(p, c + 1);
+                swap_cols(p, c + 1);
+            }
+            // row i -= f[i] row c+1 (i > c + 1), which is L A with
+            // L = I - sum f[i] e_i e_{c+1}^T. Then A L^-1 is
+            // column c+1 += sum f[i] column i.
+            const modint x = get(c + 1, c).inv();
+            const ssize_t b0 = c / 8, f0 = (c + 2) / 8;
+            std::ranges::fill(f, modint(0));
+            for (ssize_t i = c + 2; i < n; i++) {
+                f[i] = get(i, c) * x;
+                if (f[i] == modint(0)) continue;
+                axpy(row(i).subspan(b0), modint(0) - f[i],
+                     row(c + 1).subspan(b0), wb - b0);
+            }
+            std::vector<modint8> f8(wb);
+            for (ssize_t b = f0; b < wb; b++) {
+                f8[b] = modint8(std::span<const modint>(f).subspan(8 * b)
+                                    .template first<8>());
+            }
+            for (ssize_t k = 0; k < n; k++) {
+                const auto rk = row(k);
+                modint8 s;
+                for (ssize_t b = f0; b < wb; b++) s += rk[b] * f8[b];
+                std::array<modint, 8> t;
+                s.store(t);
+                modint y = get(k, c + 1);
+                for (const auto& z : t) y += z;
+                set(k, c + 1, y);
+            }
+        }
+    }
+};
+
+template <int MOD> using ModMatrix = BasicModMatrix<ModInt8<MOD>>;
+template <int id> using DynModMatrix = BasicModMatrix<DynModInt8<id>>;
+
+}  // namespace fastfps
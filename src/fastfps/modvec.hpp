@@ -1,23 +1,44 @@
 #pragma once
 
 #include <algorithm>
+#include <bit>
+#include <cassert>
 #include <random>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "fastfps/allocator.hpp"
+#include "fastfps/composition.hpp"
+#include "fastfps/dynmodint.hpp"
+#include "fastfps/dynmodint8.hpp"
+#include "fastfps/factorial.hpp"
 #include "fastfps/fft.hpp"
 #include "fastfps/modint.hpp"
 #include "fastfps/modint8.hpp"
+#include "fastfps/modvec_expr.hpp"
+#include "fastfps/modvec_view.hpp"
+#include "fastfps/sparse_modvec.hpp"
+#include "fastfps/stats.hpp"
 
 namespace fastfps {
 
-template <int MOD> struct ModVec {
-    using modint = ModInt<MOD>;
-    using modint8 = ModInt8<MOD>;
+// a ModVec file mapped in memory; save_modvec / map_modvec / load_modvec
+// are in modvec_file.hpp (POSIX), which is included separately
+template <class _modint8> class BasicMappedModVec;
+
+template <class _modint8> struct BasicModVec {
+    using modint8 = _modint8;
+    using modint = typename modint8::modint;
+    using view_type = BasicModVecView<modint8>;
 
   public:
-    ModVec() : n(0), v() {}
-    explicit ModVec(ssize_t _n) : n(_n), v(vsize(_n)) {}
-    ModVec(std::initializer_list<u32> li) : n(ssize(li)), v(vsize(n)) {
+    BasicModVec() : n(0), v() {}
+    explicit BasicModVec(ssize_t _n) : n(_n), v(vsize(_n)) {}
+    BasicModVec(std::initializer_list<u32> li) : n(ssize(li)), v(vsize(n)) {
+        FASTFPS_STATS_SCOPE(CONVERT, n);
         auto it = li.begin();
         for (int i = 0; i < ssize(v); i++) {
             std::array<u32, 8> buf = {};
@@ -28,7 +49,8 @@ template <int MOD> struct ModVec {
             v[i] = modint8(buf);
         }
     }
-    ModVec(std::initializer_list<i32> li) : n(ssize(li)), v(vsize(n)) {
+    BasicModVec(std::initializer_list<i32> li) : n(ssize(li)), v(vsize(n)) {
+        FASTFPS_STATS_SCOPE(CONVERT, n);
         auto it = li.begin();
         for (int i = 0; i < ssize(v); i++) {
             std::array<i32, 8> buf = {};
@@ -40,7 +62,9 @@ template <int MOD> struct ModVec {
         }
     }
 
-    ModVec(const std::vector<modint>& _v) : n(std::ssize(_v)), v(vsize(n)) {
+    BasicModVec(const std::vector<modint>& _v)
+        : n(std::ssize(_v)), v(vsize(n)) {
+        FASTFPS_STATS_SCOPE(CONVERT, n);
         for (int i = 0; i < std::ssize(v); i++) {
             std::array<modint, 8> buf{};
             for (int j = 0; j < 8 && (i * 8 + j) < n; j++) {
@@ -49,7 +73,8 @@ template <int MOD> struct ModVec {
             v[i] = modint8(buf);
         }
     }
-    ModVec(const std::vector<u32>& _v) : n(std::ssize(_v)), v(vsize(n)) {
+    BasicModVec(const std::vector<u32>& _v) : n(std::ssize(_v)), v(vsize(n)) {
+        FASTFPS_STATS_SCOPE(CONVERT, n);
         for (int i = 0; i < std::ssize(v); i++) {
             std::array<u32, 8> buf{};
             for (int j = 0; j < 8 && (i * 8 + j) < n; j++) {
@@ -59,9 +84,47 @@ template <int MOD> struct ModVec {
         }
     }
 
+    // evaluates an expression (see modvec_expr.hpp) in one pass
+    // If e is an rvalue holding an rvalue ModVec, its buffer is reused.
+    template <class E>
+        requires is_modvec_expr<std::remove_cvref_t<E>>::value
+    BasicModVec(E&& e) : n(0), v() {
+        ModVecExprContext<modint8> ctx;
+        e.count(ctx);
+        e.prepare(ctx);
+        if constexpr (!std::is_lvalue_reference_v<E> &&
+                      !std::is_const_v<std::remove_reference_t<E>>) {
+            e.steal(*this);
+        }
+        assign(e);
+    }
+    template <class E>
+        requires is_modvec_expr<std::remove_cvref_t<E>>::value
+    BasicModVec& operator=(E&& e) {
+        ModVecExprContext<modint8> ctx;
+        e.count(ctx);
+        e.prepare(ctx);
+        assign(e);
+        return *this;
+    }
+
+    explicit BasicModVec(const view_type& a) : BasicModVec(as_expr(a)) {}
+
     size_t size() const { return n; }
 
+    // this[start .. start + len) without copy
+    view_type view(ssize_t start, ssize_t len) const {
+        assert(0 <= start && 0 <= len && start + len <= n);
+        return view_type(v, start, len);
+    }
+
+    // raw blocks: the i-th coefficient is blocks()[i / 8][i % 8],
+    // and lanes at or after size() must be kept 0
+    std::span<const modint8> blocks() const { return v; }
+    std::span<modint8> blocks() { return v; }
+
     std::vector<u32> val() const {
+        FASTFPS_STATS_SCOPE(CONVERT, n);
         std::vector<u32> _v(n);
         for (int i = 0; i < std::ssize(v); i++) {
             std::array<u32, 8> buf = v[i].val();
@@ -84,7 +147,7 @@ template <int MOD> struct ModVec {
         return;
     }
 
-    ModVec& operator+=(const ModVec& rhs) {
+    BasicModVec& operator+=(const BasicModVec& rhs) {
         n = std::max(n, rhs.n);
         if (std::size(v) < std::size(rhs.v)) {
             v.resize(std::size(rhs.v));
@@ -94,11 +157,8 @@ template <int MOD> struct ModVec {
         }
         return *this;
     }
-    friend ModVec operator+(const ModVec& lhs, const ModVec& rhs) {
-        return ModVec(lhs) += rhs;
-    }
 
-    ModVec& operator-=(const ModVec& rhs) {
+    BasicModVec& operator-=(const BasicModVec& rhs) {
         n = std::max(n, rhs.n);
         if (std::size(v) < std::size(rhs.v)) {
             v.resize(std::size(rhs.v));
@@ -108,162 +168,82 @@ template <int MOD> struct ModVec {
         }
         return *this;
     }
-    friend ModVec operator-(const ModVec& lhs, const ModVec& rhs) {
-        return ModVec(lhs) -= rhs;
+
+    template <class E>
+        requires is_modvec_expr<std::remove_cvref_t<E>>::value
+    BasicModVec& operator+=(E&& e) {
+        return *this = *this + std::forward<E>(e);
+    }
+    template <class E>
+        requires is_modvec_expr<std::remove_cvref_t<E>>::value
+    BasicModVec& operator-=(E&& e) {
+        return *this = *this - std::forward<E>(e);
+    }
+    template <class E>
+        requires is_modvec_expr<std::remove_cvref_t<E>>::value
+    BasicModVec& operator*=(E&& e) {
+        return *this = *this * std::forward<E>(e);
     }
 
-    friend bool operator==(const ModVec& lhs, const ModVec& rhs) {
+    friend bool operator==(const BasicModVec& lhs, const BasicModVec& rhs) {
         return lhs.n == rhs.n && lhs.v == rhs.v;
     }
 
-    ModVec& operator*=(const ModVec& rhs) {
+    // In place: v is transformed in its own buffer, and rhs in a scratch
+    // buffer of the Workspace (or in its own buffer if it is an rvalue).
+    // With m = bit_ceil(vsize(size() + rhs.size() - 1)) blocks, the peak
+    // memory is v and the transform of rhs, 2m blocks (< 4x the result).
+    // If m exceeds max_fft_size(), the product is split (see mul_split).
+    BasicModVec& operator*=(const BasicModVec& rhs) {
         if (n == 0 || rhs.n == 0) {
             n = 0;
             v.clear();
             return *this;
         }
-        auto rv = rhs.v;
-
-        n += rhs.n - 1;
-
-        ssize_t v_up = (ssize_t)std::bit_ceil((size_t)vsize(n));
-        v.resize(v_up);
-        rv.resize(v_up);
-        fft(v);
-        fft(rv);
-        for (int i = 0; i < v_up; i++) {
-            v[i] *= rv[i];
+        if (transform_size(rhs) > max_fft_size<modint8>()) {
+            mul_split(rhs);
+            return *this;
         }
-        ifft(v);
-
-        v.resize(vsize(n));
-
-        modint8 inv = modint8::set1(modint(8 * v_up).inv());
-        for (auto& x : v) x *= inv;
+        Workspace::Frame frame;
+        auto f = frame.alloc<modint8>(transform_size(rhs));
+        std::ranges::copy(rhs.v, f.begin());
+        mul(f, rhs.n);
         return *this;
     }
-    friend ModVec operator*(const ModVec& lhs, const ModVec& rhs) {
-        return ModVec(lhs) *= rhs;
+    BasicModVec& operator*=(BasicModVec&& rhs) {
+        if (this == &rhs) return *this *= std::as_const(rhs);
+        if (n == 0 || rhs.n == 0) {
+            n = 0;
+            v.clear();
+            return *this;
+        }
+        if (transform_size(rhs) > max_fft_size<modint8>()) {
+            mul_split(rhs);
+            return *this;
+        }
+        rhs.v.resize(transform_size(rhs));
+        mul(rhs.v, rhs.n);
+        rhs.n = 0;
+        rhs.v.clear();
+        return *this;
     }
 
-    ModVec& operator*=(const modint& rhs) {
+    BasicModVec& operator*=(const modint& rhs) {
         modint8 r = modint8::set1(rhs);
         for (auto& x : v) x *= r;
         return *this;
     }
-    friend ModVec operator*(const ModVec& lhs, const modint& rhs) {
-        return ModVec(lhs) *= rhs;
-    }
-    friend ModVec operator*(const modint& lhs, const ModVec& rhs) {
-        return ModVec(rhs) *= lhs;
-    }
 
     // dst[dst_start .. dst_start + len) = this[start .. start + len)
     void copy_to(ssize_t start,
                  ssize_t len,
-                 ModVec& dst,
+                 BasicModVec& dst,
                  ssize_t dst_start) const {
         // TODO: be able to self move
-        assert(0 <= start && start + len <= n);
-        assert(0 <= dst_start && dst_start + len <= dst.n);
-        if (len == 0) return;
-
-        auto succ = [&](ssize_t len2) {
-            start += len2;
-            dst_start += len2;
-            len -= len2;
-        };
-        if (start % 8 == dst_start % 8) {
-            {
-                ssize_t len2 = std::min(len, 8 - dst_start % 8);
-                const auto mask = [&]() {
-                    std::array<u32, 8> b;
-                    for (int i = 0; i < 8; i++) {
-                        b[i] = (dst_start % 8 <= i && i < dst_start % 8 + len2);
-                    }
-                    return b;
-                }();
-                dst.v[dst_start / 8] =
-                    blendvar(dst.v[dst_start / 8], v[start / 8], mask);
-                succ(len2);
-            }
-            if (len == 0) return;
-            assert(start % 8 == 0 && dst_start % 8 == 0);
-            while (len >= 8) {
-                // TODO: use std::copy
-                dst.v[dst_start / 8] = v[start / 8];
-                succ(8);
-            }
-            if (len == 0) return;
-            {
-                ssize_t len2 = len;
-                const auto mask = [&]() {
-                    std::array<u32, 8> b;
-                    for (int i = 0; i < 8; i++) {
-                        b[i] = (i < len2);
-                    }
-                    return b;
-                }();
-                dst.v[dst_start / 8] =
-                    blendvar(dst.v[dst_start / 8], v[start / 8], mask);
-                succ(len2);
-            }
-        } else {
-            const ssize_t shift = (start + 8 - dst_start % 8) % 8;
-            const auto blend_mask = [&]() {
-                std::array<u32, 8> b;
-                for (int i = 0; i < 8; i++) {
-                    b[i] = (8 - shift <= i);
-                }
-                return b;
-            }();
-            {
-                ssize_t len2 = std::min(len, 8 - dst_start % 8);
-                const auto mask = [&]() {
-                    std::array<u32, 8> b;
-                    for (int i = 0; i < 8; i++) {
-                        b[i] = (dst_start % 8 <= i && i < dst_start % 8 + len2);
-                    }
-                    return b;
-                }();
-                auto x = v[start / 8].rotate((u32)shift);
-                if (len2 > 8 - start % 8) {
-                    x = blendvar(x, v[start / 8 + 1].rotate((u32)(shift)),
-                                 blend_mask);
-                }
-                dst.v[dst_start / 8] = blendvar(dst.v[dst_start / 8], x, mask);
-                succ(len2);
-            }
-            if (len == 0) return;
-
-            while (len >= 8) {
-                modint8 l = v[start / 8], r = v[start / 8 + 1];
-                dst.v[dst_start / 8] = blendvar(
-                    l.rotate(u32(shift)), r.rotate(u32(shift)), blend_mask);
-                succ(8);
-            }
-            if (len == 0) return;
-            {
-                ssize_t len2 = len;
-                const auto mask = [&]() {
-                    std::array<u32, 8> b = {};
-                    for (int i = 0; i < 8; i++) {
-                        b[i] = (i < len2);
-                    }
-                    return b;
-                }();
-                auto x = v[start / 8].rotate((u32)shift);
-                if (len2 > 8 - start % 8) {
-                    x = blendvar(x, v[start / 8 + 1].rotate((u32)(shift)),
-                                 blend_mask);
-                }
-                dst.v[dst_start / 8] = blendvar(dst.v[dst_start / 8], x, mask);
-                succ(len2);
-            }
-        }
+        view(start, len).copy_to(dst, dst_start);
     }
 
-    ModVec& operator<<=(ssize_t s) {
+    BasicModVec& operator<<=(ssize_t s) {
         n += s;
         if (s % 8 == 0) {
             v.insert(v.begin(), s / 8, modint8());
@@ -277,26 +257,32 @@ template <int MOD> struct ModVec {
                 }
                 return b;
             }();
+            // lane j of a block is lane j - s % 8 (mod 8) of the source
+            const u32 rot = u32(8 - s % 8);
             for (auto i = std::ssize(v) - 1; i >= s / 8 + 1; i--) {
                 modint8 l = v[i - 1 - s / 8], r = v[i - s / 8];
-                v[i] = blendvar(l.rotate(u32(s % 8)), r.rotate(u32(8 - s % 8)),
-                                mask);
+                v[i] = blendvar(l.rotate(rot), r.rotate(rot), mask);
             }
-            v[s / 8] = blendvar(modint8(), v[0].rotate(u32(8 - s % 8)), mask);
+            v[s / 8] = blendvar(modint8(), v[0].rotate(rot), mask);
             std::ranges::fill_n(v.begin(), s / 8, modint8());
         }
         return *this;
     }
-    friend ModVec operator<<(const ModVec& lhs, ssize_t s) {
-        return ModVec(lhs) <<= s;
+    friend BasicModVec operator<<(const BasicModVec& lhs, ssize_t s) {
+        return BasicModVec(lhs) <<= s;
     }
 
-    ModVec inv(int m) const {
+    BasicModVec inv(int m) const {
         // TODO: Optimize
         assert(val(0) == 1);
-        ModVec res = ModVec({1});
+        // O(mk) for k nonzero coefficients
+        if (auto s = internal::find_sparse(*this, m, SPARSE_INV_TERMS)) {
+            return sparse_inv(*s, m);
+        }
+        BasicModVec res = BasicModVec({1}), pre;
         for (ssize_t i = 1; i < m; i *= 2) {
-            ModVec pre(2 * i);
+            pre.resize(0);
+            pre.resize(2 * i);
             copy_to(0, std::min(n, 2 * i), pre, 0);
             res = (res * 2 - res * res * pre);
             res.resize(2 * i);
@@ -305,16 +291,68 @@ template <int MOD> struct ModVec {
         return res;
     }
 
-    ModVec substr(ssize_t st, ssize_t len) const {
-        assert(0 <= st && 0 <= len && st + len <= n);
+    // f(x + c)
+    // g[j] j! = sum_k f[j + k] (j + k)! c^k / k!, which is one product of
+    // the reversed f[i] i! and c^k / k!.
+    BasicModVec taylor_shift(modint c) const {
+        if (n <= TAYLOR_SHIFT_NAIVE) {
+            // synthetic division by x - c, n times
+            auto a = val();
+            std::vector<modint> f(n);
+            for (ssize_t i = 0; i < n; i++) f[i] = modint(a[i]);
+            for (ssize_t i = 0; i < n; i++) {
+                for (ssize_t j = n - 2; j >= i; j--) f[j] += c * f[j + 1];
+            }
+            return BasicModVec(f);
+        }
+
+        const ssize_t nb = std::ssize(v);
+        Workspace::Frame frame;
+        auto fact = frame.alloc<modint8>(nb);
+        auto inv_fact = frame.alloc<modint8>(nb);
+        fill_factorials(fact, inv_fact);
+
+        BasicModVec a(n), b(n);
+        for (ssize_t i = 0; i < nb; i++) a.v[i] = v[i] * fact[i];
+        a.reverse();
+        // c^k / k!
+        modint pw = 1;
+        std::array<modint, 8> c8;
+        for (auto& x : c8) {
+            x = pw;
+            pw *= c;
+        }
+        modint8 ck(c8);
+        const modint8 step = modint8::set1(pw);
+        for (ssize_t i = 0; i < nb; i++) {
+            b.v[i] = ck * inv_fact[i];
+            ck *= step;
+        }
+        b.clear_last();
+
+        a *= std::move(b);
+        a.resize(n);
+        a.reverse();
+        for (ssize_t i = 0; i < nb; i++) a.v[i] *= inv_fact[i];
+        return a;
+    }
 
-        ModVec b(len);
-        copy_to(st, len, b, 0);
-        return b;
+    // this(g(x)) mod x^n, O(n log^2 n)
+    BasicModVec compose(const BasicModVec& g, ssize_t m) const {
+        return internal::compose(*this, g, m);
+    }
+
+    // g mod x^m with this(g(x)) = x, this[0] = 0 and this[1] != 0
+    BasicModVec compositional_inverse(ssize_t m) const {
+        return internal::compositional_inverse(*this, m);
+    }
+
+    BasicModVec substr(ssize_t st, ssize_t len) const {
+        return BasicModVec(view(st, len));
     }
 
     // sum a[i] * b[i]
-    friend modint dot(const ModVec& lhs, const ModVec& rhs) {
+    friend modint dot(const BasicModVec& lhs, const BasicModVec& rhs) {
         modint8 sum;
         for (int i = 0; i < std::min(std::ssize(lhs.v), std::ssize(rhs.v));
              i++) {
@@ -337,37 +375,40 @@ template <int MOD> struct ModVec {
             x = x.permutevar({7, 6, 5, 4, 3, 2, 1, 0});
         }
 
-        ModVec tmp(prev_n);
+        BasicModVec tmp(prev_n);
         copy_to(n - prev_n, prev_n, tmp, 0);
-        *this = tmp;
+        *this = std::move(tmp);
     }
 
-    ModVec berlekamp_massey() const {
-        ModVec b({-1}), c({-1});
+    BasicModVec berlekamp_massey() const {
+        // buffers are reused, so their capacity only grows O(log n) times
+        BasicModVec b({-1}), c({-1}), prev_c, tmp;
         modint y = 1;
         for (int ed = 1; ed <= n; ed++) {
             int l = int(c.size()), m = int(b.size());
             b.resize(m + 1);
             m++;
 
-            modint x = dot(c, substr(ed - l, l));
+            modint x = dot(c, view(ed - l, l));
             if (x == 0) continue;
             modint freq = x * y.inv();
             if (l < m) {
                 // use b
-                auto prev_c = c;
+                prev_c = c;
 
-                ModVec tmp(m);
+                tmp.resize(0);
+                tmp.resize(m);
                 c.copy_to(0, l, tmp, m - l);
-                c = tmp;
+                std::swap(c, tmp);
                 c -= freq * b;
 
-                b = prev_c;
+                std::swap(b, prev_c);
                 y = x;
             } else {
                 // use c
 
-                ModVec tmp(l);
+                tmp.resize(0);
+                tmp.resize(l);
                 b.copy_to(0, m, tmp, l - m);
 
                 c -= freq * tmp;
@@ -377,7 +418,7 @@ template <int MOD> struct ModVec {
         return c;
     }
 
-    friend std::ostream& operator<<(std::ostream& os, const ModVec& r) {
+    friend std::ostream& operator<<(std::ostream& os, const BasicModVec& r) {
         auto r2 = r.val();
 
         os << "[";
@@ -390,10 +431,129 @@ template <int MOD> struct ModVec {
 
   private:
     ssize_t n;
-    std::vector<modint8> v;
+    std::vector<modint8, AlignedAllocator<modint8>> v;
+
+    // taylor_shift is O(n^2) up to this size
+    static constexpr ssize_t TAYLOR_SHIFT_NAIVE = 32;
+    // inv uses sparse_inv up to this number of nonzero coefficients
+    static constexpr ssize_t SPARSE_INV_TERMS = 64;
 
     static ssize_t vsize(ssize_t n) { return (n + 7) / 8; }
 
+    template <class E> void assign(const E& e) {
+        const ssize_t sz = e.size(), nb = vsize(sz);
+        if (nb > ssize_t(v.capacity())) {
+            std::vector<modint8, AlignedAllocator<modint8>> w(nb);
+            for (int i = 0; i < nb; i++) {
+                w[i] = e.block(i);
+            }
+            v = std::move(w);
+        } else {
+            // e may refer to this (also by a view): the i-th block of e only
+            // reads blocks at or after i, and v is not reallocated
+            if (nb > std::ssize(v)) v.resize(nb);
+            for (int i = 0; i < nb; i++) {
+                v[i] = e.block(i);
+            }
+            v.resize(nb);
+        }
+        n = sz;
+    }
+
+    // If the product is one coefficient longer than m / 2 blocks (e.g. the
+    // product of 2^k linear factors) and both operands fit in them, the
+    // cyclic convolution of m / 2 blocks is used and the last coefficient,
+    // which wraps around to 0, is corrected by mul.
+    ssize_t transform_size(const BasicModVec& rhs) const {
+        const ssize_t len = n + rhs.n - 1;
+        const ssize_t m = (ssize_t)std::bit_ceil((size_t)vsize(len));
+        const bool wrap = m >= 2 && len == 4 * m + 1 && n > 1 && rhs.n > 1;
+        return wrap ? m / 2 : m;
+    }
+
+    // this *= rhs, f: rhs zero padded to transform_size(rhs) blocks
+    void mul(std::span<modint8> f, ssize_t rhs_n) {
+        const ssize_t m = std::ssize(f);
+        auto coef = [](std::span<const modint8> a, ssize_t i) {
+            std::array<modint, 8> b;
+            a[i / 8].store(b);
+            return b[i % 8];
+        };
+        // the product of the leading coefficients if it wraps around
+        std::array<modint, 8> last{};
+        const bool wrap = n + rhs_n - 1 > 8 * m;
+        if (wrap) last[0] = coef(v, n - 1) * coef(f, rhs_n - 1);
+        n += rhs_n - 1;
+        v.resize(m);
+        fft2(v, f);
+        {
+            FASTFPS_STATS_SCOPE(POINTWISE, 8 * m);
+            for (int i = 0; i < m; i++) {
+                v[i] *= f[i];
+            }
+        }
+        ifft(v);
+
+        v.resize(vsize(n));
+        const modint8 inv = modint8::set1(modint(8 * m).inv());
+        for (auto& x : v) x *= inv;
+        if (wrap) {
+            v.front() -= modint8(last);
+            v.back() = modint8(last);
+        }
+    }
+
+    // this *= rhs for a product longer than the transforms of the modulus
+    //
+    // With m = max_fft_size() blocks, B = 4m coefficients and y = x^B,
+    // this = sum_i a_i y^i and rhs = sum_j b_j y^j for |a_i|, |b_j| <= B.
+    // Each piece is transformed once with 2B coefficients, and
+    // c_k = sum_{i+j=k} a_i b_j is summed up in the frequency domain and
+    // added at y^k after one inverse transform. The transforms are about
+    // 4 (|this| + |rhs|) coefficients in total (a single product transforms
+    // 3x at least |this * rhs|), plus |this| |rhs| / B pointwise products.
+    // The peak memory is the transforms of the pieces and the result, about
+    // 3 (|this| + |rhs|) coefficients.
+    void mul_split(const BasicModVec& rhs) {
+        assert(std::countr_zero(modint8::mod() - 1) >= 4);
+        const ssize_t m = max_fft_size<modint8>(), h = m / 2;
+        const modint8 inv = modint8::set1(modint(8 * m).inv());
+        // the transforms of the pieces of a, one per m blocks
+        auto pieces = [&](const BasicModVec& a, bool scale) {
+            const ssize_t k = (std::ssize(a.v) + h - 1) / h;
+            std::vector<modint8, AlignedAllocator<modint8>> f(k * m);
+            for (ssize_t i = 0; i < k; i++) {
+                const auto p = std::span(f).subspan(i * m, m);
+                const ssize_t len = std::min(h, std::ssize(a.v) - i * h);
+                std::copy_n(a.v.begin() + i * h, len, p.begin());
+                fft(p);
+                if (scale) {
+                    for (auto& x : p) x *= inv;
+                }
+            }
+            return f;
+        };
+        const auto fa = pieces(*this, false), fb = pieces(rhs, true);
+        const ssize_t na = std::ssize(fa) / m, nb = std::ssize(fb) / m;
+
+        n += rhs.n - 1;
+        v.assign(vsize(n), modint8());
+        std::vector<modint8, AlignedAllocator<modint8>> c(m);
+        for (ssize_t k = 0; k < na + nb - 1; k++) {
+            std::ranges::fill(c, modint8());
+            for (ssize_t i = std::max<ssize_t>(0, k - nb + 1);
+                 i <= std::min(k, na - 1); i++) {
+                FASTFPS_STATS_SCOPE(POINTWISE, 8 * m);
+                const modint8* x = fa.data() + i * m;
+                const modint8* y = fb.data() + (k - i) * m;
+                for (ssize_t t = 0; t < m; t++) c[t] += x[t] * y[t];
+            }
+            ifft(c);
+            const ssize_t len = std::min(m, std::ssize(v) - k * h);
+            for (ssize_t t = 0; t < len; t++) v[k * h + t] += c[t];
+        }
+    }
+
     void clear_last() {
         if (n % 8 == 0) return;
         v.back() = blendvar(v.back(), modint8(), [&]() {
@@ -406,4 +566,10 @@ template <int MOD> struct ModVec {
     }
 };
 
+template <int MOD> using ModVec = BasicModVec<ModInt8<MOD>>;
+// ModVec over the runtime modulus of DynModInt<id>
+template <int id> using DynModVec = BasicModVec<DynModInt8<id>>;
+template <int MOD> using MappedModVec = BasicMappedModVec<ModInt8<MOD>>;
+template <int MOD> using SparseModVec = BasicSparseModVec<ModInt8<MOD>>;
+
 }  // namespace fastfps
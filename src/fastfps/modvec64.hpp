@@ -0,0 +1,188 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <iostream>
+#include <vector>
+
+#include "fastfps/allocator.hpp"
+#include "fastfps/fft64.hpp"
+#include "fastfps/modint64.hpp"
+#include "fastfps/modint64x4.hpp"
+
+namespace fastfps {
+
+// ModVec over a modulus up to 2^62 - 1, stored as ModInt64x4
+template <u64 MOD> struct ModVec64 {
+    using modint = ModInt64<MOD>;
+    using modint4 = ModInt64x4<MOD>;
+
+  public:
+    ModVec64() : n(0), v() {}
+    explicit ModVec64(ssize_t _n) : n(_n), v(vsize(_n)) {}
+    ModVec64(std::initializer_list<u64> li) : n(ssize(li)), v(vsize(n)) {
+        auto it = li.begin();
+        for (int i = 0; i < ssize(v); i++) {
+            std::array<u64, 4> buf = {};
+            for (int j = 0; j < 4 && (i * 4 + j) < n; j++) {
+                buf[j] = *it;
+                it++;
+            }
+            v[i] = modint4(buf);
+        }
+    }
+
+    ModVec64(const std::vector<modint>& _v) : n(std::ssize(_v)), v(vsize(n)) {
+        for (int i = 0; i < std::ssize(v); i++) {
+            std::array<modint, 4> buf{};
+            for (int j = 0; j < 4 && (i * 4 + j) < n; j++) {
+                buf[j] = _v[i * 4 + j];
+            }
+            v[i] = modint4(buf);
+        }
+    }
+    ModVec64(const std::vector<u64>& _v) : n(std::ssize(_v)), v(vsize(n)) {
+        for (int i = 0; i < std::ssize(v); i++) {
+            std::array<u64, 4> buf{};
+            for (int j = 0; j < 4 && (i * 4 + j) < n; j++) {
+                buf[j] = _v[i * 4 + j];
+            }
+            v[i] = modint4(buf);
+        }
+    }
+
+    size_t size() const { return n; }
+
+    std::vector<u64> val() const {
+        std::vector<u64> _v(n);
+        for (int i = 0; i < std::ssize(v); i++) {
+            std::array<u64, 4> buf = v[i].val();
+            for (int j = 0; j < 4 && (i * 4 + j) < n; j++) {
+                _v[i * 4 + j] = buf[j];
+            }
+        }
+        return _v;
+    }
+    u64 val(ssize_t index) const {
+        if (index < 0 || n <= index) return 0;
+        return v[index / 4].val()[index % 4];
+    }
+
+    void resize(ssize_t sz) {
+        n = sz;
+        v.resize(vsize(n));
+        clear_last();
+        return;
+    }
+
+    ModVec64& operator+=(const ModVec64& rhs) {
+        n = std::max(n, rhs.n);
+        if (std::size(v) < std::size(rhs.v)) {
+            v.resize(std::size(rhs.v));
+        }
+        for (int i = 0; i < std::ssize(rhs.v); i++) {
+            v[i] += rhs.v[i];
+        }
+        return *this;
+    }
+    friend ModVec64 operator+(const ModVec64& lhs, const ModVec64& rhs) {
+        return ModVec64(lhs) += rhs;
+    }
+
+    ModVec64& operator-=(const ModVec64& rhs) {
+        n = std::max(n, rhs.n);
+        if (std::size(v) < std::size(rhs.v)) {
+            v.resize(std::size(rhs.v));
+        }
+        for (int i = 0; i < std::ssize(rhs.v); i++) {
+            v[i] -= rhs.v[i];
+        }
+        return *this;
+    }
+    friend ModVec64 operator-(const ModVec64& lhs, const ModVec64& rhs) {
+        return ModVec64(lhs) -= rhs;
+    }
+
+    friend bool operator==(const ModVec64& lhs, const ModVec64& rhs) {
+        return lhs.n == rhs.n && lhs.v == rhs.v;
+    }
+
+    // v is transformed in its own buffer and rhs in a scratch buffer of the
+    // Workspace. The product must fit in one transform of
+    // max_fft64_size<MOD>() elements (there is no split as in
+    // BasicModVec::mul_split; 2^57 coefficients for 4179340454199820289).
+    ModVec64& operator*=(const ModVec64& rhs) {
+        if (n == 0 || rhs.n == 0) {
+            n = 0;
+            v.clear();
+            return *this;
+        }
+        n += rhs.n - 1;
+
+        const ssize_t v_up = (ssize_t)std::bit_ceil((size_t)vsize(n));
+        assert(v_up <= max_fft64_size<MOD>());
+        Workspace::Frame frame;
+        auto rv = frame.alloc<modint4>(v_up);
+        std::ranges::copy(rhs.v, rv.begin());
+        v.resize(v_up);
+        fft(v);
+        fft(rv);
+        for (int i = 0; i < v_up; i++) {
+            v[i] *= rv[i];
+        }
+        ifft(v);
+
+        v.resize(vsize(n));
+
+        modint4 inv = modint4::set1(modint(4 * v_up).inv());
+        for (auto& x : v) x *= inv;
+        return *this;
+    }
+    friend ModVec64 operator*(const ModVec64& lhs, const ModVec64& rhs) {
+        return ModVec64(lhs) *= rhs;
+    }
+
+    ModVec64& operator*=(const modint& rhs) {
+        modint4 r = modint4::set1(rhs);
+        for (auto& x : v) x *= r;
+        return *this;
+    }
+    friend ModVec64 operator*(const ModVec64& lhs, const modint& rhs) {
+        return ModVec64(lhs) *= rhs;
+    }
+    friend ModVec64 operator*(const modint& lhs, const ModVec64& rhs) {
+        return ModVec64(rhs) *= lhs;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const ModVec64& r) {
+        auto r2 = r.val();
+
+        os << "[";
+        for (int i = 0; i < std::ssize(r2); i++) {
+            if (i) os << ", ";
+            os << r2[i];
+        }
+        return os << "]";
+    }
+
+  private:
+    ssize_t n;
+    std::vector<modint4, AlignedAllocator<modint4>> v;
+
+    static ssize_t vsize(ssize_t n) { return (n + 3) / 4; }
+
+    void clear_last() {
+        if (n % 4 == 0) return;
+        v.back() = blendvar(v.back(), modint4(), [&]() {
+            std::array<u32, 4> b;
+            for (int i = 0; i < 4; i++) {
+                b[i] = ((n % 4) <= i);
+            }
+            return b;
+        }());
+    }
+};
+
+}  // namespace fastfps
@@ -0,0 +1,395 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <iostream>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "fastfps/allocator.hpp"
+#include "fastfps/fft.hpp"
+#include "fastfps/stats.hpp"
+#include "fastfps/types.hpp"
+
+namespace fastfps {
+
+// Expression templates of ModVec.
+//
+// a + b, a - b, c * a and a * b do not compute anything, they build an
+// expression which is evaluated when it is assigned to a ModVec (or by
+// eval()). All elementwise operations are fused into one pass over the
+// blocks, and a product of any number of factors is one ifft of the
+// pointwise product of their transforms. A ModVec used in several factors
+// (e.g. res * res * pre) is transformed once per transform size.
+//
+// An expression refers to its lvalue operands, so it must not outlive them:
+// write `modvec c = a * b;`, not `auto c = a * b;`. Rvalue ModVecs are
+// moved into the expression, and a ModVec constructed from an rvalue
+// expression reuses the buffer of one of them.
+
+template <class _modint8> struct BasicModVec;
+
+template <class T> struct is_basic_modvec : std::false_type {};
+template <class modint8>
+struct is_basic_modvec<BasicModVec<modint8>> : std::true_type {};
+
+// base of all expressions
+struct ModVecExprTag {};
+template <class T>
+struct is_modvec_expr : std::is_base_of<ModVecExprTag, T> {};
+
+// ModVecView (modvec_view.hpp)
+template <class T> struct is_modvec_view : std::false_type {};
+
+// ModVec, ModVecView or expression
+template <class T>
+struct is_modvec_operand
+    : std::bool_constant<is_basic_modvec<T>::value ||
+                         is_modvec_view<T>::value ||
+                         is_modvec_expr<T>::value> {};
+
+// state of one evaluation: scratch buffers and the transforms of ModVecs
+template <class modint8> struct ModVecExprContext {
+    static constexpr int MAX_LEAVES = 8;
+
+    Workspace::Frame frame;
+
+    struct Entry {
+        const void* p;
+        int uses;
+        ssize_t m;
+        std::span<modint8> f;
+    };
+    std::array<Entry, MAX_LEAVES> leaves{};
+    int leaf_count = 0;
+
+    // called for each ModVec in the expression before prepare
+    void add_use(const void* p) {
+        for (int i = 0; i < leaf_count; i++) {
+            if (leaves[i].p == p) {
+                leaves[i].uses++;
+                return;
+            }
+        }
+        if (leaf_count < MAX_LEAVES) leaves[leaf_count++] = {p, 1, 0, {}};
+    }
+
+    // (fft of a zero padded to m blocks, whether it is shared)
+    // The transform of a ModVec used more than once is kept in this
+    // evaluation and must not be modified.
+    template <class modvec>
+    std::pair<std::span<modint8>, bool> transform(const modvec& a,
+                                                  ssize_t m) {
+        Entry* e = nullptr;
+        for (int i = 0; i < leaf_count; i++) {
+            if (leaves[i].p == &a && leaves[i].uses > 1) e = &leaves[i];
+        }
+        if (e && e->m == m) return {e->f, true};
+        auto f = frame.template alloc<modint8>(m);
+        std::ranges::copy(a.blocks(), f.begin());
+        fft(f);
+        if (!e) return {f, false};
+        e->m = m;
+        e->f = f;
+        return {f, true};
+    }
+};
+
+template <class Derived, class _modvec> struct ModVecExpr : ModVecExprTag {
+    using modvec = _modvec;
+    using modint8 = typename modvec::modint8;
+    using modint = typename modint8::modint;
+
+    modvec eval() const& {
+        return modvec(static_cast<const Derived&>(*this));
+    }
+    modvec eval() && { return modvec(static_cast<Derived&&>(*this)); }
+    std::vector<u32> val() const { return eval().val(); }
+};
+
+// Every expression has
+//   size(): the length of the result
+//   count(ctx): calls ctx.add_use for each ModVec in it
+//   prepare(ctx): evaluates the products in it
+//   block(i): the i-th block of the result (after prepare, 0 if i is out of
+//             range, lanes at or after size() are 0)
+//   steal(dst): moves the buffer of an owned ModVec to dst and refers to
+//               dst instead (after prepare), returns false if there is none
+
+// lvalue ModVec
+template <class modvec>
+struct LeafExpr : ModVecExpr<LeafExpr<modvec>, modvec> {
+    using modint8 = typename modvec::modint8;
+
+    explicit LeafExpr(const modvec& _a) : a(_a) {}
+
+    const modvec& get() const { return a; }
+    ssize_t size() const { return a.size(); }
+    void count(ModVecExprContext<modint8>& ctx) const { ctx.add_use(&a); }
+    void prepare(ModVecExprContext<modint8>&) const {}
+    modint8 block(ssize_t i) const {
+        // not by size(): a may be the destination and already resized
+        auto v = a.blocks();
+        return i < std::ssize(v) ? v[i] : modint8();
+    }
+    bool steal(modvec&) { return false; }
+
+  private:
+    const modvec& a;
+};
+
+// rvalue ModVec, moved into the expression
+template <class modvec>
+struct OwnedLeafExpr : ModVecExpr<OwnedLeafExpr<modvec>, modvec> {
+    using modint8 = typename modvec::modint8;
+
+    explicit OwnedLeafExpr(modvec&& _a) : a(std::move(_a)) {}
+
+    const modvec& get() const { return dst ? *dst : a; }
+    ssize_t size() const { return get().size(); }
+    void count(ModVecExprContext<modint8>& ctx) const {
+        ctx.add_use(&get());
+    }
+    void prepare(ModVecExprContext<modint8>&) const {}
+    modint8 block(ssize_t i) const {
+        auto v = get().blocks();
+        return i < std::ssize(v) ? v[i] : modint8();
+    }
+    bool steal(modvec& _dst) {
+        if (dst) return false;
+        _dst = std::move(a);
+        dst = &_dst;
+        return true;
+    }
+
+  private:
+    modvec a;
+    const modvec* dst = nullptr;
+};
+
+// ModVecView (modvec_view.hpp)
+template <class view> struct ViewLeafExpr;
+
+template <class T> auto as_expr(T&& x) {
+    using U = std::remove_cvref_t<T>;
+    if constexpr (is_modvec_view<U>::value) {
+        return ViewLeafExpr<U>(x);
+    } else if constexpr (!is_basic_modvec<U>::value) {
+        return U(std::forward<T>(x));
+    } else if constexpr (std::is_lvalue_reference_v<T>) {
+        return LeafExpr<U>(x);
+    } else {
+        return OwnedLeafExpr<U>(std::move(x));
+    }
+}
+template <class T> using as_expr_t = decltype(as_expr(std::declval<T>()));
+
+template <class L, class R, bool SUB>
+struct SumExpr : ModVecExpr<SumExpr<L, R, SUB>, typename L::modvec> {
+    using modint8 = typename L::modint8;
+
+    L l;
+    R r;
+
+    SumExpr(L _l, R _r) : l(std::move(_l)), r(std::move(_r)) {}
+
+    ssize_t size() const { return std::max(l.size(), r.size()); }
+    void count(ModVecExprContext<modint8>& ctx) const {
+        l.count(ctx);
+        r.count(ctx);
+    }
+    void prepare(ModVecExprContext<modint8>& ctx) const {
+        l.prepare(ctx);
+        r.prepare(ctx);
+    }
+    modint8 block(ssize_t i) const {
+        return SUB ? l.block(i) - r.block(i) : l.block(i) + r.block(i);
+    }
+    template <class modvec> bool steal(modvec& dst) {
+        return l.steal(dst) || r.steal(dst);
+    }
+};
+
+template <class E>
+struct ScaleExpr : ModVecExpr<ScaleExpr<E>, typename E::modvec> {
+    using modint8 = typename E::modint8;
+
+    E e;
+    modint8 c;
+
+    ScaleExpr(E _e, const modint8& _c) : e(std::move(_e)), c(_c) {}
+
+    ssize_t size() const { return e.size(); }
+    void count(ModVecExprContext<modint8>& ctx) const { e.count(ctx); }
+    void prepare(ModVecExprContext<modint8>& ctx) const { e.prepare(ctx); }
+    modint8 block(ssize_t i) const { return e.block(i) * c; }
+    template <class modvec> bool steal(modvec& dst) { return e.steal(dst); }
+};
+
+template <class L, class R> struct ProdExpr;
+
+template <class T> struct is_leaf_expr : std::false_type {};
+template <class modvec>
+struct is_leaf_expr<LeafExpr<modvec>> : std::true_type {};
+template <class modvec>
+struct is_leaf_expr<OwnedLeafExpr<modvec>> : std::true_type {};
+template <class T> struct is_prod_expr : std::false_type {};
+template <class L, class R>
+struct is_prod_expr<ProdExpr<L, R>> : std::true_type {};
+
+template <class L, class R>
+struct ProdExpr : ModVecExpr<ProdExpr<L, R>, typename L::modvec> {
+    using modvec = typename L::modvec;
+    using modint8 = typename L::modint8;
+    using modint = typename modint8::modint;
+
+    L l;
+    R r;
+
+    ProdExpr(L _l, R _r) : l(std::move(_l)), r(std::move(_r)) {}
+
+    ssize_t size() const {
+        const ssize_t ls = l.size(), rs = r.size();
+        return (ls && rs) ? ls + rs - 1 : 0;
+    }
+    void count(ModVecExprContext<modint8>& ctx) const {
+        l.count(ctx);
+        r.count(ctx);
+    }
+
+    void prepare(ModVecExprContext<modint8>& ctx) const {
+        const ssize_t n = size();
+        res = {};
+        if (n == 0) return;
+        const ssize_t m = (ssize_t)std::bit_ceil((size_t)((n + 7) / 8));
+        if (m > max_fft_size<modint8>()) {
+            // too long for one transform: modvec::operator*= splits it
+            split = modvec(l);
+            split *= modvec(r);
+            res = split.blocks();
+            inv = modint8::set1(1);
+            return;
+        }
+
+        // peak: one buffer of m blocks per distinct factor
+        std::span<modint8> acc;
+        transforms(ctx, m, [&](std::span<modint8> f, bool shared) {
+            if (acc.empty()) {
+                if (shared) {
+                    acc = ctx.frame.template alloc<modint8>(m);
+                    std::ranges::copy(f, acc.begin());
+                } else {
+                    acc = f;
+                }
+                return;
+            }
+            FASTFPS_STATS_SCOPE(POINTWISE, 8 * m);
+            for (ssize_t i = 0; i < m; i++) {
+                acc[i] *= f[i];
+            }
+        });
+        ifft(acc);
+        res = acc.first((n + 7) / 8);
+        inv = modint8::set1(modint(8 * m).inv());
+    }
+    modint8 block(ssize_t i) const {
+        return i < std::ssize(res) ? res[i] * inv : modint8();
+    }
+    template <class modvec> bool steal(modvec& dst) {
+        return l.steal(dst) || r.steal(dst);
+    }
+
+    // fn(transform of each factor at size m, whether it is shared)
+    template <class F>
+    void transforms(ModVecExprContext<modint8>& ctx, ssize_t m, F fn) const {
+        transforms_of(l, ctx, m, fn);
+        transforms_of(r, ctx, m, fn);
+    }
+
+  private:
+    mutable std::span<const modint8> res;
+    mutable modint8 inv;
+    // the product if it is evaluated by modvec::operator*=
+    mutable modvec split;
+
+    template <class E, class F>
+    static void transforms_of(const E& e,
+                              ModVecExprContext<modint8>& ctx,
+                              ssize_t m,
+                              F fn) {
+        if constexpr (is_prod_expr<E>::value) {
+            // (a * b) * c: flatten
+            e.transforms(ctx, m, fn);
+        } else if constexpr (is_leaf_expr<E>::value) {
+            auto [f, shared] = ctx.transform(e.get(), m);
+            fn(f, shared);
+        } else {
+            e.prepare(ctx);
+            auto f = ctx.frame.template alloc<modint8>(m);
+            for (ssize_t i = 0; i < (e.size() + 7) / 8; i++) {
+                f[i] = e.block(i);
+            }
+            fft(f);
+            fn(f, false);
+        }
+    }
+};
+
+template <class L, class R>
+concept modvec_operands =
+    is_modvec_operand<std::remove_cvref_t<L>>::value &&
+    is_modvec_operand<std::remove_cvref_t<R>>::value &&
+    std::is_same_v<typename std::remove_cvref_t<L>::modint8,
+                   typename std::remove_cvref_t<R>::modint8>;
+
+template <class L, class R>
+    requires modvec_operands<L, R>
+auto operator+(L&& l, R&& r) {
+    return SumExpr<as_expr_t<L>, as_expr_t<R>, false>(
+        as_expr(std::forward<L>(l)), as_expr(std::forward<R>(r)));
+}
+
+template <class L, class R>
+    requires modvec_operands<L, R>
+auto operator-(L&& l, R&& r) {
+    return SumExpr<as_expr_t<L>, as_expr_t<R>, true>(
+        as_expr(std::forward<L>(l)), as_expr(std::forward<R>(r)));
+}
+
+template <class L, class R>
+    requires modvec_operands<L, R>
+auto operator*(L&& l, R&& r) {
+    return ProdExpr<as_expr_t<L>, as_expr_t<R>>(as_expr(std::forward<L>(l)),
+                                                as_expr(std::forward<R>(r)));
+}
+
+template <class E>
+    requires is_modvec_operand<std::remove_cvref_t<E>>::value
+auto operator*(E&& e, const typename std::remove_cvref_t<E>::modint& c) {
+    using modint8 = typename std::remove_cvref_t<E>::modint8;
+    return ScaleExpr<as_expr_t<E>>(as_expr(std::forward<E>(e)),
+                                   modint8::set1(c));
+}
+template <class E>
+    requires is_modvec_operand<std::remove_cvref_t<E>>::value
+auto operator*(const typename std::remove_cvref_t<E>::modint& c, E&& e) {
+    return std::forward<E>(e) * c;
+}
+
+template <class L, class R>
+    requires modvec_operands<L, R> &&
+             (is_modvec_expr<L>::value || is_modvec_expr<R>::value)
+bool operator==(const L& l, const R& r) {
+    using modvec = typename as_expr_t<const L&>::modvec;
+    return modvec(l) == modvec(r);
+}
+
+template <class E>
+    requires is_modvec_expr<E>::value
+std::ostream& operator<<(std::ostream& os, const E& e) {
+    return os << e.eval();
+}
+
+}  // namespace fastfps
@@ -0,0 +1,219 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <cstdio>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "fastfps/modvec.hpp"
+#include "fastfps/modvec_view.hpp"
+#include "fastfps/types.hpp"
+
+namespace fastfps {
+
+// Binary file of a ModVec (native endian):
+//
+//   [0, 64)   ModVecFileHeader
+//   [64, ...) the blocks as they are in memory
+//
+// Each block is 8 u32 Montgomery residues (x * 2^32 mod MOD, in [0, 2 MOD)),
+// which is the layout of both the AVX2 and the scalar ModInt8 and of
+// DynModInt8. So saving and loading are plain copies with no conversion,
+// and the blocks of a mapped file are 64-byte aligned.
+struct ModVecFileHeader {
+    static constexpr std::array<char, 8> MAGIC = {'F', 'F', 'P', 'S',
+                                                  'M', 'V', 'E', 'C'};
+    static constexpr u32 VERSION = 1;
+    // representation of the blocks
+    static constexpr u32 MONTGOMERY32 = 1;
+
+    std::array<char, 8> magic = MAGIC;
+    u32 version = VERSION;
+    u32 repr = MONTGOMERY32;
+    u32 mod = 0;
+    u32 block_bytes = 32;
+    u64 n = 0;
+    std::array<char, 32> reserved{};
+};
+static_assert(sizeof(ModVecFileHeader) == 64);
+
+namespace internal {
+
+[[noreturn]] inline void throw_errno(const std::string& what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+// throws std::runtime_error unless h is a header of a file of file_bytes
+// bytes holding a ModVec of modint8
+template <class modint8>
+void check_header(const ModVecFileHeader& h,
+                  size_t file_bytes,
+                  const std::string& path) {
+    auto fail = [&](const std::string& msg) {
+        throw std::runtime_error(path + ": " + msg);
+    };
+    if (h.magic != ModVecFileHeader::MAGIC) fail("not a ModVec file");
+    if (h.version != ModVecFileHeader::VERSION) {
+        fail("unsupported version " + std::to_string(h.version));
+    }
+    if (h.repr != ModVecFileHeader::MONTGOMERY32 ||
+        h.block_bytes != sizeof(modint8)) {
+        fail("unsupported representation");
+    }
+    if (h.mod != modint8::mod()) {
+        fail("mod is " + std::to_string(h.mod) + ", expected " +
+             std::to_string(modint8::mod()));
+    }
+    if (file_bytes != sizeof(h) + (h.n + 7) / 8 * sizeof(modint8)) {
+        fail("size mismatch");
+    }
+}
+
+template <class modint8>
+void save_blocks(const std::string& path,
+                 ssize_t n,
+                 std::span<const modint8> blocks) {
+    static_assert(sizeof(modint8) == 32);
+    ModVecFileHeader h;
+    h.mod = modint8::mod();
+    h.n = u64(n);
+
+    FILE* fp = std::fopen(path.c_str(), "wb");
+    if (!fp) throw_errno("open " + path);
+    bool ok = std::fwrite(&h, sizeof(h), 1, fp) == 1;
+    // (no fwrite of an empty span, whose data() may be null)
+    if (ok && !blocks.empty()) {
+        ok = std::fwrite(blocks.data(), sizeof(modint8), blocks.size(), fp) ==
+             blocks.size();
+    }
+    ok = (std::fclose(fp) == 0) && ok;
+    if (!ok) throw_errno("write " + path);
+}
+
+}  // namespace internal
+
+// A ModVec file mapped with mmap(MAP_PRIVATE).
+// Opening is O(1) regardless of the size: a page is read when it is first
+// touched (e.g. by the fft of an expression using view()). Writes through
+// blocks() are copy-on-write and never reach the file.
+template <class _modint8> class BasicMappedModVec {
+  public:
+    using modint8 = _modint8;
+    using view_type = BasicModVecView<modint8>;
+
+    BasicMappedModVec() = default;
+    explicit BasicMappedModVec(const std::string& path) {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) internal::throw_errno("open " + path);
+        struct stat st;
+        if (::fstat(fd, &st) < 0) {
+            const int e = errno;
+            ::close(fd);
+            throw std::system_error(e, std::generic_category(),
+                                    "stat " + path);
+        }
+        bytes = size_t(st.st_size);
+        if (bytes < sizeof(ModVecFileHeader)) {
+            ::close(fd);
+            throw std::runtime_error(path + ": not a ModVec file");
+        }
+        addr = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                      fd, 0);
+        const int e = errno;
+        ::close(fd);
+        if (addr == MAP_FAILED) {
+            addr = nullptr;
+            throw std::system_error(e, std::generic_category(),
+                                    "mmap " + path);
+        }
+        try {
+            internal::check_header<modint8>(header(), bytes, path);
+        } catch (...) {
+            unmap();
+            throw;
+        }
+        n = ssize_t(header().n);
+    }
+    ~BasicMappedModVec() { unmap(); }
+
+    BasicMappedModVec(BasicMappedModVec&& rhs) noexcept
+        : addr(std::exchange(rhs.addr, nullptr)),
+          bytes(std::exchange(rhs.bytes, 0)),
+          n(std::exchange(rhs.n, 0)) {}
+    BasicMappedModVec& operator=(BasicMappedModVec&& rhs) noexcept {
+        if (this != &rhs) {
+            unmap();
+            addr = std::exchange(rhs.addr, nullptr);
+            bytes = std::exchange(rhs.bytes, 0);
+            n = std::exchange(rhs.n, 0);
+        }
+        return *this;
+    }
+    BasicMappedModVec(const BasicMappedModVec&) = delete;
+    BasicMappedModVec& operator=(const BasicMappedModVec&) = delete;
+
+    size_t size() const { return n; }
+
+    // same as BasicModVec::blocks
+    std::span<const modint8> blocks() const { return {data(), nblocks()}; }
+    std::span<modint8> blocks() { return {data(), nblocks()}; }
+
+    view_type view() const { return view_type(blocks(), 0, n); }
+    view_type view(ssize_t start, ssize_t len) const {
+        return view().subview(start, len);
+    }
+
+    u32 val(ssize_t index) const { return view().val(index); }
+    std::vector<u32> val() const { return view().val(); }
+
+  private:
+    void* addr = nullptr;
+    size_t bytes = 0;
+    ssize_t n = 0;
+
+    const ModVecFileHeader& header() const {
+        return *static_cast<const ModVecFileHeader*>(addr);
+    }
+    modint8* data() const {
+        if (!addr) return nullptr;
+        return reinterpret_cast<modint8*>(static_cast<char*>(addr) +
+                                          sizeof(ModVecFileHeader));
+    }
+    size_t nblocks() const { return (n + 7) / 8; }
+
+    void unmap() {
+        if (addr) ::munmap(addr, bytes);
+        addr = nullptr;
+    }
+};
+
+// writes the raw blocks of a to a file
+template <class modint8>
+void save_modvec(const BasicModVec<modint8>& a, const std::string& path) {
+    internal::save_blocks<modint8>(path, a.size(), a.blocks());
+}
+
+// maps a file written by save_modvec in O(1),
+// e.g. map_modvec<ModVec<MOD>>(path)
+template <class modvec>
+BasicMappedModVec<typename modvec::modint8> map_modvec(
+    const std::string& path) {
+    return BasicMappedModVec<typename modvec::modint8>(path);
+}
+
+// reads a file written by save_modvec
+template <class modvec> modvec load_modvec(const std::string& path) {
+    return modvec(map_modvec<modvec>(path).view());
+}
+
+}  // namespace fastfps
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <span>
+#include <vector>
+
+#include "fastfps/modvec_expr.hpp"
+#include "fastfps/types.hpp"
+
+namespace fastfps {
+
+template <class _modint8> struct BasicModVec;
+
+// Non-owning view of the coefficients [start, start + len) of a ModVec.
+// Making a view is O(1); a block of the view is two rotates and a blend of
+// the blocks of the ModVec if start is not a multiple of 8.
+// The view is invalidated when the ModVec is resized or destroyed.
+template <class _modint8> struct BasicModVecView {
+    using modint8 = _modint8;
+    using modint = typename modint8::modint;
+    using modvec = BasicModVec<modint8>;
+
+  public:
+    BasicModVecView() : p(nullptr), nb(0), off(0), n(0) {}
+    BasicModVecView(const modvec& a)
+        : BasicModVecView(a.blocks(), 0, a.size()) {}
+    // coefficients [start, start + len) of blocks b
+    BasicModVecView(std::span<const modint8> b, ssize_t start, ssize_t len)
+        : p(b.data() + start / 8),
+          nb(std::ssize(b) - start / 8),
+          off(start % 8),
+          n(len) {
+        assert(0 <= start && 0 <= len && start + len <= 8 * std::ssize(b));
+    }
+
+    size_t size() const { return n; }
+
+    BasicModVecView subview(ssize_t start, ssize_t len) const {
+        assert(0 <= start && 0 <= len && start + len <= n);
+        return BasicModVecView(std::span<const modint8>(p, nb), off + start,
+                               len);
+    }
+
+    u32 val(ssize_t index) const {
+        if (index < 0 || n <= index) return 0;
+        return p[(off + index) / 8].val()[(off + index) % 8];
+    }
+    std::vector<u32> val() const { return modvec(*this).val(); }
+
+    // the i-th block of the view, lanes at or after size() are 0
+    modint8 block(ssize_t i) const {
+        if (i < 0 || (n + 7) / 8 <= i) return modint8();
+        modint8 x = p[i];
+        if (off) {
+            x = x.rotate(u32(off));
+            if (i + 1 < nb) {
+                x = blendvar(x, p[i + 1].rotate(u32(off)),
+                             lanes_from(8 - off));
+            }
+        }
+        if (8 * (i + 1) > n) {
+            x = blendvar(x, modint8(), lanes_from(n - 8 * i));
+        }
+        return x;
+    }
+
+    // dst[dst_start .. dst_start + size()) = this
+    void copy_to(modvec& dst, ssize_t dst_start) const {
+        ssize_t start = off, len = n;
+        assert(0 <= dst_start && dst_start + len <= ssize_t(dst.size()));
+        auto dv = dst.blocks();
+        if (len == 0) return;
+
+        auto succ = [&](ssize_t len2) {
+            start += len2;
+            dst_start += len2;
+            len -= len2;
+        };
+        if (start % 8 == dst_start % 8) {
+            {
+                ssize_t len2 = std::min(len, 8 - dst_start % 8);
+                const auto mask = [&]() {
+                    std::array<u32, 8> b;
+                    for (int i = 0; i < 8; i++) {
+                        b[i] = (dst_start % 8 <= i && i < dst_start % 8 + len2);
+                    }
+                    return b;
+                }();
+                dv[dst_start / 8] =
+                    blendvar(dv[dst_start / 8], p[start / 8], mask);
+                succ(len2);
+            }
+            if (len == 0) return;
+            assert(start % 8 == 0 && dst_start % 8 == 0);
+            std::copy_n(p + start / 8, len / 8, dv.begin() + dst_start / 8);
+            succ(len / 8 * 8);
+            if (len == 0) return;
+            {
+                dv[dst_start / 8] = blendvar(dv[dst_start / 8], p[start / 8],
+                                             lanes_below(len));
+                succ(len);
+            }
+        } else {
+            const ssize_t shift = (start + 8 - dst_start % 8) % 8;
+            const auto blend_mask = lanes_from(8 - shift);
+            {
+                ssize_t len2 = std::min(len, 8 - dst_start % 8);
+                const auto mask = [&]() {
+                    std::array<u32, 8> b;
+                    for (int i = 0; i < 8; i++) {
+                        b[i] = (dst_start % 8 <= i && i < dst_start % 8 + len2);
+                    }
+                    return b;
+                }();
+                auto x = p[start / 8].rotate((u32)shift);
+                if (len2 > 8 - start % 8) {
+                    x = blendvar(x, p[start / 8 + 1].rotate((u32)(shift)),
+                                 blend_mask);
+                }
+                dv[dst_start / 8] = blendvar(dv[dst_start / 8], x, mask);
+                succ(len2);
+            }
+            if (len == 0) return;
+
+            while (len >= 8) {
+                modint8 l = p[start / 8], r = p[start / 8 + 1];
+                dv[dst_start / 8] = blendvar(
+                    l.rotate(u32(shift)), r.rotate(u32(shift)), blend_mask);
+                succ(8);
+            }
+            if (len == 0) return;
+            {
+                ssize_t len2 = len;
+                auto x = p[start / 8].rotate((u32)shift);
+                if (len2 > 8 - start % 8) {
+                    x = blendvar(x, p[start / 8 + 1].rotate((u32)(shift)),
+                                 blend_mask);
+                }
+                dv[dst_start / 8] =
+                    blendvar(dv[dst_start / 8], x, lanes_below(len2));
+                succ(len2);
+            }
+        }
+    }
+
+    // sum a[i] * b[i]
+    friend modint dot(const BasicModVecView& lhs, const BasicModVecView& rhs) {
+        modint8 sum;
+        const ssize_t m = std::min(lhs.n + 7, rhs.n + 7) / 8;
+        if (lhs.off == 0 && rhs.off == 0) {
+            // the lanes at or after size() of a ModVec are 0
+            for (ssize_t i = 0; i < m - 1; i++) {
+                sum += lhs.p[i] * rhs.p[i];
+            }
+            if (m) sum += lhs.block(m - 1) * rhs.block(m - 1);
+        } else {
+            for (ssize_t i = 0; i < m; i++) {
+                sum += lhs.block(i) * rhs.block(i);
+            }
+        }
+        modint ans;
+        for (u32 x : sum.val()) ans += x;
+        return ans;
+    }
+
+  private:
+    const modint8* p;
+    ssize_t nb;  // number of blocks from p
+    ssize_t off, n;
+
+    // lanes [k, 8)
+    static std::array<u32, 8> lanes_from(ssize_t k) {
+        std::array<u32, 8> b;
+        for (int i = 0; i < 8; i++) b[i] = (k <= i);
+        return b;
+    }
+    // lanes [0, k)
+    static std::array<u32, 8> lanes_below(ssize_t k) {
+        std::array<u32, 8> b;
+        for (int i = 0; i < 8; i++) b[i] = (i < k);
+        return b;
+    }
+};
+
+template <class view>
+struct ViewLeafExpr : ModVecExpr<ViewLeafExpr<view>, typename view::modvec> {
+    using modint8 = typename view::modint8;
+
+    explicit ViewLeafExpr(const view& _a) : a(_a) {}
+
+    ssize_t size() const { return a.size(); }
+    void count(ModVecExprContext<modint8>&) const {}
+    void prepare(ModVecExprContext<modint8>&) const {}
+    modint8 block(ssize_t i) const { return a.block(i); }
+    template <class modvec> bool steal(modvec&) { return false; }
+
+  private:
+    view a;
+};
+
+template <class modint8>
+struct is_modvec_view<BasicModVecView<modint8>> : std::true_type {};
+
+}  // namespace fastfps
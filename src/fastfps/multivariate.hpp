@@ -0,0 +1,124 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <vector>
+
+#include "fastfps/fft.hpp"
+#include "fastfps/modvec.hpp"
+
+namespace fastfps {
+
+// Truncated multivariate convolution, truncated in each variable (the box
+// i_l < n_l); see total_degree_convolution for the total degree.
+// The index i = i_1 + i_2 n_1 + i_3 n_1 n_2 + ... (0 <= i_j < n_j) represents
+// x_1^i_1 x_2^i_2 ..., and c[i] = sum a[j] b[k] over the pairs with
+// j_l + k_l = i_l for all l (no carry).
+//
+// With chi(i) = floor(i / n_1) + floor(i / n_1 n_2) + ... (mod k), a pair
+// has no carry iff chi(j) + chi(k) = chi(j + k) (mod k), so one 1-D product
+// with the extra variable t (t^k = 1) tracking chi is enough.
+template <class modint8>
+BasicModVec<modint8> multivariate_convolution(const BasicModVec<modint8>& a,
+                                              const BasicModVec<modint8>& b,
+                                              const std::vector<int>& base) {
+    using modint = typename modint8::modint;
+
+    ssize_t n = 1;
+    for (int x : base) n *= x;
+    assert(ssize_t(a.size()) == n && ssize_t(b.size()) == n);
+    const int k = std::max(1, int(base.size()));
+
+    const ssize_t nb = (n + 7) / 8;
+    std::vector<int> chi(8 * nb, -1);
+    for (ssize_t i = 0; i < n; i++) {
+        chi[i] = 0;
+        ssize_t prod = 1;
+        for (int j = 0; j + 1 < int(base.size()); j++) {
+            prod *= base[j];
+            chi[i] += int(i / prod);
+        }
+        chi[i] %= k;
+    }
+    auto mask = [&](ssize_t i, int c) {
+        std::array<u32, 8> m;
+        for (int j = 0; j < 8; j++) {
+            m[j] = (chi[8 * i + j] == c);
+        }
+        return m;
+    };
+
+    const ssize_t m = (ssize_t)std::bit_ceil((size_t)(2 * nb));
+    auto split = [&](const BasicModVec<modint8>& f) {
+        std::vector<std::vector<modint8>> g(k, std::vector<modint8>(m));
+        auto v = f.blocks();
+        for (int c = 0; c < k; c++) {
+            for (ssize_t i = 0; i < nb; i++) {
+                g[c][i] = blendvar(modint8(), v[i], mask(i, c));
+            }
+            fft(g[c]);
+        }
+        return g;
+    };
+    const auto fa = split(a), fb = split(b);
+
+    BasicModVec<modint8> res(n);
+    auto v = res.blocks();
+    const modint8 inv = modint8::set1(modint(8 * m).inv());
+    std::vector<modint8> h(m);
+    for (int c = 0; c < k; c++) {
+        for (ssize_t i = 0; i < m; i++) {
+            h[i] = fa[0][i] * fb[c][i];
+        }
+        for (int x = 1; x < k; x++) {
+            const auto& gb = fb[(c - x + k) % k];
+            for (ssize_t i = 0; i < m; i++) {
+                h[i] += fa[x][i] * gb[i];
+            }
+        }
+        ifft(h);
+        for (ssize_t i = 0; i < nb; i++) {
+            v[i] = blendvar(v[i], h[i] * inv, mask(i, c));
+        }
+    }
+    return res;
+}
+
+// Product of polynomials in d variables truncated to total degree < n.
+// a and b use the layout of multivariate_convolution with base {n, ..., n}
+// (size n^d); their coefficients of total degree >= n are ignored, and those
+// of the result are 0.
+// A pair with |j + k| < n has j_l + k_l < n for every l, so this is the box
+// product restricted to total degree < n. It costs the box of n^d terms,
+// d! times the C(n + d - 1, d) monomials of degree < n for large n.
+template <class modint8>
+BasicModVec<modint8> total_degree_convolution(const BasicModVec<modint8>& a,
+                                              const BasicModVec<modint8>& b,
+                                              int n,
+                                              int d) {
+    assert(n >= 1 && d >= 0);
+    auto res = multivariate_convolution(a, b, std::vector<int>(d, n));
+
+    auto v = res.blocks();
+    std::vector<int> digits(d);
+    int deg = 0;
+    for (ssize_t i = 0; i < std::ssize(v); i++) {
+        std::array<u32, 8> m{};
+        for (int j = 0; j < 8 && 8 * i + j < ssize_t(res.size()); j++) {
+            m[j] = deg < n;
+            // next index: increments the digits in base n
+            for (int l = 0; l < d; l++) {
+                deg++;
+                if (++digits[l] < n) break;
+                deg -= n;
+                digits[l] = 0;
+            }
+        }
+        v[i] = blendvar(modint8(), v[i], m);
+    }
+    return res;
+}
+
+}  // namespace fastfps
@@ -0,0 +1,286 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "fastfps/types.hpp"
+
+namespace fastfps {
+
+namespace internal {
+
+// A task of the thread pool, owned by the thread that waits for it
+struct Task {
+    template <class F>
+    explicit Task(F& f)
+        : run([](void* p) { (*static_cast<F*>(p))(); }),
+          arg(const_cast<void*>(static_cast<const void*>(&f))) {}
+
+    void (*run)(void*);
+    void* arg;
+    std::atomic<bool> done = false;
+    // the exception thrown by the task, rethrown by its owner
+    std::exception_ptr error;
+};
+
+// Work-stealing thread pool
+//
+// Each worker has its own deque: it pushes and pops its tasks at the back
+// and the idle threads steal from the front, so a divide and conquer is
+// split at the top levels first. Other threads (e.g. the main thread) share
+// the deque 0. A thread waiting for a task runs other tasks in the
+// meantime, so tasks may wait for nested tasks without deadlock, and
+// sleeps when there is nothing to run.
+//
+// Scratch memory (Workspace) and the FFT tables are thread_local, so each
+// worker has its own arena, reused by the tasks it runs.
+class ThreadPool {
+  public:
+    // the pool of parallel_invoke / parallel_for: FASTFPS_NUM_THREADS or
+    // hardware_concurrency() threads by default
+    // (thread-safe: the first calls from several threads build one pool)
+    static ThreadPool& global() {
+        auto& g = global_state();
+        if (ThreadPool* p = g.current.load(std::memory_order_acquire)) {
+            return *p;
+        }
+        std::lock_guard lock(g.mtx);
+        if (!g.pool) {
+            g.pool = std::make_unique<ThreadPool>(default_size());
+            g.current.store(g.pool.get(), std::memory_order_release);
+        }
+        return *g.pool;
+    }
+    static void reset_global(int n) {
+        auto& g = global_state();
+        std::lock_guard lock(g.mtx);
+        g.current.store(nullptr, std::memory_order_release);
+        g.pool.reset();
+        g.pool = std::make_unique<ThreadPool>(n);
+        g.current.store(g.pool.get(), std::memory_order_release);
+    }
+
+    explicit ThreadPool(int n) : queues(n) {
+        for (int i = 1; i < n; i++) {
+            workers.emplace_back([this, i] {
+                owner = this;
+                index = i;
+                work();
+            });
+        }
+    }
+    ~ThreadPool() {
+        {
+            std::lock_guard lock(sleep_mtx);
+            stop = true;
+        }
+        sleep_cv.notify_all();
+        for (auto& t : workers) t.join();
+    }
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // the number of threads, including the caller
+    int size() const { return int(queues.size()); }
+
+    void push(Task* t) {
+        auto& q = queues[self()];
+        {
+            std::lock_guard lock(q.mtx);
+            q.tasks.push_back(t);
+        }
+        queued++;
+        if (sleepers > 0 || waiters > 0) {
+            { std::lock_guard lock(sleep_mtx); }
+            sleep_cv.notify_one();
+        }
+    }
+
+    // runs other tasks until t is done
+    void wait(const Task& t) {
+        for (int idle = 0; !t.done.load(std::memory_order_acquire);) {
+            if (Task* u = take()) {
+                run(u);
+                idle = 0;
+            } else if (++idle <= SPINS) {
+                std::this_thread::yield();
+            } else {
+                // until t is done or there is a task to steal
+                std::unique_lock lock(sleep_mtx);
+                waiters++;
+                sleep_cv.wait(lock, [&] { return t.done || queued > 0; });
+                waiters--;
+                idle = 0;
+            }
+        }
+    }
+
+  private:
+    struct Queue {
+        std::mutex mtx;
+        std::deque<Task*> tasks;
+    };
+    std::vector<Queue> queues;
+    std::vector<std::thread> workers;
+    std::atomic<ssize_t> queued = 0;
+    std::atomic<int> sleepers = 0;
+    // threads sleeping in wait()
+    std::atomic<int> waiters = 0;
+    std::mutex sleep_mtx;
+    std::condition_variable sleep_cv;
+    bool stop = false;
+
+    // yields of wait() before it sleeps: a short task is waited for without
+    // the latency of a wakeup
+    static constexpr int SPINS = 64;
+
+    static inline thread_local ThreadPool* owner = nullptr;
+    static inline thread_local int index = 0;
+
+    // the global pool, created under mtx and read through current
+    struct GlobalState {
+        std::mutex mtx;
+        std::unique_ptr<ThreadPool> pool;
+        std::atomic<ThreadPool*> current = nullptr;
+    };
+    static GlobalState& global_state() {
+        static GlobalState g;
+        return g;
+    }
+    static int default_size() {
+        if (const char* s = std::getenv("FASTFPS_NUM_THREADS")) {
+            if (const int n = std::atoi(s); n >= 1) return n;
+        }
+        return std::max(1, int(std::thread::hardware_concurrency()));
+    }
+
+    int self() const { return owner == this ? index : 0; }
+
+    void run(Task* t) {
+        try {
+            t->run(t->arg);
+        } catch (...) {
+            t->error = std::current_exception();
+        }
+        // t may be gone once done is set
+        t->done = true;
+        if (waiters > 0) {
+            { std::lock_guard lock(sleep_mtx); }
+            sleep_cv.notify_all();
+        }
+    }
+
+    // the back of the own deque, or the front of another one
+    Task* take() {
+        if (queued == 0) return nullptr;
+        const int me = self(), n = size();
+        for (int k = 0; k < n; k++) {
+            auto& q = queues[(me + k) % n];
+            std::lock_guard lock(q.mtx);
+            if (q.tasks.empty()) continue;
+            Task* t;
+            if (k == 0) {
+                t = q.tasks.back();
+                q.tasks.pop_back();
+            } else {
+                t = q.tasks.front();
+                q.tasks.pop_front();
+            }
+            queued--;
+            return t;
+        }
+        return nullptr;
+    }
+
+    void work() {
+        while (true) {
+            if (Task* t = take()) {
+                run(t);
+                continue;
+            }
+            std::unique_lock lock(sleep_mtx);
+            sleepers++;
+            sleep_cv.wait(lock, [&] { return stop || queued > 0; });
+            sleepers--;
+            if (stop) return;
+        }
+    }
+};
+
+// parallel_invoke with g queued in pool (out of line, so the recursion of
+// parallel_invoke with one thread stays small)
+template <class F, class G>
+[[gnu::noinline]] void invoke_pooled(ThreadPool& pool, F& f, G& g) {
+    Task t(g);
+    pool.push(&t);
+    try {
+        f();
+    } catch (...) {
+        // t is on this stack frame: the pool must be done with it
+        pool.wait(t);
+        throw;
+    }
+    pool.wait(t);
+    if (t.error) std::rethrow_exception(t.error);
+}
+
+}  // namespace internal
+
+// the number of threads of parallel_invoke / parallel_for, including the
+// caller
+inline int num_threads() { return internal::ThreadPool::global().size(); }
+// n >= 1, must not be called while the pool is running tasks
+inline void set_num_threads(int n) {
+    assert(n >= 1);
+    internal::ThreadPool::reset_global(n);
+}
+
+// f() and g(), possibly concurrently. Returns after both finish.
+// An exception of f or g is rethrown once neither of them is running (that
+// of f if both throw; with one thread, g is not called if f throws).
+template <class F, class G> void parallel_invoke(F&& f, G&& g) {
+    auto& pool = internal::ThreadPool::global();
+    if (pool.size() == 1) {
+        f();
+        g();
+        return;
+    }
+    internal::invoke_pooled(pool, f, g);
+}
+
+namespace internal {
+
+template <class F>
+void parallel_for(ssize_t l, ssize_t r, F& f, ssize_t grain) {
+    if (r - l <= grain) {
+        for (ssize_t i = l; i < r; i++) f(i);
+        return;
+    }
+    const ssize_t m = l + (r - l) / 2;
+    parallel_invoke([&] { parallel_for(l, m, f, grain); },
+                    [&] { parallel_for(m, r, f, grain); });
+}
+
+}  // namespace internal
+
+// f(0), f(1), ..., f(n - 1), possibly concurrently. Returns after all of
+// them finish.
+//
+// The range is halved recursively (so idle threads steal large halves)
+// down to grain indices, which run inline one after another.
+template <class F> void parallel_for(ssize_t n, F&& f, ssize_t grain = 1) {
+    assert(grain >= 1);
+    if (num_threads() == 1) grain = n;
+    internal::parallel_for(0, n, f, grain);
+}
+
+}  // namespace fastfps
@@ -0,0 +1,314 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <optional>
+#include <random>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "fastfps/allocator.hpp"
+#include "fastfps/dynmodint8.hpp"
+#include "fastfps/modint8.hpp"
+#include "fastfps/modmatrix.hpp"
+#include "fastfps/modvec.hpp"
+#include "fastfps/types.hpp"
+
+namespace fastfps {
+
+// h x w sparse matrix in CSR form
+//
+// For the product, the rows are also grouped by 8 (SELL-8): slice s holds
+// the rows [8s, 8s + 8) padded to the longest of them, as lane-interleaved
+// column indices and values, so that each step of
+//   y[8s, 8s + 8) = sum_k val[k] x[col[k]]
+// is one ModInt8 gather and multiplication.
+template <class _modint8> struct BasicSparseMatrix {
+    using modint8 = _modint8;
+    using modint = typename modint8::modint;
+    using modvec = BasicModVec<modint8>;
+
+    struct Entry {
+        ssize_t row, col;
+        modint value;
+    };
+
+  public:
+    BasicSparseMatrix() : BasicSparseMatrix(0, 0, {}) {}
+    // entries in any order, values at the same position are summed
+    BasicSparseMatrix(ssize_t _h, ssize_t _w, std::vector<Entry> e)
+        : h(_h), w(_w), row_start(h + 1) {
+        std::ranges::stable_sort(e, {}, [](const Entry& x) {
+            return std::pair(x.row, x.col);
+        });
+        for (ssize_t i = 0; i < std::ssize(e); i++) {
+            const auto& x = e[i];
+            assert(0 <= x.row && x.row < h && 0 <= x.col && x.col < w);
+            const bool same = i && e[i - 1].row == x.row &&
+                              e[i - 1].col == x.col;
+            if (same) {
+                vals.back() += x.value;
+            } else {
+                row_start[x.row + 1]++;
+                cols.push_back(u32(x.col));
+                vals.push_back(x.value);
+            }
+        }
+        for (ssize_t i = 0; i < h; i++) row_start[i + 1] += row_start[i];
+        drop_zeros();
+        build_slices();
+    }
+
+    ssize_t height() const { return h; }
+    ssize_t width() const { return w; }
+    // the number of nonzero entries
+    ssize_t nonzeros() const { return std::ssize(vals); }
+
+    // the nonzero entries in row-major order
+    std::vector<Entry> entries() const {
+        std::vector<Entry> e;
+        for (ssize_t i = 0; i < h; i++) {
+            for (ssize_t k = row_start[i]; k < row_start[i + 1]; k++) {
+                e.push_back({i, cols[k], vals[k]});
+            }
+        }
+        return e;
+    }
+
+    BasicModMatrix<modint8> dense() const {
+        std::vector<std::vector<u32>> a(h, std::vector<u32>(w));
+        for (const auto& x : entries()) a[x.row][x.col] = x.value.val();
+        return w ? BasicModMatrix<modint8>(a) : BasicModMatrix<modint8>(h, w);
+    }
+
+    // A x (x is zero-extended or truncated to w)
+    modvec operator*(const modvec& x) const {
+        std::vector<modint> xs(8 * vsize(w));
+        const auto xb = x.blocks();
+        for (ssize_t i = 0; i < std::min(std::ssize(xb), vsize(w)); i++) {
+            xb[i].store(std::span(xs).subspan(8 * i).template first<8>());
+        }
+        modvec y(h);
+        mul(xs, y.blocks());
+        return y;
+    }
+
+    // y[i / 8][i % 8] = (A x)[i] for the ModInt array x (|x| >= w) and
+    // vsize(h) blocks y
+    void mul(std::span<const modint> x, std::span<modint8> y) const {
+        for (ssize_t s = 0; s < std::ssize(y); s++) {
+            modint8 sum;
+            for (ssize_t k = slice_start[s]; k < slice_start[s + 1]; k++) {
+                sum += slice_vals[k] * modint8::gather(x, slice_cols[k]);
+            }
+            y[s] = sum;
+        }
+    }
+
+  private:
+    ssize_t h, w;
+    // CSR: row i is cols / vals [row_start[i], row_start[i + 1])
+    std::vector<ssize_t> row_start;
+    std::vector<u32> cols;
+    std::vector<modint> vals;
+    // SELL-8: slice s is [slice_start[s], slice_start[s + 1])
+    std::vector<ssize_t> slice_start;
+    std::vector<std::array<u32, 8>> slice_cols;
+    std::vector<modint8, AlignedAllocator<modint8>> slice_vals;
+
+    static ssize_t vsize(ssize_t n) { return (n + 7) / 8; }
+
+    void drop_zeros() {
+        ssize_t k = 0;
+        for (ssize_t i = 0; i < h; i++) {
+            const ssize_t start = row_start[i];
+            row_start[i] = k;
+            for (ssize_t j = start; j < row_start[i + 1]; j++) {
+                if (vals[j] == modint(0)) continue;
+                cols[k] = cols[j];
+                vals[k] = vals[j];
+                k++;
+            }
+        }
+        row_start[h] = k;
+        cols.resize(k);
+        vals.resize(k);
+    }
+
+    void build_slices() {
+        const ssize_t ns = vsize(h);
+        slice_start.assign(ns + 1, 0);
+        auto len = [&](ssize_t i) {
+            return i < h ? row_start[i + 1] - row_start[i] : ssize_t(0);
+        };
+        for (ssize_t s = 0; s < ns; s++) {
+            ssize_t m = 0;
+            for (ssize_t j = 0; j < 8; j++) m = std::max(m, len(8 * s + j));
+            slice_start[s + 1] = slice_start[s] + m;
+        }
+        slice_cols.resize(slice_start[ns]);
+        slice_vals.resize(slice_start[ns]);
+        for (ssize_t s = 0; s < ns; s++) {
+            for (ssize_t k = 0; k < slice_start[s + 1] - slice_start[s]; k++) {
+                std::array<u32, 8> c{};
+                std::array<modint, 8> v{};
+                for (ssize_t j = 0; j < 8; j++) {
+                    const ssize_t i = 8 * s + j;
+                    if (k >= len(i)) continue;
+                    c[j] = cols[row_start[i] + k];
+                    v[j] = vals[row_start[i] + k];
+                }
+                slice_cols[slice_start[s] + k] = c;
+                slice_vals[slice_start[s] + k] = modint8(v);
+            }
+        }
+    }
+};
+
+template <int MOD> using SparseMatrix = BasicSparseMatrix<ModInt8<MOD>>;
+template <int id> using DynSparseMatrix = BasicSparseMatrix<DynModInt8<id>>;
+
+namespace internal {
+
+template <class modvec> modvec random_modvec(ssize_t n, std::mt19937_64& mt) {
+    const u32 mod = modvec::modint8::mod();
+    std::vector<u32> a(n);
+    for (auto& x : a) x = u32(mt() % mod);
+    return modvec(a);
+}
+
+// s[i] = u . A^i b (i < len)
+template <class sparse, class modvec>
+modvec krylov_sequence(const sparse& a,
+                       const modvec& u,
+                       const modvec& b,
+                       ssize_t len) {
+    using modint8 = typename modvec::modint8;
+    using modint = typename modint8::modint;
+    const ssize_t n = a.width(), nb = (n + 7) / 8;
+    Workspace::Frame frame;
+    auto xs = frame.alloc<modint>(8 * nb);
+    auto x = frame.alloc<modint8>(nb);
+    std::ranges::copy(b.blocks(), x.begin());
+    const auto ub = u.blocks();
+    std::vector<modint> s(len);
+    for (ssize_t i = 0; i < len; i++) {
+        modint8 sum;
+        for (ssize_t j = 0; j < nb; j++) sum += ub[j] * x[j];
+        std::array<modint, 8> t;
+        sum.store(t);
+        for (const auto& y : t) s[i] += y;
+        if (i + 1 == len) break;
+        for (ssize_t j = 0; j < nb; j++) {
+            x[j].store(xs.subspan(8 * j).template first<8>());
+        }
+        a.mul(xs, x);
+    }
+    return modvec(s);
+}
+
+// c of berlekamp_massey: c[0] = -1 and sum_j c[j] s[i - j] = 0
+template <class sparse, class modvec>
+modvec minimal_recurrence(const sparse& a,
+                          const modvec& b,
+                          std::mt19937_64& mt) {
+    const ssize_t n = a.height();
+    const modvec u = random_modvec<modvec>(n, mt);
+    return krylov_sequence(a, u, b, 2 * n).berlekamp_massey();
+}
+
+}  // namespace internal
+
+// The minimal polynomial of A (monic, the coefficients from x^0), which is
+// found from u . A^i b for random u, b. It is correct with probability at
+// least 1 - 2 deg / MOD (otherwise it is a proper divisor).
+template <class modint8>
+BasicModVec<modint8> wiedemann_minpoly(const BasicSparseMatrix<modint8>& a,
+                                       u64 seed = 1) {
+    using modvec = BasicModVec<modint8>;
+    assert(a.height() == a.width());
+    std::mt19937_64 mt(seed);
+    const modvec b = internal::random_modvec<modvec>(a.height(), mt);
+    // x^d - c[1] x^(d-1) - ... - c[d]
+    modvec m = internal::minimal_recurrence(a, b, mt);
+    m.reverse();
+    m *= typename modint8::modint(-1);
+    return m;
+}
+
+// x with A x = b for a regular A, or nullopt if A is singular (or the
+// random projections failed 3 times)
+//
+// With the minimal polynomial m of the sequence u . A^i b, m(A) b = 0
+// w.h.p., so x = -(1 / m[0]) sum_{k > 0} m[k] A^(k-1) b. The result is
+// checked by A x = b.
+template <class modint8>
+std::optional<BasicModVec<modint8>> wiedemann_solve(
+    const BasicSparseMatrix<modint8>& a,
+    const BasicModVec<modint8>& b,
+    u64 seed = 1) {
+    using modvec = BasicModVec<modint8>;
+    using modint = typename modint8::modint;
+    const ssize_t n = a.height();
+    assert(n == a.width());
+    modvec b0 = b;
+    b0.resize(n);
+    std::mt19937_64 mt(seed);
+    for (int t = 0; t < 3; t++) {
+        const modvec c = internal::minimal_recurrence(a, b0, mt);
+        const ssize_t d = std::ssize(c) - 1;
+        // m[k] = -c[d - k]
+        const modint cd = modint(c.val(d));
+        if (d && cd == modint(0)) continue;
+        modvec x(n), v = b0;
+        const modint r = modint(0) - cd.inv();
+        for (ssize_t k = 1; k <= d; k++) {
+            x += v * (r * modint(c.val(d - k)));
+            if (k < d) v = a * v;
+        }
+        if (a * x == b0) return x;
+    }
+    return std::nullopt;
+}
+
+// det A
+//
+// A D for a random diagonal D has a squarefree characteristic polynomial
+// w.h.p. if A is regular, and then it is the minimal polynomial of the
+// sequence u . (A D)^i b. If no try finds a minimal
+// polynomial of degree n, A is singular w.h.p.
+template <class modint8>
+typename modint8::modint wiedemann_det(const BasicSparseMatrix<modint8>& a,
+                                       u64 seed = 1) {
+    using modvec = BasicModVec<modint8>;
+    using modint = typename modint8::modint;
+    using sparse = BasicSparseMatrix<modint8>;
+    const ssize_t n = a.height();
+    assert(n == a.width());
+    const u32 mod = modint8::mod();
+    std::mt19937_64 mt(seed);
+    for (int t = 0; t < 3; t++) {
+        std::vector<modint> d(n);
+        modint prod_d = 1;
+        for (auto& x : d) {
+            x = modint(u32(mt() % (mod - 1) + 1));
+            prod_d *= x;
+        }
+        auto e = a.entries();
+        for (auto& x : e) x.value *= d[x.col];
+        const sparse ad(n, n, std::move(e));
+
+        const modvec b = internal::random_modvec<modvec>(n, mt);
+        const modvec c = internal::minimal_recurrence(ad, b, mt);
+        if (std::ssize(c) - 1 < n) continue;
+        // det(A D) = (-1)^n m(0) = (-1)^(n+1) c[n]
+        modint det = modint(c.val(n)) * prod_d.inv();
+        if (n % 2 == 0) det = modint(0) - det;
+        return det;
+    }
+    return modint(0);
+}
+
+}  // namespace fastfps
@@ -0,0 +1,358 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "fastfps/allocator.hpp"
+#include "fastfps/factorial.hpp"
+#include "fastfps/types.hpp"
+
+namespace fastfps {
+
+template <class _modint8> struct BasicModVec;
+
+// Power series with a few nonzero coefficients, as (index, value) pairs
+// sorted by index. sparse_inv / sparse_exp / sparse_log / sparse_pow of a
+// series with k terms are O(nk) and return a dense ModVec.
+template <class _modint8> struct BasicSparseModVec {
+    using modint8 = _modint8;
+    using modint = typename modint8::modint;
+    using modvec = BasicModVec<modint8>;
+
+    struct Term {
+        ssize_t index;
+        modint value;
+    };
+
+  public:
+    BasicSparseModVec() = default;
+    // terms in any order, values of the same index are summed
+    BasicSparseModVec(std::vector<Term> _t) : t(std::move(_t)) {
+        std::ranges::stable_sort(t, {}, &Term::index);
+        std::vector<Term> u;
+        for (const auto& x : t) {
+            assert(0 <= x.index);
+            if (!u.empty() && u.back().index == x.index) {
+                u.back().value += x.value;
+            } else {
+                u.push_back(x);
+            }
+        }
+        std::erase_if(u, [](const Term& x) { return x.value == modint(0); });
+        t = std::move(u);
+    }
+    // the nonzero coefficients of a
+    explicit BasicSparseModVec(const modvec& a) {
+        const auto v = a.blocks();
+        for (ssize_t i = 0; i < std::ssize(v); i++) {
+            if (v[i] == modint8()) continue;
+            const auto x = v[i].val();
+            for (ssize_t j = 0; j < 8; j++) {
+                if (x[j]) t.push_back({8 * i + j, modint(x[j])});
+            }
+        }
+    }
+
+    // the number of terms
+    size_t size() const { return t.size(); }
+    std::span<const Term> terms() const { return t; }
+
+    // the coefficient of x^index
+    u32 val(ssize_t index) const {
+        auto it = std::ranges::lower_bound(t, index, {}, &Term::index);
+        return (it != t.end() && it->index == index) ? it->value.val() : 0;
+    }
+
+    // the coefficients [0, n)
+    modvec dense(ssize_t n) const {
+        std::vector<modint> a(n);
+        for (const auto& x : t) {
+            if (x.index < n) a[x.index] = x.value;
+        }
+        return modvec(a);
+    }
+
+    friend bool operator==(const BasicSparseModVec& lhs,
+                           const BasicSparseModVec& rhs) {
+        return std::ranges::equal(lhs.t, rhs.t, [](const Term& l,
+                                                   const Term& r) {
+            return l.index == r.index && l.value == r.value;
+        });
+    }
+
+  private:
+    std::vector<Term> t;
+};
+
+namespace internal {
+
+// the nonzero coefficients [0, n) of a, or nullopt if there are more than
+// max_terms of them
+template <class modvec>
+std::optional<BasicSparseModVec<typename modvec::modint8>>
+find_sparse(const modvec& a, ssize_t n, ssize_t max_terms) {
+    using modint8 = typename modvec::modint8;
+    using sparse = BasicSparseModVec<modint8>;
+    using modint = typename modint8::modint;
+    std::vector<typename sparse::Term> t;
+    const auto v = a.blocks();
+    const ssize_t nb = std::min<ssize_t>(std::ssize(v), (n + 7) / 8);
+    for (ssize_t i = 0; i < nb; i++) {
+        if (v[i] == modint8()) continue;
+        const auto x = v[i].val();
+        for (ssize_t j = 0; j < 8 && 8 * i + j < n; j++) {
+            if (!x[j]) continue;
+            if (std::ssize(t) == max_terms) return std::nullopt;
+            t.push_back({8 * i + j, modint(x[j])});
+        }
+    }
+    return sparse(std::move(t));
+}
+
+// a coefficient a + i b of t[i - j]
+template <class modint8> struct RecurrenceTerm {
+    using modint = typename modint8::modint;
+    ssize_t j;
+    modint a, b;
+};
+
+// t[i] <- w[i] (t[i] + sum_j (a_j + i b_j) t[i - j]) for i = 0, 1, ...
+// in place, over the terms with 0 < j in increasing order. b_j are used
+// only if linear is true.
+//
+// For the block of t[8k, 8k + 8), the terms with 8 <= j <= 8k only read
+// the previous blocks, so they are summed with ModInt8 (a load and a
+// multiplication per term). The other terms, j < 8 and at most a block of
+// 8k < j, are summed lane by lane.
+template <class modint8>
+void sparse_recurrence(std::span<modint8> t,
+                       std::span<const modint8> w,
+                       const std::vector<RecurrenceTerm<modint8>>& terms,
+                       bool linear) {
+    using modint = typename modint8::modint;
+    const ssize_t nb = std::ssize(t), m = std::ssize(terms);
+    assert(std::ssize(w) == nb);
+    assert(std::ranges::is_sorted(terms, {}, &RecurrenceTerm<modint8>::j));
+    // t[8k - j, 8k - j + 8) = sh[r][k - ceil(j / 8)] with r = -j mod 8,
+    // sh[r][q] = t[8q + r, 8q + r + 8) (sh[0] = t). sh[r] is kept only for
+    // the r of the terms, so that a term is an aligned load.
+    Workspace::Frame frame;
+    std::array<std::span<modint8>, 8> sh;
+    sh[0] = t;
+    std::array<std::array<u32, 8>, 8> mask;
+    std::vector<modint8> a8(m), b8(m);
+    std::vector<const modint8*> src(m);
+    std::vector<ssize_t> back(m);
+    for (ssize_t x = 0; x < m; x++) {
+        const ssize_t j = terms[x].j, r = (8 - j % 8) % 8;
+        assert(0 < j);
+        a8[x] = modint8::set1(terms[x].a);
+        b8[x] = modint8::set1(terms[x].b);
+        if (j >= 8 && sh[r].empty()) sh[r] = frame.alloc<modint8>(nb);
+        src[x] = sh[r].data();
+        back[x] = (j + 7) / 8;
+    }
+    for (u32 r = 0; r < 8; r++) {
+        for (u32 l = 0; l < 8; l++) mask[r][l] = (l < r);
+    }
+    // [0, near): j < 8, [near, far): 8 <= j <= 8k,
+    // [far, mid): 8k < j < 8k + 8
+    const ssize_t near = std::ranges::partition_point(
+                             terms, [](const auto& x) { return x.j < 8; }) -
+                         terms.begin();
+    ssize_t far = near, mid = near;
+
+    std::array<modint, 8> first{}, prev{}, cur{};
+    auto idx = modint8(modint(0), modint(1), modint(2), modint(3), modint(4),
+                       modint(5), modint(6), modint(7));
+    const auto step = modint8::set1(8);
+    for (ssize_t k = 0; k < nb; k++) {
+        while (far < m && terms[far].j <= 8 * k) far++;
+        mid = std::max(mid, far);
+        while (mid < m && terms[mid].j < 8 * k + 8) mid++;
+
+        modint8 sa, sb;
+        for (ssize_t x = near; x < far; x++) {
+            const modint8 y = src[x][k - back[x]];
+            sa += a8[x] * y;
+            if (linear) sb += b8[x] * y;
+        }
+        if (linear) sa += idx * sb;
+        sa += t[k];
+
+        const auto s = sa.val(), wv = w[k].val();
+        for (ssize_t l = 0; l < 8; l++) {
+            const ssize_t i = 8 * k + l;
+            const modint mi = modint(i);
+            modint acc = modint(s[l]);
+            auto add = [&](const RecurrenceTerm<modint8>& x, modint y) {
+                acc += (linear ? x.a + mi * x.b : x.a) * y;
+            };
+            for (ssize_t x = 0; x < near && terms[x].j <= i; x++) {
+                const ssize_t d = l - terms[x].j;
+                add(terms[x], d >= 0 ? cur[d] : prev[d + 8]);
+            }
+            for (ssize_t x = far; x < mid && terms[x].j <= i; x++) {
+                add(terms[x], first[i - terms[x].j]);
+            }
+            cur[l] = acc * modint(wv[l]);
+        }
+        t[k] = modint8(cur);
+        if (k) {
+            for (u32 r = 1; r < 8; r++) {
+                if (sh[r].empty()) continue;
+                sh[r][k - 1] = blendvar(t[k - 1], t[k], mask[r]).rotate(r);
+            }
+        }
+        prev = cur;
+        if (k == 0) first = cur;
+        idx += step;
+    }
+}
+
+template <class modint8> struct SparseRecurrence {
+    using modint = typename modint8::modint;
+    using modvec = BasicModVec<modint8>;
+
+    Workspace::Frame frame;
+    modvec t;
+    std::span<modint8> w;
+    std::vector<RecurrenceTerm<modint8>> terms;
+    bool linear = false;
+
+    explicit SparseRecurrence(ssize_t n)
+        : t(n), w(frame.alloc<modint8>(t.blocks().size())) {}
+
+    // w[i] = c, or c / i for i > 0 (w[0] = 1)
+    void set_weight(modint c, bool div_i) {
+        if (div_i) {
+            fill_inverses(w);
+            for (auto& x : w) x *= modint8::set1(c);
+            w[0] = blend<0b00000001>(w[0], modint8::set1(1));
+        } else {
+            std::ranges::fill(w, modint8::set1(c));
+        }
+    }
+
+    modvec run() {
+        sparse_recurrence<modint8>(t.blocks(), w, terms, linear);
+        t.resize(t.size());
+        return std::move(t);
+    }
+};
+
+}  // namespace internal
+
+// 1 / f mod x^n, f[0] != 0
+// f g = 1: g[i] = -(sum_{j > 0} f[j] g[i - j]) / f[0]
+template <class modint8>
+BasicModVec<modint8> sparse_inv(const BasicSparseModVec<modint8>& f,
+                                ssize_t n) {
+    using modint = typename modint8::modint;
+    const auto t = f.terms();
+    assert(!t.empty() && t[0].index == 0);
+    internal::SparseRecurrence<modint8> r(n);
+    if (n == 0) return r.t;
+    r.t.blocks()[0] = blend<0b00000001>(modint8(), modint8::set1(1));
+    r.set_weight(t[0].value.inv(), false);
+    for (const auto& x : t.subspan(1)) {
+        if (x.index < n) {
+            r.terms.push_back({x.index, modint() - x.value, modint()});
+        }
+    }
+    return r.run();
+}
+
+// exp f mod x^n, f[0] = 0
+// g' = f' g: i g[i] = sum_{j > 0} j f[j] g[i - j]
+template <class modint8>
+BasicModVec<modint8> sparse_exp(const BasicSparseModVec<modint8>& f,
+                                ssize_t n) {
+    using modint = typename modint8::modint;
+    assert(f.val(0) == 0);
+    internal::SparseRecurrence<modint8> r(n);
+    if (n == 0) return r.t;
+    r.t.blocks()[0] = blend<0b00000001>(modint8(), modint8::set1(1));
+    r.set_weight(1, true);
+    for (const auto& x : f.terms()) {
+        if (x.index < n) {
+            r.terms.push_back({x.index, modint(x.index) * x.value, modint()});
+        }
+    }
+    return r.run();
+}
+
+// log f mod x^n, f[0] = 1
+// f' = g' f: i g[i] = i f[i] - sum_{j > 0} f[j] (i - j) g[i - j]
+template <class modint8>
+BasicModVec<modint8> sparse_log(const BasicSparseModVec<modint8>& f,
+                                ssize_t n) {
+    using modint = typename modint8::modint;
+    assert(f.val(0) == 1);
+    internal::SparseRecurrence<modint8> r(n);
+    if (n == 0) return r.t;
+    // i g[i]
+    std::vector<modint> u(n);
+    for (const auto& x : f.terms().subspan(1)) {
+        if (x.index < n) {
+            u[x.index] = modint(x.index) * x.value;
+            r.terms.push_back({x.index, modint() - x.value, modint()});
+        }
+    }
+    r.t = BasicModVec<modint8>(u);
+    r.set_weight(1, false);
+    auto g = r.run();
+    Workspace::Frame frame;
+    auto inv = frame.alloc<modint8>(g.blocks().size());
+    fill_inverses(inv);
+    auto v = g.blocks();
+    for (size_t i = 0; i < v.size(); i++) v[i] *= inv[i];
+    return g;
+}
+
+// f^k mod x^n
+// With f = x^s h (h[0] != 0), f^k = x^(sk) h^k and for g = h^k,
+// h g' = k h' g: h[0] i g[i] = sum_{j > 0} h[j] ((k + 1) j - i) g[i - j].
+template <class modint8>
+BasicModVec<modint8> sparse_pow(const BasicSparseModVec<modint8>& f,
+                                u64 k,
+                                ssize_t n) {
+    using modint = typename modint8::modint;
+    using modvec = BasicModVec<modint8>;
+    const auto t = f.terms();
+    if (n == 0) return modvec();
+    if (k == 0) {
+        modvec g(n);
+        g.blocks()[0] = blend<0b00000001>(modint8(), modint8::set1(1));
+        return g;
+    }
+    // s k >= n
+    if (t.empty() ||
+        (t[0].index && (k >= u64(n) || u64(t[0].index) * k >= u64(n)))) {
+        return modvec(n);
+    }
+    const ssize_t s = t[0].index, m = n - s * ssize_t(k);
+    const modint h0 = t[0].value, k1 = modint(k) + modint(1);
+
+    internal::SparseRecurrence<modint8> r(m);
+    r.t.blocks()[0] =
+        blend<0b00000001>(modint8(), modint8::set1(h0.pow(k)));
+    r.set_weight(h0.inv(), true);
+    r.linear = true;
+    for (const auto& x : t.subspan(1)) {
+        const ssize_t j = x.index - s;
+        if (j < m) {
+            r.terms.push_back(
+                {j, k1 * modint(j) * x.value, modint() - x.value});
+        }
+    }
+    auto g = r.run();
+    g <<= s * ssize_t(k);
+    return g;
+}
+
+}  // namespace fastfps
@@ -0,0 +1,161 @@
+#pragma once
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+
+#include "fastfps/types.hpp"
+
+namespace fastfps {
+
+// Opt-in instrumentation.
+// Compile with -DFASTFPS_STATS to enable it. Otherwise the hooks in fft.hpp,
+// modvec.hpp and allocator.hpp expand to nothing and stats() is all zero.
+//
+//   reset_stats();
+//   ... work ...
+//   Stats s = stats();
+//
+// The counters are process-wide atomics, so stats() covers all threads.
+
+enum class StatsPhase {
+    FFT,
+    IFFT,
+    // pointwise products of transforms
+    POINTWISE,
+    // u32 / ModInt <-> ModInt8 (ModVec constructors and val())
+    CONVERT,
+};
+constexpr int STATS_PHASES = 4;
+constexpr int STATS_MAX_LOG = 32;
+
+struct Stats {
+#ifdef FASTFPS_STATS
+    static constexpr bool enabled = true;
+#else
+    static constexpr bool enabled = false;
+#endif
+
+    // number of fft / ifft calls by log2 of the number of ModInt8 blocks
+    std::array<u64, STATS_MAX_LOG> fft_count{}, ifft_count{};
+    // coefficients (8 per block) processed in each phase
+    std::array<u64, STATS_PHASES> elements{};
+    // time in each phase: TSC cycles on x86, nanoseconds otherwise
+    std::array<u64, STATS_PHASES> ticks{};
+    // allocations of ModVec storage (AlignedAllocator) and Workspace blocks
+    u64 alloc_count = 0, alloc_bytes = 0;
+
+    u64 get_elements(StatsPhase p) const { return elements[int(p)]; }
+    u64 get_ticks(StatsPhase p) const { return ticks[int(p)]; }
+};
+
+namespace internal {
+
+struct StatsCounters {
+    std::array<std::atomic<u64>, STATS_MAX_LOG> fft_count, ifft_count;
+    std::array<std::atomic<u64>, STATS_PHASES> elements, ticks;
+    std::atomic<u64> alloc_count, alloc_bytes;
+};
+inline StatsCounters stats_counters;
+
+inline u64 stats_now() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return u64(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+                   .count());
+#endif
+}
+
+inline void stats_add(std::atomic<u64>& x, u64 y) {
+    x.fetch_add(y, std::memory_order_relaxed);
+}
+
+// counts elements for the phase and adds the time until the end of the
+// scope to it
+class StatsScope {
+  public:
+    StatsScope(StatsPhase _phase, u64 elements)
+        : phase(int(_phase)), start(stats_now()) {
+        stats_add(stats_counters.elements[phase], elements);
+    }
+    ~StatsScope() {
+        stats_add(stats_counters.ticks[phase], stats_now() - start);
+    }
+    StatsScope(const StatsScope&) = delete;
+    StatsScope& operator=(const StatsScope&) = delete;
+
+  private:
+    int phase;
+    u64 start;
+};
+
+// a transform of blocks ModInt8
+inline void stats_transform(StatsPhase phase, size_t blocks) {
+    const int lg = std::clamp(int(std::bit_width(blocks)) - 1, 0,
+                              STATS_MAX_LOG - 1);
+    auto& count = phase == StatsPhase::FFT ? stats_counters.fft_count
+                                           : stats_counters.ifft_count;
+    stats_add(count[lg], 1);
+}
+
+inline void stats_alloc(size_t bytes) {
+    stats_add(stats_counters.alloc_count, 1);
+    stats_add(stats_counters.alloc_bytes, bytes);
+}
+
+}  // namespace internal
+
+// snapshot of the counters
+inline Stats stats() {
+    const auto& c = internal::stats_counters;
+    auto load = [](const std::atomic<u64>& x) {
+        return x.load(std::memory_order_relaxed);
+    };
+    Stats s;
+    for (int i = 0; i < STATS_MAX_LOG; i++) {
+        s.fft_count[i] = load(c.fft_count[i]);
+        s.ifft_count[i] = load(c.ifft_count[i]);
+    }
+    for (int i = 0; i < STATS_PHASES; i++) {
+        s.elements[i] = load(c.elements[i]);
+        s.ticks[i] = load(c.ticks[i]);
+    }
+    s.alloc_count = load(c.alloc_count);
+    s.alloc_bytes = load(c.alloc_bytes);
+    return s;
+}
+
+inline void reset_stats() {
+    auto& c = internal::stats_counters;
+    for (auto& x : c.fft_count) x = 0;
+    for (auto& x : c.ifft_count) x = 0;
+    for (auto& x : c.elements) x = 0;
+    for (auto& x : c.ticks) x = 0;
+    c.alloc_count = 0;
+    c.alloc_bytes = 0;
+}
+
+}  // namespace fastfps
+
+#ifdef FASTFPS_STATS
+// counts elements and time of the rest of the scope
+#define FASTFPS_STATS_SCOPE(phase, elements)             \
+    ::fastfps::internal::StatsScope fastfps_stats_scope( \
+        ::fastfps::StatsPhase::phase, ::fastfps::u64(elements))
+#define FASTFPS_STATS_TRANSFORM(phase, blocks) \
+    ::fastfps::internal::stats_transform(::fastfps::StatsPhase::phase, blocks)
+#define FASTFPS_STATS_ALLOC(bytes) ::fastfps::internal::stats_alloc(bytes)
+#else
+#define FASTFPS_STATS_SCOPE(phase, elements) ((void)0)
+#define FASTFPS_STATS_TRANSFORM(phase, blocks) ((void)0)
+#define FASTFPS_STATS_ALLOC(bytes) ((void)0)
+#endif
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "fastfps/allocator.hpp"
+#include "fastfps/dynmodint8.hpp"
+#include "fastfps/fft.hpp"
+#include "fastfps/modint8.hpp"
+#include "fastfps/modvec.hpp"
+#include "fastfps/stats.hpp"
+#include "fastfps/types.hpp"
+
+namespace fastfps {
+
+// y = x * k for a fixed kernel k and an input x given in chunks
+// (overlap-add)
+//
+// The input is cut into blocks of L coefficients, and each block is
+// convolved with k by a cyclic convolution of 8m >= L + |k| - 1
+// coefficients, with the transform of k computed once. The last |k| - 1
+// coefficients of a block overlap the next blocks and are kept until then,
+// so the memory is O(m) blocks regardless of the length of x, and no buffer
+// is allocated after the construction. (For DynModInt8, the modulus must
+// not change during the lifetime.)
+template <class _modint8> struct BasicStreamingConvolver {
+    using modint8 = _modint8;
+    using modint = typename modint8::modint;
+    using modvec = BasicModVec<modint8>;
+    using view_type = typename modvec::view_type;
+
+  public:
+    // |kernel| >= 1. block: the minimum L, rounded up so that L is a
+    // multiple of 8 and uses the whole transform (0: chosen from |kernel|)
+    explicit BasicStreamingConvolver(const modvec& kernel, ssize_t block = 0)
+        : k(kernel.size()) {
+        assert(k >= 1 && block >= 0);
+        if (block == 0) block = std::max<ssize_t>(8, 3 * (k - 1));
+        m = (ssize_t)std::bit_ceil((size_t)vsize(8 * vsize(block) + k - 1));
+        len = (8 * m - (k - 1)) / 8 * 8;
+
+        kernel_f.resize(m);
+        std::ranges::copy(kernel.blocks(), kernel_f.begin());
+        fft(kernel_f);
+        // the scale of ifft is folded into the kernel
+        const modint8 inv = modint8::set1(modint(8 * m).inv());
+        for (auto& x : kernel_f) x *= inv;
+
+        in = modvec(len);
+        out = modvec(len);
+        work.resize(m);
+        acc.resize(m);
+    }
+
+    // |kernel|
+    ssize_t kernel_size() const { return k; }
+    // L: the number of input coefficients per transform
+    ssize_t block() const { return len; }
+    // 8m: the length of the cyclic convolutions
+    ssize_t fft_size() const { return 8 * m; }
+
+    // Appends x to the input. Whenever L more coefficients of y are final,
+    // emit(c) is called with them, as a modvec c of size L that is reused
+    // (valid only during the call).
+    template <class F> void push(const view_type& x, F&& emit) {
+        const ssize_t n = x.size();
+        for (ssize_t i = 0; i < n;) {
+            const ssize_t c = std::min(len - in_len, n - i);
+            x.subview(i, c).copy_to(in, in_len);
+            in_len += c;
+            i += c;
+            if (in_len == len) {
+                convolve();
+                emit_front(len, emit);
+            }
+        }
+    }
+
+    // Ends the input: the rest of y (|x| + |k| - 1 coefficients in total,
+    // none if x is empty) is emitted in chunks of at most L, and the
+    // convolver is reset for a new input.
+    template <class F> void finish(F&& emit) {
+        if (in_len == 0 && !started) return;
+        ssize_t rest = in_len + k - 1;
+        if (in_len) convolve();
+        while (rest > 0) {
+            const ssize_t c = std::min(len, rest);
+            emit_front(c, emit);
+            rest -= c;
+        }
+        std::ranges::fill(acc, modint8());
+        started = false;
+    }
+
+  private:
+    ssize_t k, m, len;
+    // the transform of k, divided by 8m
+    std::vector<modint8, AlignedAllocator<modint8>> kernel_f;
+    // the pending input, in[0, in_len)
+    modvec in;
+    ssize_t in_len = 0;
+    // the transform buffer
+    std::vector<modint8, AlignedAllocator<modint8>> work;
+    // acc[0, L + |k| - 1): y from the first coefficient not emitted yet
+    std::vector<modint8, AlignedAllocator<modint8>> acc;
+    modvec out;
+    // whether some input was processed since the last finish
+    bool started = false;
+
+    static ssize_t vsize(ssize_t n) { return (n + 7) / 8; }
+
+    // acc += in * k, and the input is cleared
+    void convolve() {
+        const ssize_t nb = vsize(in_len);
+        const auto ib = in.blocks();
+        std::copy_n(ib.begin(), nb, work.begin());
+        std::fill(work.begin() + nb, work.end(), modint8());
+        fft(work);
+        {
+            FASTFPS_STATS_SCOPE(POINTWISE, 8 * m);
+            for (ssize_t i = 0; i < m; i++) work[i] *= kernel_f[i];
+        }
+        ifft(work);
+        for (ssize_t i = 0; i < m; i++) acc[i] += work[i];
+        std::fill(ib.begin(), ib.begin() + nb, modint8());
+        in_len = 0;
+        started = true;
+    }
+
+    // emits acc[0, c) and shifts acc by L (c <= L)
+    template <class F> void emit_front(ssize_t c, F& emit) {
+        out.resize(c);
+        const auto ob = out.blocks();
+        std::copy_n(acc.begin(), std::ssize(ob), ob.begin());
+        emit(std::as_const(out));
+        std::move(acc.begin() + len / 8, acc.end(), acc.begin());
+        std::fill(acc.end() - len / 8, acc.end(), modint8());
+        out.resize(len);
+    }
+};
+
+template <int MOD>
+using StreamingConvolver = BasicStreamingConvolver<ModInt8<MOD>>;
+template <int id>
+using DynStreamingConvolver = BasicStreamingConvolver<DynModInt8<id>>;
+
+}  // namespace fastfps
@@ -0,0 +1,53 @@
+#include <array>
+#include <iostream>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "fastfps/batch.hpp"
+#include "fastfps/modvec.hpp"
+#include "fastfps/types.hpp"
+
+using namespace fastfps;
+const u32 MOD = 998244353;
+using modvec = ModVec<MOD>;
+
+const int K = 10000;
+
+std::vector<modvec> inputs(int len, int seed) {
+    std::vector<modvec> a(K);
+    for (int k = 0; k < K; k++) {
+        std::vector<u32> v(len);
+        for (int i = 0; i < len; i++) {
+            v[i] = u32(k * 31 + i * 7 + seed);
+        }
+        a[k] = modvec(v);
+    }
+    return a;
+}
+
+// K convolutions of two length state.range(0) inputs
+void BM_batch_convolve(benchmark::State& state) {
+    auto a = inputs(int(state.range(0)), 1), b = inputs(int(state.range(0)), 2);
+    for (auto _ : state) {
+        auto c = batch_convolve(a, b);
+        benchmark::DoNotOptimize(c);
+    }
+    state.SetItemsProcessed(state.iterations() * K);
+}
+BENCHMARK(BM_batch_convolve)->RangeMultiplier(2)->Range(16, 256);
+
+void BM_each_convolve(benchmark::State& state) {
+    auto a = inputs(int(state.range(0)), 1), b = inputs(int(state.range(0)), 2);
+    for (auto _ : state) {
+        std::vector<modvec> c(K);
+        for (int k = 0; k < K; k++) {
+            c[k] = a[k] * b[k];
+        }
+        benchmark::DoNotOptimize(c);
+    }
+    state.SetItemsProcessed(state.iterations() * K);
+}
+BENCHMARK(BM_each_convolve)->RangeMultiplier(2)->Range(16, 256);
+
+BENCHMARK_MAIN();
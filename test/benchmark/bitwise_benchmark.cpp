@@ -0,0 +1,139 @@
+#include <bit>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "fastfps/bitwise.hpp"
+#include "fastfps/modint.hpp"
+#include "fastfps/modvec.hpp"
+#include "fastfps/types.hpp"
+
+using namespace fastfps;
+const u32 MOD = 998244353;
+using modint = ModInt<MOD>;
+using modvec = ModVec<MOD>;
+
+std::vector<u32> input(int n, int seed) {
+    std::vector<u32> a(n);
+    for (int i = 0; i < n; i++) {
+        a[i] = u32(i) * 1234567 + u32(seed);
+    }
+    return a;
+}
+
+void BM_xor_convolution(benchmark::State& state) {
+    const int n = int(state.range(0));
+    modvec a(input(n, 1)), b(input(n, 2));
+    for (auto _ : state) {
+        auto c = xor_convolution(a, b);
+        benchmark::DoNotOptimize(c);
+    }
+}
+BENCHMARK(BM_xor_convolution)->RangeMultiplier(4)->Range(1 << 10, 1 << 20);
+
+// the same transform over scalar ModInt
+void BM_xor_convolution_scalar(benchmark::State& state) {
+    const int n = int(state.range(0));
+    auto a0 = input(n, 1), b0 = input(n, 2);
+    auto hadamard = [&](std::vector<modint>& f) {
+        for (int len = 1; len < n; len *= 2) {
+            for (int start = 0; start < n; start += 2 * len) {
+                for (int i = start; i < start + len; i++) {
+                    auto l = f[i], r = f[i + len];
+                    f[i] = l + r;
+                    f[i + len] = l - r;
+                }
+            }
+        }
+    };
+    for (auto _ : state) {
+        std::vector<modint> a(a0.begin(), a0.end()), b(b0.begin(), b0.end());
+        hadamard(a);
+        hadamard(b);
+        for (int i = 0; i < n; i++) a[i] *= b[i];
+        hadamard(a);
+        const modint inv = modint(n).inv();
+        for (auto& x : a) x *= inv;
+        benchmark::DoNotOptimize(a);
+    }
+}
+BENCHMARK(BM_xor_convolution_scalar)
+    ->RangeMultiplier(4)
+    ->Range(1 << 10, 1 << 20);
+
+void BM_and_convolution(benchmark::State& state) {
+    const int n = int(state.range(0));
+    modvec a(input(n, 1)), b(input(n, 2));
+    for (auto _ : state) {
+        auto c = and_convolution(a, b);
+        benchmark::DoNotOptimize(c);
+    }
+}
+BENCHMARK(BM_and_convolution)->RangeMultiplier(4)->Range(1 << 10, 1 << 20);
+
+void BM_or_convolution(benchmark::State& state) {
+    const int n = int(state.range(0));
+    modvec a(input(n, 1)), b(input(n, 2));
+    for (auto _ : state) {
+        auto c = or_convolution(a, b);
+        benchmark::DoNotOptimize(c);
+    }
+}
+BENCHMARK(BM_or_convolution)->RangeMultiplier(4)->Range(1 << 10, 1 << 20);
+
+void BM_subset_convolution(benchmark::State& state) {
+    const int n = int(state.range(0));
+    modvec a(input(n, 1)), b(input(n, 2));
+    for (auto _ : state) {
+        auto c = subset_convolution(a, b);
+        benchmark::DoNotOptimize(c);
+    }
+}
+BENCHMARK(BM_subset_convolution)->RangeMultiplier(4)->Range(1 << 10, 1 << 20);
+
+// ranked zeta transform over scalar ModInt
+void BM_subset_convolution_scalar(benchmark::State& state) {
+    const int n = int(state.range(0));
+    const int k = std::countr_zero(u32(n));
+    auto a0 = input(n, 1), b0 = input(n, 2);
+    auto load = [&](const std::vector<u32>& src) {
+        std::vector<std::vector<modint>> f(k + 1, std::vector<modint>(n));
+        for (int i = 0; i < n; i++) f[std::popcount(u32(i))][i] = src[i];
+        return f;
+    };
+    auto zeta = [&](std::vector<modint>& f, bool inv) {
+        for (int len = 1; len < n; len *= 2) {
+            for (int start = 0; start < n; start += 2 * len) {
+                for (int i = start; i < start + len; i++) {
+                    if (inv) {
+                        f[i + len] -= f[i];
+                    } else {
+                        f[i + len] += f[i];
+                    }
+                }
+            }
+        }
+    };
+    for (auto _ : state) {
+        auto fa = load(a0), fb = load(b0);
+        for (int r = 0; r <= k; r++) {
+            zeta(fa[r], false);
+            zeta(fb[r], false);
+        }
+        std::vector<std::vector<modint>> h(k + 1, std::vector<modint>(n));
+        for (int r = 0; r <= k; r++) {
+            for (int s = 0; s <= r; s++) {
+                for (int i = 0; i < n; i++) h[r][i] += fa[s][i] * fb[r - s][i];
+            }
+        }
+        std::vector<modint> c(n);
+        for (int r = 0; r <= k; r++) zeta(h[r], true);
+        for (int i = 0; i < n; i++) c[i] = h[std::popcount(u32(i))][i];
+        benchmark::DoNotOptimize(c);
+    }
+}
+BENCHMARK(BM_subset_convolution_scalar)
+    ->RangeMultiplier(4)
+    ->Range(1 << 10, 1 << 20);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,810 @@
+// Benchmarks of the public operations of ModInt / ModInt8 / ModVec, with
+// naive scalar implementations as the reference.
+//
+// Every benchmark reports items_per_second and per_coef (time per output
+// coefficient). `make fastfps_bench_json` writes fastfps_bench.json; two
+// runs can be diffed with tools/compare.py of google benchmark.
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "fastfps/batch.hpp"
+#include "fastfps/fft.hpp"
+#include "fastfps/modint.hpp"
+#include "fastfps/modint8.hpp"
+#include "fastfps/modmatrix.hpp"
+#include "fastfps/modvec.hpp"
+#include "fastfps/parallel.hpp"
+#include "fastfps/sparse_matrix.hpp"
+#include "fastfps/sparse_modvec.hpp"
+#include "fastfps/streaming.hpp"
+#include "fastfps/types.hpp"
+
+using namespace fastfps;
+const u32 MOD = 998244353;
+using modint = ModInt<MOD>;
+using modint8 = ModInt8<MOD>;
+using modvec = ModVec<MOD>;
+using modmatrix = ModMatrix<MOD>;
+using sparse_matrix = SparseMatrix<MOD>;
+
+std::vector<u32> input_u32(int n, int seed) {
+    std::vector<u32> a(n);
+    for (int i = 0; i < n; i++) {
+        a[i] = (u32(i) * 1234567 + u32(seed)) % MOD;
+    }
+    if (n) a[0] = 1;
+    return a;
+}
+std::vector<modint> input_modint(int n, int seed) {
+    auto a = input_u32(n, seed);
+    return std::vector<modint>(a.begin(), a.end());
+}
+modvec input(int n, int seed) { return modvec(input_u32(n, seed)); }
+
+void set_coefs(benchmark::State& state, int64_t n) {
+    state.SetItemsProcessed(state.iterations() * n);
+    state.counters["per_coef"] = benchmark::Counter(
+        double(n), benchmark::Counter::kIsIterationInvariantRate |
+                       benchmark::Counter::kInvert);
+}
+
+// sizes: powers of two and others
+void sizes(benchmark::internal::Benchmark* b, int lo, int hi) {
+    for (int n = lo; n <= hi; n *= 4) {
+        b->Arg(n);
+        b->Arg(n / 4 * 5 + 3);
+    }
+}
+void sizes_small(benchmark::internal::Benchmark* b) {
+    sizes(b, 1 << 6, 1 << 12);
+}
+void sizes_large(benchmark::internal::Benchmark* b) {
+    sizes(b, 1 << 10, 1 << 20);
+}
+// up to 10^5 for the O(n log^2 n) operations
+void sizes_medium(benchmark::internal::Benchmark* b) {
+    sizes(b, 1 << 10, 1 << 16);
+    b->Arg(100'000);
+}
+// (n, m): balanced, unbalanced and non power of two
+void shapes(benchmark::internal::Benchmark* b, int lo, int hi) {
+    for (int n = lo; n <= hi; n *= 4) {
+        b->Args({n, n});
+        b->Args({n, std::max(1, n / 64)});
+        b->Args({n / 4 * 5 + 3, n / 2 + 1});
+    }
+}
+void shapes_small(benchmark::internal::Benchmark* b) {
+    shapes(b, 1 << 6, 1 << 12);
+}
+void shapes_large(benchmark::internal::Benchmark* b) {
+    shapes(b, 1 << 10, 1 << 20);
+}
+
+namespace naive {
+
+std::vector<modint> mul(const std::vector<modint>& a,
+                        const std::vector<modint>& b) {
+    if (a.empty() || b.empty()) return {};
+    std::vector<modint> c(a.size() + b.size() - 1);
+    for (size_t i = 0; i < a.size(); i++) {
+        for (size_t j = 0; j < b.size(); j++) {
+            c[i + j] += a[i] * b[j];
+        }
+    }
+    return c;
+}
+
+// 1 / a mod x^n
+std::vector<modint> inv(const std::vector<modint>& a, int n) {
+    std::vector<modint> c(n);
+    const modint i0 = a[0].inv();
+    for (int i = 0; i < n; i++) {
+        modint s = (i == 0);
+        for (int j = 1; j <= std::min<int>(i, int(a.size()) - 1); j++) {
+            s -= a[j] * c[i - j];
+        }
+        c[i] = s * i0;
+    }
+    return c;
+}
+
+// shortest c with c[0] = -1 and a[i] = sum_{j > 0} c[j] a[i - j]
+std::vector<modint> berlekamp_massey(const std::vector<modint>& a) {
+    std::vector<modint> b = {-1}, c = {-1};
+    modint y = 1;
+    for (size_t ed = 1; ed <= a.size(); ed++) {
+        const size_t l = c.size();
+        modint x = 0;
+        for (size_t i = 0; i < l; i++) x += c[i] * a[ed - l + i];
+        b.push_back(0);
+        if (x == 0) continue;
+        const size_t m = b.size();
+        const modint freq = x * y.inv();
+        if (l < m) {
+            auto tmp = c;
+            c.insert(c.begin(), m - l, modint(0));
+            for (size_t i = 0; i < m; i++) c[i] -= freq * b[i];
+            b = tmp;
+            y = x;
+        } else {
+            for (size_t i = 0; i < m; i++) c[l - m + i] -= freq * b[i];
+        }
+    }
+    std::reverse(c.begin(), c.end());
+    return c;
+}
+
+// f(g) mod x^n by Brent-Kung: f = sum_j F_j(x) x^(jk) with |F_j| = k,
+// g^0, ..., g^k (baby steps), F_j(g) as linear combinations of them, and
+// Horner in g^k (giant steps). O(n^2) with k = sqrt(n).
+modvec compose_brent_kung(const modvec& f, const modvec& g, int n) {
+    int k = 1;
+    while (k * k < n) k++;
+    std::vector<modvec> pw = {modvec({1})};
+    for (int i = 0; i < k; i++) {
+        modvec x = pw.back() * g;
+        x.resize(n);
+        pw.push_back(x);
+    }
+    modvec h(n);
+    for (int j = (int(f.size()) + k - 1) / k - 1; j >= 0; j--) {
+        h *= pw[k];
+        h.resize(n);
+        for (int i = 0; i < k && j * k + i < int(f.size()); i++) {
+            modvec t = pw[i];
+            t.resize(n);
+            h += t * modint(f.val(j * k + i));
+        }
+    }
+    return h;
+}
+
+// n x n matrices as rows of ModInt
+using matrix = std::vector<std::vector<modint>>;
+
+matrix matrix_mul(const matrix& a, const matrix& b) {
+    const int n = int(a.size());
+    matrix c(n, std::vector<modint>(n));
+    for (int i = 0; i < n; i++) {
+        for (int k = 0; k < n; k++) {
+            for (int j = 0; j < n; j++) c[i][j] += a[i][k] * b[k][j];
+        }
+    }
+    return c;
+}
+
+modint det(matrix a) {
+    const int n = int(a.size());
+    modint d = 1;
+    for (int c = 0; c < n; c++) {
+        int p = c;
+        while (p < n && a[p][c] == modint(0)) p++;
+        if (p == n) return 0;
+        if (p != c) {
+            std::swap(a[p], a[c]);
+            d = modint(0) - d;
+        }
+        d *= a[c][c];
+        const modint x = a[c][c].inv();
+        for (int i = c + 1; i < n; i++) {
+            const modint f = a[i][c] * x;
+            for (int j = c; j < n; j++) a[i][j] -= f * a[c][j];
+        }
+    }
+    return d;
+}
+
+// CSR rows of (column, value)
+using sparse_matrix = std::vector<std::vector<std::pair<int, modint>>>;
+
+std::vector<modint> sparse_matrix_mul(const sparse_matrix& a,
+                                      const std::vector<modint>& x) {
+    std::vector<modint> y(a.size());
+    for (size_t i = 0; i < a.size(); i++) {
+        for (const auto& [j, v] : a[i]) y[i] += v * x[j];
+    }
+    return y;
+}
+
+}  // namespace naive
+
+// scalar ModInt
+
+void BM_modint_add(benchmark::State& state) {
+    const int n = int(state.range(0));
+    auto a = input_modint(n, 1), b = input_modint(n, 2);
+    for (auto _ : state) {
+        for (int i = 0; i < n; i++) a[i] += b[i];
+        benchmark::DoNotOptimize(a);
+    }
+    set_coefs(state, n);
+}
+BENCHMARK(BM_modint_add)->Apply(sizes_large);
+
+void BM_modint_mul(benchmark::State& state) {
+    const int n = int(state.range(0));
+    auto a = input_modint(n, 1), b = input_modint(n, 2);
+    for (auto _ : state) {
+        for (int i = 0; i < n; i++) a[i] *= b[i];
+        benchmark::DoNotOptimize(a);
+    }
+    set_coefs(state, n);
+}
+BENCHMARK(BM_modint_mul)->Apply(sizes_large);
+
+void BM_modint_inv(benchmark::State& state) {
+    const int n = int(state.range(0));
+    auto a = input_modint(n, 1);
+    for (auto _ : state) {
+        for (int i = 0; i < n; i++) a[i] = a[i].inv();
+        benchmark::DoNotOptimize(a);
+    }
+    set_coefs(state, n);
+}
+BENCHMARK(BM_modint_inv)->Apply(sizes_small);
+
+// Fermat's little theorem, the previous ModInt::inv
+void BM_modint_inv_pow(benchmark::State& state) {
+    const int n = int(state.range(0));
+    auto a = input_modint(n, 1);
+    for (auto _ : state) {
+        for (int i = 0; i < n; i++) a[i] = a[i].pow(MOD - 2);
+        benchmark::DoNotOptimize(a);
+    }
+    set_coefs(state, n);
+}
+BENCHMARK(BM_modint_inv_pow)->Apply(sizes_small);
+
+void BM_batch_inv(benchmark::State& state) {
+    const int n = int(state.range(0));
+    auto a = input_modint(n, 1);
+    for (auto& x : a) x += 1;
+    for (auto _ : state) {
+        batch_inv(std::span(a));
+        benchmark::DoNotOptimize(a);
+    }
+    set_coefs(state, n);
+}
+BENCHMARK(BM_batch_inv)->Apply(sizes_large);
+
+// ModInt8
+
+void BM_modint8_mul(benchmark::State& state) {
+    const int n = int(state.range(0));
+    auto a = input(n, 1), b = input(n, 2);
+    auto va = a.blocks();
+    auto vb = b.blocks();
+    for (auto _ : state) {
+        for (size_t i = 0; i < va.size(); i++) va[i] *= vb[i];
+        benchmark::DoNotOptimize(va.data());
+    }
+    set_coefs(state, n);
+}
+BENCHMARK(BM_modint8_mul)->Apply(sizes_large);
+
+// conversions
+
+void BM_construct(benchmark::State& state) {
+    const int n = int(state.range(0));
+    auto a = input_u32(n, 1);
+    for (auto _ : state) {
+        modvec v(a);
+        benchmark::DoNotOptimize(v);
+    }
+    set_coefs(state, n);
+}
+BENCHMARK(BM_construct)->Apply(sizes_large);
+
+void BM_val(benchmark::State& state) {
+    const int n = int(state.range(0));
+    auto a = input(n, 1);
+    for (auto _ : state) {
+        auto v = a.val();
+        benchmark::DoNotOptimize(v);
+    }
+    set_coefs(state, n);
+}
+BENCHMARK(BM_val)->Apply(sizes_large);
+
+// copies and shifts
+
+void BM_copy_to(benchmark::State& state) {
+    const int n = int(state.range(0));
+    auto a = input(n + 8, 1);
+    modvec b(n + 8);
+    for (auto _ : state) {
+        a.copy_to(3, n, b, 5);
+        benchmark::DoNotOptimize(b);
+    }
+    set_coefs(state, n);
+}
+BENCHMARK(BM_copy_to)->Apply(sizes_large);
+
+void BM_substr(benchmark::State& state) {
+    const int n = int(state.range(0));
+    auto a = input(n + 8, 1);
+    for (auto _ : state) {
+        auto b = a.substr(3, n);
+        benchmark::DoNotOptimize(b);
+    }
+    set_coefs(state, n);
+}
+BENCHMARK(BM_substr)->Apply(sizes_large);
+
+void BM_shift(benchmark::State& state) {
+    const int n = int(state.range(0));
+    auto a = input(n, 1);
+    for (auto _ : state) {
+        auto b = a;
+        b <<= 3;
+        benchmark::DoNotOptimize(b);
+    }
+    set_coefs(state, n + 3);
+}
+BENCHMARK(BM_shift)->Apply(sizes_large);
+
+// arithmetic
+
+void BM_add(benchmark::State& state) {
+    const int n = int(state.range(0));
+    auto a = input(n, 1), b = input(n, 2);
+    modvec c;
+    for (auto _ : state) {
+        c = a + b * 3;
+        benchmark::DoNotOptimize(c);
+    }
+    set_coefs(state, n);
+}
+BENCHMARK(BM_add)->Apply(sizes_large);
+
+void BM_dot(benchmark::State& state) {
+    const int n = int(state.range(0));
+    auto a = input(n, 1), b = input(n, 2);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(dot(a, b));
+    }
+    set_coefs(state, n);
+}
+BENCHMARK(BM_dot)->Apply(sizes_large);
+
+void BM_mul(benchmark::State& state) {
+    const int n = int(state.range(0)), m = int(state.range(1));
+    auto a = input(n, 1), b = input(m, 2);
+    modvec c;
+    for (auto _ : state) {
+        c = a;
+        c *= b;
+        benchmark::DoNotOptimize(c);
+    }
+    set_coefs(state, n + m - 1);
+}
+BENCHMARK(BM_mul)->Apply(shapes_large);
+
+void BM_mul_naive(benchmark::State& state) {
+    const int n = int(state.range(0)), m = int(state.range(1));
+    auto a = input_modint(n, 1), b = input_modint(m, 2);
+    for (auto _ : state) {
+        auto c = naive::mul(a, b);
+        benchmark::DoNotOptimize(c);
+    }
+    set_coefs(state, n + m - 1);
+}
+BENCHMARK(BM_mul_naive)->Apply(shapes_small);
+
+void BM_inv(benchmark::State& state) {
+    const int n = int(state.range(0));
+    auto a = input(n, 1);
+    for (auto _ : state) {
+        auto c = a.inv(n);
+        benchmark::DoNotOptimize(c);
+    }
+    set_coefs(state, n);
+}
+BENCHMARK(BM_inv)->Apply(sizes_large);
+
+void BM_inv_naive(benchmark::State& state) {
+    const int n = int(state.range(0));
+    auto a = input_modint(n, 1);
+    for (auto _ : state) {
+        auto c = naive::inv(a, n);
+        benchmark::DoNotOptimize(c);
+    }
+    set_coefs(state, n);
+}
+BENCHMARK(BM_inv_naive)->Apply(sizes_small);
+
+// prod (1 - a_i x) for n linear factors
+std::vector<modvec> input_linear_factors(int n, int seed) {
+    std::vector<modvec> fs;
+    for (u32 a : input_u32(n, seed)) fs.push_back(modvec({1u, MOD - a}));
+    return fs;
+}
+// (n, threads)
+void product_shapes(benchmark::internal::Benchmark* b) {
+    for (int n : {1000, 100'000}) {
+        for (int t : {1, 2, 4, 8}) b->Args({n, t});
+    }
+}
+
+void BM_product(benchmark::State& state) {
+    const int n = int(state.range(0));
+    set_num_threads(int(state.range(1)));
+    const auto fs = input_linear_factors(n, 1);
+    for (auto _ : state) {
+        auto c = product(fs);
+        benchmark::DoNotOptimize(c);
+    }
+    set_num_threads(1);
+    set_coefs(state, n);
+}
+BENCHMARK(BM_product)->Apply(product_shapes)->UseRealTime();
+
+// a plain divide and conquer by operator* on one thread
+modvec product_dc(const std::vector<modvec>& fs, size_t l, size_t r) {
+    if (r - l == 1) return fs[l];
+    const size_t mid = (l + r) / 2;
+    return product_dc(fs, l, mid) * product_dc(fs, mid, r);
+}
+void BM_product_dc(benchmark::State& state) {
+    const int n = int(state.range(0));
+    const auto fs = input_linear_factors(n, 1);
+    for (auto _ : state) {
+        auto c = product_dc(fs, 0, fs.size());
+        benchmark::DoNotOptimize(c);
+    }
+    set_coefs(state, n);
+}
+BENCHMARK(BM_product_dc)->Arg(1000)->Arg(100'000);
+
+// scaling of the thread pool by the number of threads
+
+void thread_counts(benchmark::internal::Benchmark* b) {
+    for (int t : {1, 2, 4, 8, 16, 32}) b->Arg(t);
+}
+
+// 64 independent transforms of 2^14 blocks
+void BM_parallel_for_fft(benchmark::State& state) {
+    set_num_threads(int(state.range(0)));
+    const int k = 64, n = 1 << 14;
+    std::vector<std::vector<modint8>> a(k, std::vector<modint8>(n));
+    for (auto& v : a) {
+        for (int i = 0; i < n; i++) v[i] = modint8::set1(modint(i));
+    }
+    for (auto _ : state) {
+        parallel_for(k, [&](ssize_t i) { fft(a[i]); });
+        benchmark::ClobberMemory();
+    }
+    set_num_threads(1);
+    set_coefs(state, i64(k) * 8 * n);
+}
+BENCHMARK(BM_parallel_for_fft)->Apply(thread_counts)->UseRealTime();
+
+// the overhead of parallel_invoke: 2^16 tasks of no work
+int invoke_tree(int depth) {
+    if (depth == 0) return 1;
+    int a, b;
+    parallel_invoke([&] { a = invoke_tree(depth - 1); },
+                    [&] { b = invoke_tree(depth - 1); });
+    return a + b;
+}
+void BM_parallel_invoke(benchmark::State& state) {
+    set_num_threads(int(state.range(0)));
+    for (auto _ : state) {
+        auto c = invoke_tree(16);
+        benchmark::DoNotOptimize(c);
+    }
+    set_num_threads(1);
+    set_coefs(state, 1 << 16);
+}
+BENCHMARK(BM_parallel_invoke)->Apply(thread_counts)->UseRealTime();
+
+// k terms at the indices 0, 3, 10, 21, ...
+SparseModVec<MOD> input_sparse(int k, int seed) {
+    auto a = input_modint(k, seed);
+    std::vector<SparseModVec<MOD>::Term> t;
+    for (int i = 0; i < k; i++) t.push_back({i * (i + 2) + i / 2, a[i]});
+    return t;
+}
+void sparse_shapes(benchmark::internal::Benchmark* b) {
+    for (int n : {1 << 14, 1 << 20}) {
+        for (int k : {2, 4, 8, 16, 32, 64}) b->Args({n, k});
+    }
+}
+
+void BM_sparse_inv(benchmark::State& state) {
+    const int n = int(state.range(0)), k = int(state.range(1));
+    auto a = input_sparse(k, 1);
+    for (auto _ : state) {
+        auto c = sparse_inv(a, n);
+        benchmark::DoNotOptimize(c);
+    }
+    set_coefs(state, n);
+}
+BENCHMARK(BM_sparse_inv)->Apply(sparse_shapes);
+
+void BM_sparse_exp(benchmark::State& state) {
+    const int n = int(state.range(0)), k = int(state.range(1));
+    auto a = input_sparse(k + 1, 1);
+    a = SparseModVec<MOD>(
+        std::vector(a.terms().begin() + 1, a.terms().end()));
+    for (auto _ : state) {
+        auto c = sparse_exp(a, n);
+        benchmark::DoNotOptimize(c);
+    }
+    set_coefs(state, n);
+}
+BENCHMARK(BM_sparse_exp)->Apply(sparse_shapes);
+
+void BM_sparse_pow(benchmark::State& state) {
+    const int n = int(state.range(0)), k = int(state.range(1));
+    auto a = input_sparse(k, 1);
+    for (auto _ : state) {
+        auto c = sparse_pow(a, 12345, n);
+        benchmark::DoNotOptimize(c);
+    }
+    set_coefs(state, n);
+}
+BENCHMARK(BM_sparse_pow)->Apply(sparse_shapes);
+
+void BM_berlekamp_massey(benchmark::State& state) {
+    const int n = int(state.range(0));
+    auto a = input(n, 1);
+    for (auto _ : state) {
+        auto c = a.berlekamp_massey();
+        benchmark::DoNotOptimize(c);
+    }
+    set_coefs(state, n);
+}
+BENCHMARK(BM_berlekamp_massey)->Apply(sizes_small);
+
+void BM_berlekamp_massey_naive(benchmark::State& state) {
+    const int n = int(state.range(0));
+    auto a = input_modint(n, 1);
+    for (auto _ : state) {
+        auto c = naive::berlekamp_massey(a);
+        benchmark::DoNotOptimize(c);
+    }
+    set_coefs(state, n);
+}
+BENCHMARK(BM_berlekamp_massey_naive)->Apply(sizes_small);
+
+void BM_taylor_shift(benchmark::State& state) {
+    const int n = int(state.range(0));
+    auto a = input(n, 1);
+    for (auto _ : state) {
+        auto c = a.taylor_shift(12345);
+        benchmark::DoNotOptimize(c);
+    }
+    set_coefs(state, n);
+}
+BENCHMARK(BM_taylor_shift)
+    ->Arg(16)
+    ->Arg(32)
+    ->Arg(64)
+    ->Apply(sizes_large)
+    ->Arg(500'000);
+
+// composition
+
+void BM_compose(benchmark::State& state) {
+    const int n = int(state.range(0));
+    auto f = input(n, 1), g = input(n, 2);
+    for (auto _ : state) {
+        auto c = f.compose(g, n);
+        benchmark::DoNotOptimize(c);
+    }
+    set_coefs(state, n);
+}
+BENCHMARK(BM_compose)->Apply(sizes_medium);
+
+void BM_compose_brent_kung(benchmark::State& state) {
+    const int n = int(state.range(0));
+    auto f = input(n, 1), g = input(n, 2);
+    for (auto _ : state) {
+        auto c = naive::compose_brent_kung(f, g, n);
+        benchmark::DoNotOptimize(c);
+    }
+    set_coefs(state, n);
+}
+BENCHMARK(BM_compose_brent_kung)
+    ->Apply(sizes_small)
+    ->Arg(1 << 14)
+    ->Arg(100'000)
+    ->Iterations(1);
+
+void BM_compositional_inverse(benchmark::State& state) {
+    const int n = int(state.range(0));
+    auto f = input(n, 1);
+    f -= modvec({f.val(0)});
+    for (auto _ : state) {
+        auto c = f.compositional_inverse(n);
+        benchmark::DoNotOptimize(c);
+    }
+    set_coefs(state, n);
+}
+BENCHMARK(BM_compositional_inverse)->Apply(sizes_medium);
+
+// dense matrices (n x n, the items are the n^3 multiply-adds)
+
+// pseudo-random, so that the matrices are regular
+std::vector<std::vector<u32>> input_matrix(int n, int seed) {
+    std::mt19937 mt(seed);
+    std::vector<std::vector<u32>> a(n, std::vector<u32>(n));
+    for (auto& row : a) {
+        for (auto& x : row) x = u32(mt() % MOD);
+    }
+    return a;
+}
+naive::matrix input_naive_matrix(int n, int seed) {
+    naive::matrix a;
+    for (const auto& row : input_matrix(n, seed)) {
+        a.emplace_back(row.begin(), row.end());
+    }
+    return a;
+}
+void sizes_matrix(benchmark::internal::Benchmark* b) {
+    for (int n : {64, 128, 256, 512, 1000}) b->Arg(n);
+}
+
+void BM_matrix_mul(benchmark::State& state) {
+    const int n = int(state.range(0));
+    const modmatrix a(input_matrix(n, 1)), b(input_matrix(n, 2));
+    for (auto _ : state) {
+        auto c = a * b;
+        benchmark::DoNotOptimize(c);
+    }
+    set_coefs(state, i64(n) * n * n);
+}
+BENCHMARK(BM_matrix_mul)->Apply(sizes_matrix);
+
+void BM_matrix_mul_naive(benchmark::State& state) {
+    const int n = int(state.range(0));
+    const auto a = input_naive_matrix(n, 1), b = input_naive_matrix(n, 2);
+    for (auto _ : state) {
+        auto c = naive::matrix_mul(a, b);
+        benchmark::DoNotOptimize(c);
+    }
+    set_coefs(state, i64(n) * n * n);
+}
+BENCHMARK(BM_matrix_mul_naive)->Apply(sizes_matrix);
+
+void BM_matrix_det(benchmark::State& state) {
+    const int n = int(state.range(0));
+    const modmatrix a(input_matrix(n, 1));
+    for (auto _ : state) {
+        auto d = a.det();
+        benchmark::DoNotOptimize(d);
+    }
+    set_coefs(state, i64(n) * n * n);
+}
+BENCHMARK(BM_matrix_det)->Apply(sizes_matrix);
+
+void BM_matrix_det_naive(benchmark::State& state) {
+    const int n = int(state.range(0));
+    const auto a = input_naive_matrix(n, 1);
+    for (auto _ : state) {
+        auto d = naive::det(a);
+        benchmark::DoNotOptimize(d);
+    }
+    set_coefs(state, i64(n) * n * n);
+}
+BENCHMARK(BM_matrix_det_naive)->Apply(sizes_matrix);
+
+void BM_matrix_inv(benchmark::State& state) {
+    const int n = int(state.range(0));
+    const modmatrix a(input_matrix(n, 1));
+    for (auto _ : state) {
+        auto b = a.inv();
+        benchmark::DoNotOptimize(b);
+    }
+    set_coefs(state, i64(n) * n * n);
+}
+BENCHMARK(BM_matrix_inv)->Apply(sizes_matrix);
+
+void BM_matrix_charpoly(benchmark::State& state) {
+    const int n = int(state.range(0));
+    const modmatrix a(input_matrix(n, 1));
+    for (auto _ : state) {
+        auto p = a.charpoly();
+        benchmark::DoNotOptimize(p);
+    }
+    set_coefs(state, i64(n) * n * n);
+}
+BENCHMARK(BM_matrix_charpoly)->Apply(sizes_matrix);
+
+// n x n with k random nonzero entries per row
+std::vector<sparse_matrix::Entry> input_sparse_matrix(int n, int k, int seed) {
+    std::mt19937 mt(seed);
+    std::vector<sparse_matrix::Entry> e;
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < k; j++) {
+            e.push_back({i, int(mt() % n), modint(u32(mt() % MOD))});
+        }
+    }
+    return e;
+}
+void sizes_sparse_matrix(benchmark::internal::Benchmark* b) {
+    for (int n : {1 << 10, 1 << 14, 1 << 18, 1 << 20}) b->Arg(n);
+}
+
+void BM_sparse_matrix_mul(benchmark::State& state) {
+    const int n = int(state.range(0));
+    const sparse_matrix a(n, n, input_sparse_matrix(n, 8, 1));
+    const modvec x(input_u32(n, 2));
+    for (auto _ : state) {
+        auto y = a * x;
+        benchmark::DoNotOptimize(y);
+    }
+    set_coefs(state, a.nonzeros());
+}
+BENCHMARK(BM_sparse_matrix_mul)->Apply(sizes_sparse_matrix);
+
+void BM_sparse_matrix_mul_naive(benchmark::State& state) {
+    const int n = int(state.range(0));
+    naive::sparse_matrix a(n);
+    for (const auto& x : input_sparse_matrix(n, 8, 1)) {
+        a[x.row].emplace_back(int(x.col), x.value);
+    }
+    const auto x = input_modint(n, 2);
+    for (auto _ : state) {
+        auto y = naive::sparse_matrix_mul(a, x);
+        benchmark::DoNotOptimize(y);
+    }
+    set_coefs(state, i64(n) * 8);
+}
+BENCHMARK(BM_sparse_matrix_mul_naive)->Apply(sizes_sparse_matrix);
+
+// compare with BM_matrix_det: O(n^2 k) instead of O(n^3)
+void BM_wiedemann_det(benchmark::State& state) {
+    const int n = int(state.range(0));
+    const sparse_matrix a(n, n, input_sparse_matrix(n, 8, 1));
+    for (auto _ : state) {
+        auto d = wiedemann_det(a);
+        benchmark::DoNotOptimize(d);
+    }
+    set_coefs(state, i64(n) * n * 8);
+}
+BENCHMARK(BM_wiedemann_det)->Apply(sizes_matrix);
+
+// streaming convolution: a signal of 2^20 coefficients pushed in chunks
+// of 4096, by (|kernel|, block); items/s is input coefficients per second
+
+void streaming_shapes(benchmark::internal::Benchmark* b) {
+    for (int k : {64, 1024, 16384}) {
+        for (int block : {0, k / 2, 2 * k, 8 * k}) b->Args({k, block});
+    }
+}
+
+void BM_streaming_convolve(benchmark::State& state) {
+    const int k = int(state.range(0)), n = 1 << 20, chunk = 4096;
+    const auto x = input(n, 1);
+    StreamingConvolver<MOD> conv(input(k, 2), state.range(1));
+    u32 sum = 0;
+    auto emit = [&](const modvec& c) { sum += c.val(0); };
+    for (auto _ : state) {
+        for (int i = 0; i < n; i += chunk) conv.push(x.view(i, chunk), emit);
+        conv.finish(emit);
+    }
+    benchmark::DoNotOptimize(sum);
+    state.counters["block"] = double(conv.block());
+    set_coefs(state, n);
+}
+BENCHMARK(BM_streaming_convolve)->Apply(streaming_shapes);
+
+// the whole signal at once
+void BM_streaming_whole(benchmark::State& state) {
+    const int k = int(state.range(0)), n = 1 << 20;
+    const auto x = input(n, 1), kernel = input(k, 2);
+    for (auto _ : state) {
+        modvec y = x * kernel;
+        benchmark::DoNotOptimize(y);
+    }
+    set_coefs(state, n);
+}
+BENCHMARK(BM_streaming_whole)->Arg(64)->Arg(1024)->Arg(16384);
+
+BENCHMARK_MAIN();
@@ -1,9 +1,12 @@
+#include <algorithm>
 #include <array>
 #include <iostream>
 #include <vector>
 
 #include <benchmark/benchmark.h>
 
+#include "fastfps/allocator.hpp"
+#include "fastfps/dynmodint8.hpp"
 #include "fastfps/fft.hpp"
 #include "fastfps/modint.hpp"
 #include "fastfps/types.hpp"
@@ -44,4 +47,117 @@ void BM_ifft(benchmark::State& state) {
 }
 BENCHMARK(BM_ifft)->RangeMultiplier(2)->Range(1, 1 << 20);
 
+std::vector<modint8> input_blocks(int n, u32 seed) {
+    std::vector<modint8> a(n);
+    for (int i = 0; i < n; i++) {
+        std::array<u32, 8> b;
+        for (int j = 0; j < 8; j++) {
+            b[j] = i * 8 + j + seed;
+        }
+        a[i] = modint8(b);
+    }
+    return a;
+}
+
+// two independent transforms: fft2 against two fft calls
+void BM_fft_twice(benchmark::State& state) {
+    auto a = input_blocks(int(state.range(0)), 1234);
+    auto b = input_blocks(int(state.range(0)), 5678);
+    for (auto _ : state) {
+        fft(a);
+        fft(b);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_fft_twice)->RangeMultiplier(4)->Range(1, 1 << 20);
+
+void BM_fft2(benchmark::State& state) {
+    auto a = input_blocks(int(state.range(0)), 1234);
+    auto b = input_blocks(int(state.range(0)), 5678);
+    for (auto _ : state) {
+        fft2(a, b);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_fft2)->RangeMultiplier(4)->Range(1, 1 << 20);
+
+void BM_ifft_twice(benchmark::State& state) {
+    auto a = input_blocks(int(state.range(0)), 1234);
+    auto b = input_blocks(int(state.range(0)), 5678);
+    for (auto _ : state) {
+        ifft(a);
+        ifft(b);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_ifft_twice)->RangeMultiplier(4)->Range(1, 1 << 20);
+
+void BM_ifft2(benchmark::State& state) {
+    auto a = input_blocks(int(state.range(0)), 1234);
+    auto b = input_blocks(int(state.range(0)), 5678);
+    for (auto _ : state) {
+        ifft2(a, b);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_ifft2)->RangeMultiplier(4)->Range(1, 1 << 20);
+
+// fft + ifft of n blocks with each memory option of large transforms:
+// 0: none, 1: huge_pages(), 2: FFTOptions::prefetch,
+// 3: FFTOptions::stream_stores
+void BM_fft_options(benchmark::State& state) {
+    const int n = int(state.range(0)), option = int(state.range(1));
+    set_huge_pages(option == 1);
+    fft_options().prefetch = option == 2;
+    fft_options().stream_stores = option == 3;
+    std::vector<modint8, AlignedAllocator<modint8>> a(n);
+    std::ranges::copy(input_blocks(n, 1234), a.begin());
+    for (auto _ : state) {
+        fft(a);
+        ifft(a);
+        benchmark::ClobberMemory();
+    }
+    set_huge_pages(false);
+    fft_options() = {};
+}
+BENCHMARK(BM_fft_options)
+    ->ArgsProduct({{1 << 14, 1 << 16, 1 << 18, 1 << 20}, {0, 1, 2, 3}})
+    ->Unit(benchmark::kMillisecond);
+
+void BM_fft_dyn(benchmark::State& state) {
+    using dmint8 = DynModInt8<0>;
+    DynModInt<0>::set_mod(MOD);
+    std::vector<dmint8> a(state.range(0));
+    for (int i = 0; i < state.range(0); i++) {
+        std::array<u32, 8> b;
+        for (int j = 0; j < 8; j++) {
+            b[j] = i * 8 + j + 1234;
+        }
+        a[i] = dmint8(b);
+    }
+    for (auto _ : state) {
+        fft(a);
+        benchmark::DoNotOptimize(a);
+    }
+}
+BENCHMARK(BM_fft_dyn)->RangeMultiplier(2)->Range(1, 1 << 20);
+
+void BM_ifft_dyn(benchmark::State& state) {
+    using dmint8 = DynModInt8<0>;
+    DynModInt<0>::set_mod(MOD);
+    std::vector<dmint8> a(state.range(0));
+    for (int i = 0; i < state.range(0); i++) {
+        std::array<u32, 8> b;
+        for (int j = 0; j < 8; j++) {
+            b[j] = i * 8 + j + 1234;
+        }
+        a[i] = dmint8(b);
+    }
+    for (auto _ : state) {
+        ifft(a);
+        benchmark::DoNotOptimize(a);
+    }
+}
+BENCHMARK(BM_ifft_dyn)->RangeMultiplier(2)->Range(1, 1 << 20);
+
 BENCHMARK_MAIN();
@@ -0,0 +1,90 @@
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "fastfps/io.hpp"
+#include "fastfps/modint.hpp"
+#include "fastfps/modvec.hpp"
+#include "fastfps/types.hpp"
+
+using namespace fastfps;
+const u32 MOD = 998244353;
+using modint = ModInt<MOD>;
+using modvec = ModVec<MOD>;
+
+std::string input(int n) {
+    std::string s;
+    for (int i = 0; i < n; i++) {
+        s += std::to_string((u32(i) * 1234567 + 89) % MOD);
+        s += ' ';
+    }
+    return s;
+}
+
+// cin >> x into std::vector<ModInt>, then ModVec
+void BM_read_stream(benchmark::State& state) {
+    const int n = int(state.range(0));
+    const auto s = input(n);
+    for (auto _ : state) {
+        std::istringstream is(s);
+        std::vector<modint> a(n);
+        for (int i = 0; i < n; i++) {
+            int x;
+            is >> x;
+            a[i] = x;
+        }
+        modvec v(a);
+        benchmark::DoNotOptimize(v);
+    }
+}
+BENCHMARK(BM_read_stream)->Arg(500'000);
+
+void BM_read(benchmark::State& state) {
+    const int n = int(state.range(0));
+    const auto s = input(n);
+    FILE* fp = std::tmpfile();
+    std::fwrite(s.data(), 1, s.size(), fp);
+    for (auto _ : state) {
+        std::rewind(fp);
+        Reader in(fp);
+        modvec v(n);
+        in.read(v);
+        benchmark::DoNotOptimize(v);
+    }
+    std::fclose(fp);
+}
+BENCHMARK(BM_read)->Arg(500'000);
+
+modvec output(int n) {
+    std::vector<u32> a(n);
+    for (int i = 0; i < n; i++) a[i] = (u32(i) * 1234567 + 89) % MOD;
+    return modvec(a);
+}
+
+// val() and cout << x
+void BM_write_stream(benchmark::State& state) {
+    const auto v = output(int(state.range(0)));
+    for (auto _ : state) {
+        std::ostringstream os;
+        for (auto x : v.val()) os << x << " ";
+        benchmark::DoNotOptimize(os.str());
+    }
+}
+BENCHMARK(BM_write_stream)->Arg(500'000);
+
+void BM_write(benchmark::State& state) {
+    const auto v = output(int(state.range(0)));
+    FILE* fp = std::tmpfile();
+    for (auto _ : state) {
+        std::rewind(fp);
+        Writer out(fp);
+        out.write(v);
+    }
+    std::fclose(fp);
+}
+BENCHMARK(BM_write)->Arg(500'000);
+
+BENCHMARK_MAIN();
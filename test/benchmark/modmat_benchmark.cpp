@@ -0,0 +1,115 @@
+#include <array>
+#include <iostream>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "fastfps/modmat.hpp"
+#include "fastfps/modvec.hpp"
+#include "fastfps/multivariate.hpp"
+#include "fastfps/types.hpp"
+
+using namespace fastfps;
+const u32 MOD = 998244353;
+using modvec = ModVec<MOD>;
+using modmat = ModMat<MOD>;
+
+std::vector<std::vector<u32>> input(int n) {
+    std::vector<std::vector<u32>> a(n, std::vector<u32>(n));
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            a[i][j] = u32(i * 1234567 + j * 89 + 1);
+        }
+    }
+    return a;
+}
+
+// (n x n) * (n x n)
+void BM_modmat_mul(benchmark::State& state) {
+    const int n = int(state.range(0));
+    modmat a(input(n)), b(input(n));
+    for (auto _ : state) {
+        auto c = a * b;
+        benchmark::DoNotOptimize(c);
+    }
+}
+BENCHMARK(BM_modmat_mul)->RangeMultiplier(2)->Range(8, 1024);
+
+// the same product by a 1-D product with rows padded to 2n - 1
+void BM_flattened_mul(benchmark::State& state) {
+    const int n = int(state.range(0));
+    const int w = 2 * n - 1;
+    auto a = input(n);
+    std::vector<u32> flat(n * w);
+    for (int i = 0; i < n; i++) {
+        std::copy(a[i].begin(), a[i].end(), flat.begin() + i * w);
+    }
+    modvec fa(flat), fb(flat);
+    for (auto _ : state) {
+        modvec c = fa * fb;
+        benchmark::DoNotOptimize(c);
+    }
+}
+BENCHMARK(BM_flattened_mul)->RangeMultiplier(2)->Range(8, 1024);
+
+// k variables of degree < 2^(lg / k), total size 2^lg
+const int LG = 18;
+
+void BM_multivariate(benchmark::State& state) {
+    const int k = int(state.range(0));
+    std::vector<int> base(k, 1 << (LG / k));
+    base[0] <<= LG % k;
+    std::vector<u32> a(1 << LG);
+    for (int i = 0; i < (1 << LG); i++) {
+        a[i] = u32(i) * 1234567 + 1;
+    }
+    modvec fa(a), fb(a);
+    for (auto _ : state) {
+        auto c = multivariate_convolution(fa, fb, base);
+        benchmark::DoNotOptimize(c);
+    }
+}
+BENCHMARK(BM_multivariate)->DenseRange(1, 6);
+
+// the same product by a 1-D product padded to (2 n_1 - 1)(2 n_2 - 1)...
+void BM_multivariate_flattened(benchmark::State& state) {
+    const int k = int(state.range(0));
+    std::vector<int> base(k, 1 << (LG / k));
+    base[0] <<= LG % k;
+    ssize_t size = 1;
+    for (int x : base) size *= 2 * x - 1;
+    std::vector<u32> a(size);
+    for (int i = 0; i < (1 << LG); i++) {
+        ssize_t j = 0, prod = 1;
+        for (int l = 0, r = i; l < k; l++) {
+            j += (r % base[l]) * prod;
+            r /= base[l];
+            prod *= 2 * base[l] - 1;
+        }
+        a[j] = u32(i) * 1234567 + 1;
+    }
+    modvec fa(a), fb(a);
+    for (auto _ : state) {
+        modvec c = fa * fb;
+        benchmark::DoNotOptimize(c);
+    }
+}
+BENCHMARK(BM_multivariate_flattened)->DenseRange(1, 6);
+
+// k variables truncated to total degree < 2^(lg / k), in the box of
+// BM_multivariate (lg % k == 0)
+void BM_total_degree(benchmark::State& state) {
+    const int k = int(state.range(0));
+    std::vector<u32> a(1 << LG);
+    for (int i = 0; i < (1 << LG); i++) {
+        a[i] = u32(i) * 1234567 + 1;
+    }
+    modvec fa(a), fb(a);
+    for (auto _ : state) {
+        auto c = total_degree_convolution(fa, fb, 1 << (LG / k), k);
+        benchmark::DoNotOptimize(c);
+    }
+}
+BENCHMARK(BM_total_degree)->Arg(1)->Arg(2)->Arg(3)->Arg(6);
+
+BENCHMARK_MAIN();
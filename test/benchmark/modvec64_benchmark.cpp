@@ -0,0 +1,63 @@
+#include <array>
+#include <iostream>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "fastfps/modvec.hpp"
+#include "fastfps/modvec64.hpp"
+#include "fastfps/types.hpp"
+
+using namespace fastfps;
+
+// exact convolution of a[i], b[i] < 2^20 with n <= 2^20 (result < 2^60)
+std::vector<u32> random_input(int n) {
+    std::vector<u32> a(n);
+    for (int i = 0; i < n; i++) {
+        a[i] = u32(i * 1234567 + 89) & ((1 << 20) - 1);
+    }
+    return a;
+}
+
+void BM_mul_modvec64(benchmark::State& state) {
+    const u64 MOD = 4179340454199820289;
+    const int n = int(state.range(0));
+    auto a0 = random_input(n);
+    std::vector<u64> a(a0.begin(), a0.end());
+    auto b = a;
+    for (auto _ : state) {
+        auto c = (ModVec64<MOD>(a) * ModVec64<MOD>(b)).val();
+        benchmark::DoNotOptimize(c);
+    }
+}
+BENCHMARK(BM_mul_modvec64)->RangeMultiplier(4)->Range(1 << 10, 1 << 20);
+
+void BM_mul_three_primes(benchmark::State& state) {
+    const u32 MOD1 = 167772161, MOD2 = 469762049, MOD3 = 754974721;
+    const int n = int(state.range(0));
+    auto a = random_input(n);
+    auto b = a;
+
+    using m2 = ModInt<MOD2>;
+    using m3 = ModInt<MOD3>;
+    const m2 i1_2 = m2(MOD1).inv();
+    const m3 i12_3 = (m3(MOD1) * m3(MOD2)).inv();
+    for (auto _ : state) {
+        auto c1 = (ModVec<MOD1>(a) * ModVec<MOD1>(b)).val();
+        auto c2 = (ModVec<MOD2>(a) * ModVec<MOD2>(b)).val();
+        auto c3 = (ModVec<MOD3>(a) * ModVec<MOD3>(b)).val();
+
+        // garner
+        std::vector<u64> c(c1.size());
+        for (size_t i = 0; i < c.size(); i++) {
+            u64 x1 = c1[i];
+            u64 x2 = ((m2(c2[i]) - m2(c1[i])) * i1_2).val();
+            u64 x3 = ((m3(c3[i]) - m3(x1) - m3(x2) * m3(MOD1)) * i12_3).val();
+            c[i] = x1 + x2 * MOD1 + x3 * MOD1 * MOD2;
+        }
+        benchmark::DoNotOptimize(c);
+    }
+}
+BENCHMARK(BM_mul_three_primes)->RangeMultiplier(4)->Range(1 << 10, 1 << 20);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,133 @@
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "fastfps/modvec.hpp"
+#include "fastfps/modvec_file.hpp"
+#include "fastfps/types.hpp"
+
+#include "alloc_counter.hpp"
+
+using namespace fastfps;
+const u32 MOD = 998244353;
+using modvec = ModVec<MOD>;
+
+modvec input(int n, int seed) {
+    std::vector<u32> a(n);
+    for (int i = 0; i < n; i++) {
+        a[i] = u32(i) * 1234567 + u32(seed);
+    }
+    a[0] = 1;
+    return modvec(a);
+}
+
+// heap allocations per iteration
+void count_allocs(benchmark::State& state, long long start) {
+    state.counters["allocs"] = benchmark::Counter(
+        double(alloc_count() - start), benchmark::Counter::kAvgIterations);
+}
+
+void BM_mul(benchmark::State& state) {
+    const int n = int(state.range(0));
+    auto a = input(n, 1), b = input(n, 2);
+    modvec c;
+    c = a;
+    c *= b;  // warm up the workspace
+    const long long start = alloc_count();
+    for (auto _ : state) {
+        c = a;
+        c *= b;
+        benchmark::DoNotOptimize(c);
+    }
+    count_allocs(state, start);
+}
+BENCHMARK(BM_mul)->RangeMultiplier(4)->Range(1 << 10, 1 << 20);
+
+// |a| = |b| = n around and beyond the largest transform of MOD (2^23
+// coefficients): products over 2^23 are split by modvec::mul_split
+void BM_mul_long(benchmark::State& state) {
+    const int n = int(state.range(0));
+    auto a = input(n, 1), b = input(n, 2);
+    for (auto _ : state) {
+        modvec c = a;
+        c *= b;
+        benchmark::DoNotOptimize(c);
+    }
+    state.SetItemsProcessed(state.iterations() * (2 * i64(n) - 1));
+}
+BENCHMARK(BM_mul_long)
+    ->Arg(1 << 21)
+    ->Arg(1 << 22)
+    ->Arg((1 << 22) + (1 << 20))
+    ->Arg(1 << 23)
+    ->Arg(1 << 24)
+    ->Arg(1 << 25)
+    ->Unit(benchmark::kMillisecond);
+
+void BM_inv(benchmark::State& state) {
+    const int n = int(state.range(0));
+    auto a = input(n, 1);
+    benchmark::DoNotOptimize(a.inv(n));
+    const long long start = alloc_count();
+    for (auto _ : state) {
+        auto c = a.inv(n);
+        benchmark::DoNotOptimize(c);
+    }
+    count_allocs(state, start);
+}
+BENCHMARK(BM_inv)->RangeMultiplier(4)->Range(1 << 10, 1 << 20);
+
+void BM_berlekamp_massey(benchmark::State& state) {
+    const int n = int(state.range(0));
+    auto a = input(n, 1);
+    const long long start = alloc_count();
+    for (auto _ : state) {
+        auto c = a.berlekamp_massey();
+        benchmark::DoNotOptimize(c);
+    }
+    count_allocs(state, start);
+}
+BENCHMARK(BM_berlekamp_massey)->RangeMultiplier(4)->Range(1 << 8, 1 << 12);
+
+// file of a ModVec of size n
+struct SavedModVec {
+    std::string path;
+    explicit SavedModVec(int n)
+        : path(std::filesystem::temp_directory_path() /
+               "fastfps_modvec_benchmark.bin") {
+        save_modvec(input(n, 1), path);
+    }
+    ~SavedModVec() { std::filesystem::remove(path); }
+};
+
+void BM_load(benchmark::State& state) {
+    SavedModVec file(int(state.range(0)));
+    for (auto _ : state) {
+        auto a = load_modvec<modvec>(file.path);
+        benchmark::DoNotOptimize(a);
+    }
+}
+BENCHMARK(BM_load)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+
+// text round trip through val(), for comparison
+void BM_load_val(benchmark::State& state) {
+    const auto v = input(int(state.range(0)), 1).val();
+    for (auto _ : state) {
+        modvec a(v);
+        benchmark::DoNotOptimize(a);
+    }
+}
+BENCHMARK(BM_load_val)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+
+void BM_map(benchmark::State& state) {
+    SavedModVec file(int(state.range(0)));
+    for (auto _ : state) {
+        auto a = map_modvec<modvec>(file.path);
+        benchmark::DoNotOptimize(a.val(0));
+    }
+}
+BENCHMARK(BM_map)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,24 @@
+// verification-helper: PROBLEM https://judge.yosupo.jp/problem/composition_of_formal_power_series
+#include "fastfps/io.hpp"
+#include "fastfps/modint.hpp"
+#include "fastfps/modvec.hpp"
+
+using namespace std;
+using namespace fastfps;
+
+const int MOD = 998244353;
+using mint = ModInt<MOD>;
+using mvec = ModVec<MOD>;
+
+int main() {
+    Reader in;
+    Writer out;
+
+    int n = in.read<int>();
+    mvec a(n), b(n);
+    in.read(a);
+    in.read(b);
+
+    out.write(a.compose(b, n));
+    out.write('\n');
+}
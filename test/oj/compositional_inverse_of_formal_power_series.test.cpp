@@ -0,0 +1,23 @@
+// verification-helper: PROBLEM https://judge.yosupo.jp/problem/compositional_inverse_of_formal_power_series
+#include "fastfps/io.hpp"
+#include "fastfps/modint.hpp"
+#include "fastfps/modvec.hpp"
+
+using namespace std;
+using namespace fastfps;
+
+const int MOD = 998244353;
+using mint = ModInt<MOD>;
+using mvec = ModVec<MOD>;
+
+int main() {
+    Reader in;
+    Writer out;
+
+    int n = in.read<int>();
+    mvec a(n);
+    in.read(a);
+
+    out.write(a.compositional_inverse(n));
+    out.write('\n');
+}
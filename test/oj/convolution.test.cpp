@@ -1,9 +1,5 @@
 // verification-helper: PROBLEM https://judge.yosupo.jp/problem/convolution_mod
-#include <cstdio>
-#include <vector>
-#include <array>
-#include <iostream>
-
+#include "fastfps/io.hpp"
 #include "fastfps/modint.hpp"
 #include "fastfps/modvec.hpp"
 
@@ -15,30 +11,14 @@ using mint = ModInt<MOD>;
 using mvec = ModVec<MOD>;
 
 int main() {
-    ios::sync_with_stdio(false);
-    cin.tie(nullptr);
-
-    int n, m;
-    cin >> n >> m;
-
-    std::vector<mint> a(n);
-    for (int i = 0; i < n; i++) {
-        int x;
-        cin >> x;
-        a[i] = x;
-    }
-    std::vector<mint> b(m);
-    for (int i = 0; i < m; i++) {
-        int x;
-        cin >> x;
-        b[i] = x;
-    }
+    Reader in;
+    Writer out;
 
-    mvec a2(a), b2(b);
+    int n = in.read<int>(), m = in.read<int>();
+    mvec a(n), b(m);
+    in.read(a);
+    in.read(b);
 
-    auto c = (a2 * b2).val();
-    for (auto x : c) {
-        cout << x << " ";
-    }
-    cout << endl;
+    out.write(mvec(a * b));
+    out.write('\n');
 }
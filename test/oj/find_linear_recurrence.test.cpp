@@ -1,8 +1,5 @@
 // verification-helper: PROBLEM https://judge.yosupo.jp/problem/find_linear_recurrence
-#include <cstdio>
-#include <vector>
-#include <iostream>
-
+#include "fastfps/io.hpp"
 #include "fastfps/modint.hpp"
 #include "fastfps/modvec.hpp"
 
@@ -14,27 +11,18 @@ using mint = ModInt<MOD>;
 using mvec = ModVec<MOD>;
 
 int main() {
-    ios::sync_with_stdio(false);
-    cin.tie(nullptr);
-
-    int n;
-    cin >> n;
-
-    std::vector<mint> a(n);
-    for (int i = 0; i < n; i++) {
-        int x;
-        cin >> x;
-        a[i] = x;
-    }
+    Reader in;
+    Writer out;
 
-    auto c = mvec(a).berlekamp_massey().val();
+    int n = in.read<int>();
+    mvec a(n);
+    in.read(a);
 
-    auto m = ssize(c);
+    auto c = a.berlekamp_massey();
+    const int m = int(c.size());
 
-    cout << m - 1 << endl;
-    for (int i = 0; i < m - 1; i++) {
-        if (i) cout << " ";
-        cout << c[i + 1];
-    }
-    cout << endl;
+    out.write(m - 1);
+    out.write('\n');
+    out.write(c.substr(1, m - 1));
+    out.write('\n');
 }
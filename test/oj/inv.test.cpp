@@ -1,9 +1,5 @@
 // verification-helper: PROBLEM https://judge.yosupo.jp/problem/inv_of_formal_power_series
-#include <array>
-#include <cstdio>
-#include <iostream>
-#include <vector>
-
+#include "fastfps/io.hpp"
 #include "fastfps/modint.hpp"
 #include "fastfps/modvec.hpp"
 
@@ -15,26 +11,15 @@ using mint = ModInt<MOD>;
 using mvec = ModVec<MOD>;
 
 int main() {
-    ios::sync_with_stdio(false);
-    cin.tie(nullptr);
-
-    int n;
-    cin >> n;
-
-    std::vector<mint> a(n);
-    for (int i = 0; i < n; i++) {
-        int x;
-        cin >> x;
-        a[i] = x;
-    }
+    Reader in;
+    Writer out;
 
-    mvec f(a);
+    int n = in.read<int>();
+    mvec f(n);
+    in.read(f);
 
-    mint a0 = a[0];
+    mint a0 = f.val(0);
 
-    auto c = ((f * a0.inv()).inv(n) * a0.inv()).val();
-    for (auto x : c) {
-        cout << x << " ";
-    }
-    cout << endl;
+    out.write(mvec(mvec(f * a0.inv()).inv(n) * a0.inv()));
+    out.write('\n');
 }
@@ -0,0 +1,25 @@
+// verification-helper: PROBLEM https://judge.yosupo.jp/problem/matrix_det
+#include <vector>
+
+#include "fastfps/io.hpp"
+#include "fastfps/modmatrix.hpp"
+
+using namespace std;
+using namespace fastfps;
+
+const int MOD = 998244353;
+using mmat = ModMatrix<MOD>;
+
+int main() {
+    Reader in;
+    Writer out;
+
+    int n = in.read<int>();
+    vector<vector<u32>> a(n, vector<u32>(n));
+    for (auto& row : a) {
+        for (auto& x : row) x = in.read<u32>();
+    }
+
+    out.write(mmat(a).det().val());
+    out.write('\n');
+}
@@ -0,0 +1,38 @@
+// verification-helper: PROBLEM https://judge.yosupo.jp/problem/matrix_product
+#include <vector>
+
+#include "fastfps/io.hpp"
+#include "fastfps/modmatrix.hpp"
+
+using namespace std;
+using namespace fastfps;
+
+const int MOD = 998244353;
+using mmat = ModMatrix<MOD>;
+
+vector<vector<u32>> read_matrix(Reader& in, int h, int w) {
+    vector<vector<u32>> a(h, vector<u32>(w));
+    for (auto& row : a) {
+        for (auto& x : row) x = in.read<u32>();
+    }
+    return a;
+}
+
+int main() {
+    Reader in;
+    Writer out;
+
+    int n = in.read<int>(), m = in.read<int>(), k = in.read<int>();
+    mmat a(read_matrix(in, n, m)), b(read_matrix(in, m, k));
+    // the shape of an empty matrix is lost in vector<vector<u32>>
+    if (n == 0) a = mmat(0, m);
+    if (m == 0) b = mmat(0, k);
+
+    for (const auto& row : (a * b).val()) {
+        for (int j = 0; j < k; j++) {
+            if (j) out.write(' ');
+            out.write(row[j]);
+        }
+        out.write('\n');
+    }
+}
@@ -0,0 +1,34 @@
+// verification-helper: PROBLEM https://judge.yosupo.jp/problem/multivariate_convolution
+#include <vector>
+
+#include "fastfps/io.hpp"
+#include "fastfps/modint.hpp"
+#include "fastfps/modvec.hpp"
+#include "fastfps/multivariate.hpp"
+
+using namespace std;
+using namespace fastfps;
+
+const int MOD = 998244353;
+using mint = ModInt<MOD>;
+using mvec = ModVec<MOD>;
+
+int main() {
+    Reader in;
+    Writer out;
+
+    int k = in.read<int>();
+    std::vector<int> base(k);
+    int n = 1;
+    for (int i = 0; i < k; i++) {
+        base[i] = in.read<int>();
+        n *= base[i];
+    }
+
+    mvec a(n), b(n);
+    in.read(a);
+    in.read(b);
+
+    out.write(multivariate_convolution(a, b, base));
+    out.write('\n');
+}
@@ -0,0 +1,24 @@
+// verification-helper: PROBLEM https://judge.yosupo.jp/problem/polynomial_taylor_shift
+#include "fastfps/io.hpp"
+#include "fastfps/modint.hpp"
+#include "fastfps/modvec.hpp"
+
+using namespace std;
+using namespace fastfps;
+
+const int MOD = 998244353;
+using mint = ModInt<MOD>;
+using mvec = ModVec<MOD>;
+
+int main() {
+    Reader in;
+    Writer out;
+
+    int n = in.read<int>();
+    mint c = in.read<u32>();
+    mvec a(n);
+    in.read(a);
+
+    out.write(a.taylor_shift(c));
+    out.write('\n');
+}
@@ -0,0 +1,29 @@
+// verification-helper: PROBLEM https://judge.yosupo.jp/problem/product_of_polynomial_sequence
+#include <vector>
+
+#include "fastfps/batch.hpp"
+#include "fastfps/io.hpp"
+#include "fastfps/modint.hpp"
+#include "fastfps/modvec.hpp"
+
+using namespace std;
+using namespace fastfps;
+
+const int MOD = 998244353;
+using mint = ModInt<MOD>;
+using mvec = ModVec<MOD>;
+
+int main() {
+    Reader in;
+    Writer out;
+
+    int n = in.read<int>();
+    vector<mvec> fs(n);
+    for (auto& f : fs) {
+        f = mvec(in.read<int>() + 1);
+        in.read(f);
+    }
+
+    out.write(product(fs));
+    out.write('\n');
+}
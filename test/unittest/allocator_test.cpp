@@ -0,0 +1,110 @@
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "fastfps/allocator.hpp"
+#include "fastfps/modint8.hpp"
+#include "fastfps/modvec.hpp"
+
+using namespace fastfps;
+
+const u32 MOD = 998244353;
+using modint8 = ModInt8<MOD>;
+using modvec = ModVec<MOD>;
+
+bool aligned(const void* p, uintptr_t align) {
+    return reinterpret_cast<uintptr_t>(p) % align == 0;
+}
+
+TEST(AllocatorTest, Aligned) {
+    for (int n : {1, 3, 100, 1000}) {
+        std::vector<char, AlignedAllocator<char>> a(n);
+        ASSERT_TRUE(aligned(a.data(), 64));
+        std::vector<modint8, AlignedAllocator<modint8, 32>> b(n);
+        ASSERT_TRUE(aligned(b.data(), 32));
+    }
+    modvec v(1000);
+    ASSERT_TRUE(aligned(v.blocks().data(), 64));
+}
+
+TEST(AllocatorTest, HugePages) {
+    ASSERT_FALSE(huge_pages());
+    // 4 MiB or more: aligned to a huge page, whether it is advised or not
+    for (bool on : {true, false}) {
+        set_huge_pages(on);
+        std::vector<modint8, AlignedAllocator<modint8>> a(1 << 17);
+        ASSERT_TRUE(aligned(a.data(), 2 << 20));
+        a.back() = modint8::set1(1);
+        Workspace::Frame frame;
+        auto b = frame.alloc<modint8>(1 << 18);
+        ASSERT_TRUE(aligned(b.data(), 64));
+        b[0] = a.back();
+    }
+    set_huge_pages(false);
+    std::vector<char, AlignedAllocator<char>> c(1000);
+    ASSERT_TRUE(aligned(c.data(), 64));
+}
+
+TEST(WorkspaceTest, Alloc) {
+    Workspace::Frame frame;
+    auto a = frame.alloc<modint8>(10);
+    auto b = frame.alloc<char>(1);
+    auto c = frame.alloc<u32>(100);
+    ASSERT_TRUE(aligned(a.data(), 64));
+    ASSERT_TRUE(aligned(b.data(), 64));
+    ASSERT_TRUE(aligned(c.data(), 64));
+    for (auto x : a) ASSERT_EQ(modint8(), x);
+    a[9] = modint8::set1(1);
+    c[99] = 1;
+    ASSERT_EQ(modint8::set1(1), a[9]);
+}
+
+TEST(WorkspaceTest, Reuse) {
+    auto run = [&]() {
+        Workspace::Frame frame;
+        auto a = frame.alloc<modint8>(1000);
+        {
+            Workspace::Frame frame2;
+            auto b = frame2.alloc<modint8>(2000);
+            b[1999] = a[999];
+        }
+        auto c = frame.alloc<modint8>(500);
+        return std::pair(a.data(), c.data());
+    };
+    run();
+    const size_t cap = Workspace::get().capacity();
+    ASSERT_GE(cap, 3000 * sizeof(modint8));
+    auto p = run();
+    // the second call fits in the main buffer
+    ASSERT_EQ(cap, Workspace::get().capacity());
+    ASSERT_EQ(p, run());
+}
+
+TEST(WorkspaceTest, ExtraBlocks) {
+    // in a new thread, with an empty workspace
+    std::vector<size_t> extra;
+    size_t cap = 0;
+    std::thread([&] {
+        auto& ws = Workspace::get();
+        {
+            Workspace::Frame outer;
+            outer.alloc<modint8>(100);
+            for (int i = 0; i < 10; i++) {
+                Workspace::Frame inner;
+                inner.alloc<modint8>(1000);
+                extra.push_back(ws.extra_bytes());
+            }
+            // the blocks of the inner frames are freed with them
+            extra.push_back(ws.extra_bytes());
+        }
+        cap = ws.capacity();
+    }).join();
+    for (int i = 0; i < 10; i++) {
+        ASSERT_EQ(100 * sizeof(modint8) + 1000 * sizeof(modint8), extra[i]);
+    }
+    ASSERT_EQ(100 * sizeof(modint8), extra[10]);
+    // grown to the peak
+    ASSERT_GE(cap, 1100 * sizeof(modint8));
+}
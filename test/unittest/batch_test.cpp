@@ -0,0 +1,124 @@
+#include <array>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "fastfps/batch.hpp"
+#include "fastfps/modvec.hpp"
+
+#include "random.hpp"
+
+using namespace fastfps;
+
+const u32 MOD = 998244353;
+using modint = ModInt<MOD>;
+using modvec = ModVec<MOD>;
+
+TEST(BatchTest, Convolve) {
+    for (int k : {0, 1, 7, 8, 9, 30}) {
+        std::vector<modvec> a, b;
+        for (int i = 0; i < k; i++) {
+            a.push_back(random_modvec<modvec>(randint(0, 300)));
+            b.push_back(random_modvec<modvec>(randint(0, 20)));
+        }
+        auto c = batch_convolve(a, b);
+        ASSERT_EQ(size_t(k), c.size());
+        for (int i = 0; i < k; i++) {
+            ASSERT_EQ(a[i] * b[i], c[i]);
+        }
+    }
+}
+
+TEST(BatchTest, ConvolveSmall) {
+    std::vector<modvec> a = {modvec({1, 2, 3}), modvec({1}), modvec({1, 1})};
+    std::vector<modvec> b = {modvec({4, 5, 6}), modvec({7}), modvec({-1, 1})};
+    std::vector<modvec> expect = {modvec({4, 13, 28, 27, 18}), modvec({7}),
+                                  modvec({-1, 0, 1})};
+    ASSERT_EQ(expect, batch_convolve(a, b));
+}
+
+TEST(BatchTest, DynMod) {
+    using dmvec = DynModVec<0>;
+    DynModInt<0>::set_mod(469762049);
+    std::vector<dmvec> a, b;
+    for (int i = 0; i < 10; i++) {
+        std::vector<u32> x(randint(1, 50)), y(randint(1, 50));
+        for (auto& e : x) e = randint(0u, 469762048u);
+        for (auto& e : y) e = randint(0u, 469762048u);
+        a.push_back(dmvec(x));
+        b.push_back(dmvec(y));
+    }
+    auto c = batch_convolve(a, b);
+    for (int i = 0; i < 10; i++) {
+        ASSERT_EQ(a[i] * b[i], c[i]);
+    }
+    DynModInt<0>::set_mod(998244353);
+}
+
+// fs[l] * ... * fs[r - 1] by a plain divide and conquer
+template <class modvec>
+modvec product_naive(const std::vector<modvec>& fs, size_t l, size_t r) {
+    if (r - l == 1) return fs[l];
+    const size_t mid = (l + r) / 2;
+    return product_naive(fs, l, mid) * product_naive(fs, mid, r);
+}
+
+TEST(BatchTest, Product) {
+    ASSERT_EQ(modvec({1}), product(std::vector<modvec>()));
+    ASSERT_EQ(modvec(), product(std::vector<modvec>{modvec({1, 2}),
+                                                    modvec()}));
+    for (int k : {1, 2, 3, 10, 1000}) {
+        for (int max_len : {2, 5, 300}) {
+            std::vector<modvec> fs;
+            for (int i = 0; i < k; i++) {
+                fs.push_back(random_modvec<modvec>(randint(1, max_len)));
+            }
+            ASSERT_EQ(product_naive(fs, 0, k), product(fs));
+        }
+    }
+    // a partial last row whose largest factor is in another lane than the
+    // largest of the first row
+    std::vector<modvec> fs(7, modvec({1, 1}));
+    fs.push_back(random_modvec<modvec>(20));
+    fs.push_back(random_modvec<modvec>(20));
+    ASSERT_EQ(product_naive(fs, 0, fs.size()), product(fs));
+}
+
+TEST(BatchTest, ProductDynMod) {
+    // the workers must use the modulus of the caller
+    using dmvec = DynModVec<1>;
+    const u32 mod = 469762049;
+    DynModInt<1>::set_mod(mod);
+    set_num_threads(4);
+    std::vector<dmvec> fs;
+    for (int i = 0; i < 3000; i++) {
+        fs.push_back(dmvec(std::vector<u32>{1, randint(0u, mod - 1)}));
+    }
+    ASSERT_EQ(product_naive(fs, 0, fs.size()), product(fs));
+    set_num_threads(1);
+    DynModInt<1>::set_mod(998244353);
+}
+
+TEST(BatchTest, Inv) {
+    for (int n : {0, 1, 7, 8, 9, 100}) {
+        std::vector<modint> a(n);
+        for (auto& x : a) x = modint(randint(1u, MOD - 1));
+        auto b = a;
+        batch_inv(std::span(b));
+        for (int i = 0; i < n; i++) ASSERT_EQ(modint(1), a[i] * b[i]);
+    }
+}
+
+TEST(BatchTest, InvDynMod) {
+    using dmint = DynModInt<7>;
+    dmint::set_mod(1'000'000'005);  // 5 * 200000001
+    std::vector<dmint> a, b;
+    for (u32 x = 1; a.size() < 50; x += 3) {
+        if (x % 5) a.push_back(dmint(x));
+    }
+    b = a;
+    batch_inv(std::span(b));
+    for (size_t i = 0; i < a.size(); i++) ASSERT_EQ(dmint(1), a[i] * b[i]);
+}
@@ -0,0 +1,78 @@
+#include <bit>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "fastfps/bitwise.hpp"
+#include "fastfps/modvec.hpp"
+
+#include "random.hpp"
+
+using namespace fastfps;
+
+const u32 MOD = 998244353;
+using modint = ModInt<MOD>;
+using modvec = ModVec<MOD>;
+
+std::vector<modint> random_vec(int n) {
+    std::vector<modint> a(n);
+    for (auto& x : a) x = randint(0u, MOD - 1);
+    return a;
+}
+
+template <class F>
+modvec naive(const std::vector<modint>& a, const std::vector<modint>& b, F op) {
+    const int n = int(a.size());
+    std::vector<modint> c(n);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            int k = op(i, j);
+            if (k >= 0) c[k] += a[i] * b[j];
+        }
+    }
+    return modvec(c);
+}
+
+TEST(BitwiseTest, Xor) {
+    for (int n = 1; n <= 512; n *= 2) {
+        auto a = random_vec(n), b = random_vec(n);
+        auto expect = naive(a, b, [](int i, int j) { return i ^ j; });
+        ASSERT_EQ(expect, xor_convolution(modvec(a), modvec(b)));
+    }
+}
+
+TEST(BitwiseTest, And) {
+    for (int n = 1; n <= 512; n *= 2) {
+        auto a = random_vec(n), b = random_vec(n);
+        auto expect = naive(a, b, [](int i, int j) { return i & j; });
+        ASSERT_EQ(expect, and_convolution(modvec(a), modvec(b)));
+    }
+}
+
+TEST(BitwiseTest, Or) {
+    for (int n = 1; n <= 512; n *= 2) {
+        auto a = random_vec(n), b = random_vec(n);
+        auto expect = naive(a, b, [](int i, int j) { return i | j; });
+        ASSERT_EQ(expect, or_convolution(modvec(a), modvec(b)));
+    }
+}
+
+TEST(BitwiseTest, Subset) {
+    for (int n = 1; n <= 512; n *= 2) {
+        auto a = random_vec(n), b = random_vec(n);
+        auto expect =
+            naive(a, b, [](int i, int j) { return (i & j) ? -1 : (i | j); });
+        ASSERT_EQ(expect, subset_convolution(modvec(a), modvec(b)));
+    }
+}
+
+TEST(BitwiseTest, ZetaMobius) {
+    auto a = modvec(random_vec(256));
+    auto b = a;
+    subset_zeta(b.blocks());
+    superset_zeta(b.blocks());
+    ASSERT_NE(a, b);
+    superset_zeta<true>(b.blocks());
+    subset_zeta<true>(b.blocks());
+    ASSERT_EQ(a, b);
+}
@@ -0,0 +1,79 @@
+#include <array>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "fastfps/dynmodint.hpp"
+#include "fastfps/dynmodint8.hpp"
+#include "fastfps/modint.hpp"
+#include "fastfps/types.hpp"
+
+#include "random.hpp"
+
+using namespace fastfps;
+
+using dmint = DynModInt<0>;
+using dmint8 = DynModInt8<0>;
+
+TEST(DynModIntTest, SetMod) {
+    dmint::set_mod(998244353);
+    ASSERT_EQ(998244353u, dmint::mod());
+    ASSERT_EQ(998244353u, dmint8::mod());
+    dmint::set_mod(1000000007);
+    ASSERT_EQ(1000000007u, dmint::mod());
+    dmint::set_mod(998244353);
+}
+
+TEST(DynModIntTest, Arithmetic) {
+    for (u32 mod : {998244353u, 469762049u, 167772161u, 1000003u, 3u}) {
+        dmint::set_mod(mod);
+        for (int iter = 0; iter < 100; iter++) {
+            u32 a = randint(0u, mod - 1), b = randint(0u, mod - 1);
+            ASSERT_EQ((a + b) % mod, (dmint(a) + dmint(b)).val());
+            ASSERT_EQ((a + mod - b) % mod, (dmint(a) - dmint(b)).val());
+            ASSERT_EQ(u64(a) * b % mod, (dmint(a) * dmint(b)).val());
+            if (a) {
+                ASSERT_EQ(dmint(1), dmint(a) * dmint(a).inv());
+            }
+        }
+        ASSERT_EQ(mod - 3, dmint(i64(-3)).val());
+        ASSERT_EQ(dmint(0), dmint(0).inv());
+    }
+    dmint::set_mod(998244353);
+}
+
+TEST(DynModIntTest, SameAsStatic) {
+    const u32 MOD = 998244353;
+    dmint::set_mod(MOD);
+    for (int iter = 0; iter < 100; iter++) {
+        u32 a = randint(0u, MOD - 1), b = randint(0u, MOD - 1);
+        ASSERT_EQ((ModInt<MOD>(a) * ModInt<MOD>(b)).internal_val(),
+                  (dmint(a) * dmint(b)).internal_val());
+    }
+}
+
+TEST(DynModInt8Test, Arithmetic) {
+    for (u32 mod : {998244353u, 469762049u, 1000003u}) {
+        dmint::set_mod(mod);
+        std::array<u32, 8> a, b;
+        for (int j = 0; j < 8; j++) {
+            a[j] = randint(0u, mod - 1);
+            b[j] = randint(0u, mod - 1);
+        }
+        std::array<u32, 8> add, sub, mul;
+        for (int j = 0; j < 8; j++) {
+            add[j] = (a[j] + b[j]) % mod;
+            sub[j] = (a[j] + mod - b[j]) % mod;
+            mul[j] = u32(u64(a[j]) * b[j] % mod);
+        }
+        ASSERT_EQ(add, (dmint8(a) + dmint8(b)).val());
+        ASSERT_EQ(sub, (dmint8(a) - dmint8(b)).val());
+        ASSERT_EQ(mul, (dmint8(a) * dmint8(b)).val());
+
+        dmint8 c(std::array<i32, 8>({-1, 2, -3, 4, -5, 6, -7, 8}));
+        ASSERT_EQ(dmint8(-1, 2, -3, 4, -5, 6, -7, 8), c);
+    }
+    dmint::set_mod(998244353);
+}
@@ -0,0 +1,51 @@
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "fastfps/factorial.hpp"
+#include "fastfps/modint.hpp"
+#include "fastfps/modint8.hpp"
+
+using namespace fastfps;
+
+const u32 MOD = 998244353;
+using modint = ModInt<MOD>;
+using modint8 = ModInt8<MOD>;
+
+TEST(FactorialTest, Fill) {
+    for (int m : {0, 1, 2, 3, 100}) {
+        std::vector<modint8> fact(m), inv_fact(m);
+        fill_factorials(std::span<modint8>(fact), std::span<modint8>(inv_fact));
+        modint f = 1;
+        for (int i = 0; i < 8 * m; i++) {
+            if (i) f *= modint(i);
+            ASSERT_EQ(f.val(), fact[i / 8].val()[i % 8]);
+            ASSERT_EQ(f.inv().val(), inv_fact[i / 8].val()[i % 8]);
+        }
+    }
+}
+
+TEST(FactorialTest, LaneProduct) {
+    const modint8 x(modint(2), modint(3), modint(5), modint(7), modint(11),
+                    modint(13), modint(17), modint(19));
+    auto pre = internal::lane_prefix_product(x).val();
+    auto suf = internal::lane_suffix_product(x).val();
+    auto a = x.val();
+    for (int i = 0; i < 8; i++) {
+        modint p = 1, s = 1;
+        for (int j = 0; j <= i; j++) p *= modint(a[j]);
+        for (int j = i; j < 8; j++) s *= modint(a[j]);
+        ASSERT_EQ(p.val(), pre[i]);
+        ASSERT_EQ(s.val(), suf[i]);
+    }
+}
+
+TEST(FactorialTest, Inverses) {
+    for (int m : {0, 1, 2, 3, 100}) {
+        std::vector<modint8> inv(m);
+        fill_inverses(std::span<modint8>(inv));
+        for (int i = 0; i < 8 * m; i++) {
+            ASSERT_EQ(i ? modint(i).inv().val() : 0u, inv[i / 8].val()[i % 8]);
+        }
+    }
+}
@@ -0,0 +1,81 @@
+#include <array>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "fastfps/fft64.hpp"
+#include "fastfps/types.hpp"
+
+#include "random.hpp"
+
+using namespace fastfps;
+
+const u64 MOD = 4179340454199820289;
+using modint = ModInt64<MOD>;
+using modint4 = ModInt64x4<MOD>;
+
+TEST(FFT64Test, FFTInfo) {
+    const auto& info = fft_info64<MOD>;
+    // 4179340454199820289 = 2^57 * 29 + 1
+    ASSERT_EQ(57, info.ord2);
+    for (int i = 0; i < info.ord2; i++) {
+        ASSERT_EQ(modint(1), info.w[i] * info.iw[i]);
+    }
+    ASSERT_EQ(modint(MOD - 1), info.w[1]);
+    // 2^57 coefficients in elements of 4
+    ASSERT_EQ(ssize_t(1) << 55, max_fft64_size<MOD>());
+}
+
+std::vector<modint> naive_dft(const std::vector<modint>& b, bool inverse) {
+    const auto& info = fft_info64<MOD>;
+
+    int n = int(b.size());
+    std::vector<modint> c(n);
+    for (int i = 0; i < n; i++) {
+        modint base = 1;
+        for (int h = 0; (i >> h) > 0; h++) {
+            if (i & (1 << h)) {
+                base = base * (inverse ? info.iw[h + 1] : info.w[h + 1]);
+            }
+        }
+        modint rot = 1;
+        for (int j = 0; j < n; j++) {
+            if (inverse) {
+                c[j] += b[i] * rot;
+            } else {
+                c[i] += b[j] * rot;
+            }
+            rot = rot * base;
+        }
+    }
+    return c;
+}
+
+TEST(FFT64Test, ButterflyStress) {
+    for (bool inverse : {false, true}) {
+        for (int lg = 0; lg <= 7; lg++) {
+            int n = 1 << lg;
+            std::vector<modint> b(4 * n);
+            for (auto& x : b) x = randint(u64(0), MOD - 1);
+            std::vector<modint4> a(n);
+            for (int i = 0; i < n; i++) {
+                a[i] = modint4(b[4 * i], b[4 * i + 1], b[4 * i + 2],
+                               b[4 * i + 3]);
+            }
+
+            auto c = naive_dft(b, inverse);
+            if (inverse) {
+                ifft(a);
+            } else {
+                fft(a);
+            }
+            for (int i = 0; i < n; i++) {
+                ASSERT_EQ(modint4(c[4 * i], c[4 * i + 1], c[4 * i + 2],
+                                  c[4 * i + 3]),
+                          a[i]);
+            }
+        }
+    }
+}
@@ -5,6 +5,7 @@
 
 #include <gtest/gtest.h>
 
+#include "fastfps/allocator.hpp"
 #include "fastfps/fft.hpp"
 #include "fastfps/types.hpp"
 
@@ -138,3 +139,129 @@ TEST(FFTTest, InvButterflyStress) {
         ASSERT_EQ(expect, actual);
     }
 }
+
+TEST(FFTTest, DynModSameAsStatic) {
+    using dmint8 = DynModInt8<0>;
+    DynModInt<0>::set_mod(MOD);
+    for (int lg = 0; lg <= 7; lg++) {
+        int n = 1 << lg;
+        std::vector<modint8> a(n);
+        std::vector<dmint8> b(n);
+        for (int i = 0; i < n; i++) {
+            std::array<u32, 8> buf;
+            for (int j = 0; j < 8; j++) {
+                buf[j] = randint(0u, MOD - 1);
+            }
+            a[i] = modint8(buf);
+            b[i] = dmint8(buf);
+        }
+        fft(a);
+        fft(b);
+        for (int i = 0; i < n; i++) {
+            ASSERT_EQ(a[i].val(), b[i].val());
+        }
+        ifft(a);
+        ifft(b);
+        for (int i = 0; i < n; i++) {
+            ASSERT_EQ(a[i].val(), b[i].val());
+        }
+    }
+}
+
+TEST(FFTTest, LanesStress) {
+    const auto& info = fft_info<MOD>;
+    for (int lg = 0; lg <= 7; lg++) {
+        int n = 1 << lg;
+        std::vector<std::array<u32, 8>> a(n);
+        std::vector<modint8> actual(n);
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < 8; j++) {
+                a[i][j] = randint(0u, MOD - 1);
+            }
+            actual[i] = modint8(a[i]);
+        }
+        fft_lanes(actual);
+
+        for (int i = 0; i < n; i++) {
+            modint base = 1;
+            for (int h = 0; h < info.ord2; h++) {
+                if (i & (1 << h)) {
+                    base = base * info.w[h + 1];
+                }
+            }
+            std::array<modint, 8> expect{};
+            modint rot = 1;
+            for (int k = 0; k < n; k++) {
+                for (int j = 0; j < 8; j++) {
+                    expect[j] += modint(a[k][j]) * rot;
+                }
+                rot = rot * base;
+            }
+            ASSERT_EQ(modint8(expect), actual[i]);
+        }
+
+        ifft_lanes(actual);
+        for (int i = 0; i < n; i++) {
+            ASSERT_EQ(modint8(a[i]) * modint8::set1(n), actual[i]);
+        }
+    }
+}
+
+TEST(FFTTest, Two) {
+    for (int lg = 0; lg <= 9; lg++) {
+        int n = 1 << lg;
+        std::vector<modint8> a(n), b(n);
+        for (int i = 0; i < n; i++) {
+            std::array<u32, 8> x, y;
+            for (int j = 0; j < 8; j++) {
+                x[j] = randint(0u, MOD - 1);
+                y[j] = randint(0u, MOD - 1);
+            }
+            a[i] = modint8(x);
+            b[i] = modint8(y);
+        }
+        auto a2 = a, b2 = b;
+        fft(a);
+        fft(b);
+        fft2(a2, b2);
+        ASSERT_EQ(a, a2);
+        ASSERT_EQ(b, b2);
+        ifft(a);
+        ifft(b);
+        ifft2(a2, b2);
+        ASSERT_EQ(a, a2);
+        ASSERT_EQ(b, b2);
+    }
+}
+
+TEST(FFTTest, Options) {
+    using aligned_vec = std::vector<modint8, AlignedAllocator<modint8>>;
+    for (int lg = 0; lg <= 12; lg += 3) {
+        const int n = 1 << lg;
+        aligned_vec a(n), b(n);
+        for (int i = 0; i < n; i++) {
+            std::array<u32, 8> x, y;
+            for (int j = 0; j < 8; j++) {
+                x[j] = randint(0u, MOD - 1);
+                y[j] = randint(0u, MOD - 1);
+            }
+            a[i] = modint8(x);
+            b[i] = modint8(y);
+        }
+        auto fa = a, fb = b, ib = b;
+        fft(fa);
+        fft(fb);
+        ifft(ib);
+        fft_options().prefetch = true;
+        fft_options().stream_stores = true;
+        auto a2 = a, b2 = b;
+        fft2(a2, b2);
+        ifft(b);
+        fft(a);
+        fft_options() = {};
+        ASSERT_EQ(fa, a);
+        ASSERT_EQ(fa, a2);
+        ASSERT_EQ(fb, b2);
+        ASSERT_EQ(ib, b);
+    }
+}
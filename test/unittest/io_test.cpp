@@ -0,0 +1,130 @@
+#include <cstdio>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "fastfps/io.hpp"
+#include "fastfps/modvec.hpp"
+
+#include "random.hpp"
+
+using namespace fastfps;
+
+const u32 MOD = 998244353;
+using modvec = ModVec<MOD>;
+
+static FILE* file_of(const std::string& s) {
+    FILE* fp = std::tmpfile();
+    std::fwrite(s.data(), 1, s.size(), fp);
+    std::rewind(fp);
+    return fp;
+}
+
+static std::string content(FILE* fp) {
+    std::rewind(fp);
+    std::string s;
+    char c;
+    while (std::fread(&c, 1, 1, fp) == 1) s += c;
+    return s;
+}
+
+TEST(IOTest, ReadInt) {
+    FILE* fp = file_of(
+        "0 1 12345678 123456789 4294967295 -2147483648 2147483647\n"
+        "  18446744073709551615\t-9223372036854775808 \r\n 7");
+    Reader in(fp);
+    ASSERT_EQ(0u, in.read<u32>());
+    ASSERT_EQ(1, in.read<int>());
+    ASSERT_EQ(12345678, in.read<int>());
+    ASSERT_EQ(123456789, in.read<int>());
+    ASSERT_EQ(4294967295u, in.read<u32>());
+    ASSERT_EQ(std::numeric_limits<i32>::min(), in.read<i32>());
+    ASSERT_EQ(std::numeric_limits<i32>::max(), in.read<i32>());
+    ASSERT_EQ(std::numeric_limits<u64>::max(), in.read<u64>());
+    ASSERT_EQ(std::numeric_limits<i64>::min(), in.read<i64>());
+    ASSERT_EQ(7, in.read<int>());
+    std::fclose(fp);
+}
+
+TEST(IOTest, ReadLarge) {
+    // crosses the buffer boundary many times
+    std::vector<u64> a(200000);
+    std::string s;
+    for (auto& x : a) {
+        x = randint<u64>(0, std::numeric_limits<u64>::max()) >>
+            randint(0, 63);
+        s += std::to_string(x);
+        s += randbool() ? " " : "\n";
+    }
+    FILE* fp = file_of(s);
+    Reader in(fp);
+    for (auto x : a) {
+        ASSERT_EQ(x, in.read<u64>());
+    }
+    std::fclose(fp);
+}
+
+TEST(IOTest, ReadModVec) {
+    for (int n : {0, 1, 7, 8, 9, 100}) {
+        std::vector<u32> a(n);
+        std::string s = std::to_string(n);
+        for (auto& x : a) {
+            x = randint(0u, std::numeric_limits<u32>::max());
+            s += ' ';
+            s += std::to_string(x);
+        }
+        FILE* fp = file_of(s);
+        Reader in(fp);
+        modvec v(in.read<int>());
+        in.read(v);
+        ASSERT_EQ(modvec(a), v);
+        std::fclose(fp);
+    }
+}
+
+TEST(IOTest, Write) {
+    FILE* fp = std::tmpfile();
+    std::string expect;
+    {
+        Writer out(fp);
+        out.write(0);
+        out.write(' ');
+        out.write(std::numeric_limits<i64>::min());
+        out.write(' ');
+        out.write(std::numeric_limits<u64>::max());
+        out.write('\n');
+        expect = "0 " + std::to_string(std::numeric_limits<i64>::min()) +
+                 " " + std::to_string(std::numeric_limits<u64>::max()) +
+                 "\n";
+        for (int i = 0; i < 100000; i++) {
+            u64 x = randint<u64>(0, std::numeric_limits<u64>::max()) >>
+                    randint(0, 63);
+            out.write(x);
+            out.write(' ');
+            expect += std::to_string(x) + " ";
+        }
+    }
+    ASSERT_EQ(expect, content(fp));
+    std::fclose(fp);
+}
+
+TEST(IOTest, WriteModVec) {
+    for (int n : {0, 1, 7, 8, 9, 100}) {
+        std::vector<u32> a(n);
+        std::string expect;
+        for (int i = 0; i < n; i++) {
+            a[i] = randint(0u, MOD - 1);
+            if (i) expect += "\n";
+            expect += std::to_string(a[i]);
+        }
+        FILE* fp = std::tmpfile();
+        {
+            Writer out(fp);
+            out.write(modvec(a), '\n');
+        }
+        ASSERT_EQ(expect, content(fp));
+        std::fclose(fp);
+    }
+}
@@ -0,0 +1,89 @@
+#include <array>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "fastfps/modint64.hpp"
+#include "fastfps/modint64x4.hpp"
+#include "fastfps/types.hpp"
+
+#include "random.hpp"
+
+using namespace fastfps;
+
+const u64 MOD = 4179340454199820289;
+using mint = ModInt64<MOD>;
+using mint4 = ModInt64x4<MOD>;
+
+u64 mul_naive(u64 a, u64 b) { return u64((unsigned __int128)a * b % MOD); }
+
+TEST(ModInt64Test, Inv2n64) {
+    for (u64 i = 1; i < 100u; i += 2) {
+        u64 j = inv_u64(i);
+        ASSERT_EQ((i * j), u64(1));
+    }
+}
+
+TEST(ModInt64Test, Constructor) {
+    ASSERT_EQ(u64(3), mint(i32(3)).val());
+    ASSERT_EQ(u64(3), mint(u32(3)).val());
+    ASSERT_EQ(MOD - 3, mint(i64(-3)).val());
+    ASSERT_EQ(u64(3), mint(MOD + 3).val());
+}
+
+TEST(ModInt64Test, Arithmetic) {
+    for (int iter = 0; iter < 1000; iter++) {
+        u64 a = randint(u64(0), MOD - 1), b = randint(u64(0), MOD - 1);
+        ASSERT_EQ((a + b) % MOD, (mint(a) + mint(b)).val());
+        ASSERT_EQ((a + MOD - b) % MOD, (mint(a) - mint(b)).val());
+        ASSERT_EQ(mul_naive(a, b), (mint(a) * mint(b)).val());
+    }
+    ASSERT_EQ(mint(MOD - 1), mint(MOD - 1) * mint(1));
+    ASSERT_EQ(mint(1), mint(MOD - 1) * mint(MOD - 1));
+}
+
+TEST(ModInt64Test, Inv) {
+    for (int i = 1; i <= 100; i++) {
+        ASSERT_EQ(mint(1), mint(i) * mint(i).inv());
+    }
+    ASSERT_EQ(mint(0), mint(0).inv());
+
+    // odd, not prime
+    using cmint = ModInt64<u64(1000000007) * 998244353>;
+    for (int iter = 0; iter < 100; iter++) {
+        const u64 x = randint(u64(1), cmint::mod() - 1);
+        if (std::gcd(x, cmint::mod()) != 1) continue;
+        ASSERT_EQ(cmint(1), cmint(x) * cmint(x).inv());
+    }
+}
+
+TEST(ModInt64x4Test, Arithmetic) {
+    for (int iter = 0; iter < 1000; iter++) {
+        std::array<u64, 4> a, b, add, sub, mul;
+        for (int j = 0; j < 4; j++) {
+            a[j] = randint(u64(0), MOD - 1);
+            b[j] = randint(u64(0), MOD - 1);
+            if (iter == 0) a[j] = b[j] = MOD - 1 - j;
+            add[j] = (a[j] + b[j]) % MOD;
+            sub[j] = (a[j] + MOD - b[j]) % MOD;
+            mul[j] = mul_naive(a[j], b[j]);
+        }
+        ASSERT_EQ(add, (mint4(a) + mint4(b)).val());
+        ASSERT_EQ(sub, (mint4(a) - mint4(b)).val());
+        ASSERT_EQ(mul, (mint4(a) * mint4(b)).val());
+        ASSERT_EQ(mint4(a) * mint4(b),
+                  mint4(mint(a[0]) * mint(b[0]), mint(a[1]) * mint(b[1]),
+                        mint(a[2]) * mint(b[2]), mint(a[3]) * mint(b[3])));
+    }
+}
+
+TEST(ModInt64x4Test, Shuffle) {
+    mint4 a(10, 20, 30, 40);
+    mint4 b(1, 2, 3, 4);
+    ASSERT_EQ(mint4(40, 10, 10, 30), a.permutevar({3, 0, 0, 2}));
+    ASSERT_EQ(mint4(10, 2, 3, 40), blend<0b0110>(a, b));
+    ASSERT_EQ(mint4(1, 20, 3, 40), blendvar(a, b, {1, 0, 5, 0}));
+    ASSERT_EQ(mint4(-10, -20, -30, -40), -a);
+}
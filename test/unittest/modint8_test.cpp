@@ -102,3 +102,48 @@ TEST(ModInt8Test, Neg) {
 
     ASSERT_EQ(modint8(-1, -2, -3, -4, -5, -6, -7, -8), -a);
 }
+
+TEST(ModInt8Test, Transpose) {
+    std::array<modint8, 8> a;
+    for (int i = 0; i < 8; i++) {
+        std::array<u32, 8> b;
+        for (int j = 0; j < 8; j++) {
+            b[j] = 10 * i + j;
+        }
+        a[i] = modint8(b);
+    }
+    modint8::transpose(a);
+    for (int i = 0; i < 8; i++) {
+        std::array<u32, 8> b;
+        for (int j = 0; j < 8; j++) {
+            b[j] = 10 * j + i;
+        }
+        ASSERT_EQ(modint8(b), a[i]);
+    }
+}
+
+TEST(ModInt8Test, LazySum) {
+    // MOD - 1 in both operands is the largest sum
+    for (u32 x : {1u, 12345u, MOD - 1}) {
+        const modint8 r(x, MOD - 1, 0, 1, 2, MOD - 2, x, x);
+        modint8::LazySum s;
+        modint8 expect;
+        for (int i = 0; i < modint8::LazySum::TERMS; i++) {
+            const modint l = (i % 2) ? modint(MOD - 1) : modint(x + i);
+            // l with the normalized internal value
+            std::array<modint, 8> ln;
+            modint8::set1(l).normalized().store(ln);
+            s.add(ln[0], r.normalized());
+            expect += modint8::set1(l) * r;
+        }
+        ASSERT_EQ(expect, s.get());
+    }
+}
+
+TEST(ModInt8Test, Gather) {
+    std::vector<modint> base(20);
+    for (int i = 0; i < 20; i++) base[i] = modint(100 + i);
+    const std::array<u32, 8> idx = {3, 0, 19, 3, 7, 12, 1, 18};
+    ASSERT_EQ(modint8(103, 100, 119, 103, 107, 112, 101, 118),
+              modint8::gather(base, idx));
+}
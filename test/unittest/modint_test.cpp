@@ -63,4 +63,34 @@ TEST(ModIntTest, Inv) {
     for (int i = 1; i <= 100; i++) {
         ASSERT_EQ(mint(1), mint(i) * mint(i).inv());
     }
+    for (u32 x : {MOD - 1, MOD / 2, 1u << 29, 3u << 28}) {
+        ASSERT_EQ(mint(x).pow(MOD - 2), mint(x).inv());
+    }
+    static_assert((mint(3) * mint(3).inv()).val() == 1);
+    // 0 has no inverse: 0 (as 0^(MOD-2)), and it terminates
+    ASSERT_EQ(mint(0), mint(0).inv());
+    ASSERT_EQ(mint(0), mint(MOD).inv());
+}
+
+TEST(ModIntTest, InvComposite) {
+    // 2^30 - 1 = 3^2 * 7 * 11 * 31 * 151 * 331
+    using cmint = ModInt<1'073'741'823>;
+    for (u32 x = 1; x < 1000; x++) {
+        if (std::gcd(x, cmint::mod()) != 1) continue;
+        ASSERT_EQ(cmint(1), cmint(x) * cmint(x).inv());
+    }
+}
+
+TEST(ModIntTest, InvBinary) {
+    for (u32 m : {3u, 998244353u, (1u << 30) - 1}) {
+        for (u32 x = 1; x < std::min(m, 200u); x++) {
+            if (std::gcd(x, m) != 1) continue;
+            auto [y, k] = inv_binary(x, m);
+            ASSERT_LT(y, m);
+            ASSERT_LT(k, 64);
+            u64 p = 1;
+            for (int i = 0; i < k; i++) p = p * 2 % m;
+            ASSERT_EQ(p, u64(x) * y % m);
+        }
+    }
 }
@@ -0,0 +1,75 @@
+#include <array>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "fastfps/modmat.hpp"
+
+#include "random.hpp"
+
+using namespace fastfps;
+
+const u32 MOD = 998244353;
+using modint = ModInt<MOD>;
+using modmat = ModMat<MOD>;
+
+std::vector<std::vector<u32>> random_mat(int h, int w) {
+    std::vector<std::vector<u32>> a(h, std::vector<u32>(w));
+    for (auto& row : a) {
+        for (auto& x : row) x = randint(0u, MOD - 1);
+    }
+    return a;
+}
+
+TEST(ModMatTest, Val) {
+    modmat a({{1, 2, 3}, {4, 5, 6}});
+    ASSERT_EQ(2, a.height());
+    ASSERT_EQ(3, a.width());
+    ASSERT_EQ((std::vector<std::vector<u32>>{{1, 2, 3}, {4, 5, 6}}), a.val());
+    ASSERT_EQ(6u, a.val(1, 2));
+    ASSERT_EQ(0u, a.val(2, 0));
+}
+
+TEST(ModMatTest, AddSub) {
+    modmat a({{1, 2, 3}, {4, 5, 6}});
+    modmat b({{10}, {20}, {30}});
+    ASSERT_EQ(modmat({{11, 2, 3}, {24, 5, 6}, {30, 0, 0}}), a + b);
+    ASSERT_EQ(modmat({{MOD - 9, 2, 3}, {MOD - 16, 5, 6}, {MOD - 30, 0, 0}}),
+              a - b);
+}
+
+TEST(ModMatTest, Resize) {
+    modmat a({{1, 2, 3}, {4, 5, 6}});
+    a.resize(1, 2);
+    ASSERT_EQ(modmat({{1, 2}}), a);
+    a.resize(2, 10);
+    ASSERT_EQ(modmat({{1, 2, 0, 0, 0, 0, 0, 0, 0, 0},
+                      {0, 0, 0, 0, 0, 0, 0, 0, 0, 0}}),
+              a);
+}
+
+TEST(ModMatTest, Mul) {
+    for (auto [h1, w1, h2, w2] : std::vector<std::array<int, 4>>{
+             {1, 1, 1, 1}, {2, 3, 4, 5}, {7, 9, 3, 20}, {17, 1, 1, 33}}) {
+        auto a = random_mat(h1, w1), b = random_mat(h2, w2);
+        std::vector<std::vector<modint>> c(h1 + h2 - 1,
+                                           std::vector<modint>(w1 + w2 - 1));
+        for (int i = 0; i < h1; i++) {
+            for (int j = 0; j < w1; j++) {
+                for (int k = 0; k < h2; k++) {
+                    for (int l = 0; l < w2; l++) {
+                        c[i + k][j + l] += modint(a[i][j]) * modint(b[k][l]);
+                    }
+                }
+            }
+        }
+        std::vector<std::vector<u32>> expect;
+        for (auto& row : c) {
+            expect.push_back({});
+            for (auto x : row) expect.back().push_back(x.val());
+        }
+        ASSERT_EQ(expect, (modmat(a) * modmat(b)).val());
+    }
+}
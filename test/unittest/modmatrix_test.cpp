@@ -0,0 +1,218 @@
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "fastfps/dynmodint.hpp"
+#include "fastfps/modmatrix.hpp"
+
+#include "random.hpp"
+
+using namespace fastfps;
+
+const u32 MOD = 998244353;
+using modint = ModInt<MOD>;
+using modmatrix = ModMatrix<MOD>;
+
+std::vector<std::vector<u32>> random_matrix(int h, int w, u32 mod = MOD) {
+    std::vector<std::vector<u32>> a(h, std::vector<u32>(w));
+    for (auto& row : a) {
+        for (auto& x : row) x = randint(0u, mod - 1);
+    }
+    return a;
+}
+
+std::vector<std::vector<u32>> naive_mul(const std::vector<std::vector<u32>>& a,
+                                        const std::vector<std::vector<u32>>& b,
+                                        u32 mod = MOD) {
+    const int h = int(a.size()), k = int(b.size());
+    const int w = k ? int(b[0].size()) : 0;
+    std::vector<std::vector<u32>> c(h, std::vector<u32>(w));
+    for (int i = 0; i < h; i++) {
+        for (int j = 0; j < w; j++) {
+            u64 s = 0;
+            for (int l = 0; l < k; l++) {
+                s = (s + u64(a[i][l]) * b[l][j]) % mod;
+            }
+            c[i][j] = u32(s);
+        }
+    }
+    return c;
+}
+
+modint naive_det(std::vector<std::vector<u32>> a0) {
+    const int n = int(a0.size());
+    std::vector<std::vector<modint>> a(n);
+    for (int i = 0; i < n; i++) a[i].assign(a0[i].begin(), a0[i].end());
+    modint d = 1;
+    for (int c = 0; c < n; c++) {
+        int p = c;
+        while (p < n && a[p][c] == 0) p++;
+        if (p == n) return 0;
+        if (p != c) {
+            std::swap(a[p], a[c]);
+            d = modint(0) - d;
+        }
+        d *= a[c][c];
+        const modint x = a[c][c].inv();
+        for (int i = c + 1; i < n; i++) {
+            const modint f = a[i][c] * x;
+            for (int j = c; j < n; j++) a[i][j] -= f * a[c][j];
+        }
+    }
+    return d;
+}
+
+TEST(ModMatrixTest, Val) {
+    modmatrix a({{1, 2, 3}, {4, 5, 6}});
+    ASSERT_EQ(2, a.height());
+    ASSERT_EQ(3, a.width());
+    ASSERT_EQ((std::vector<std::vector<u32>>{{1, 2, 3}, {4, 5, 6}}), a.val());
+    ASSERT_EQ(6u, a.val(1, 2));
+    ASSERT_EQ(0u, a.val(2, 0));
+    ASSERT_EQ(modmatrix({{1, 0}, {0, 1}}), modmatrix::identity(2));
+}
+
+TEST(ModMatrixTest, AddSub) {
+    modmatrix a({{1, 2, 3}, {4, 5, 6}}), b({{10, 20, 30}, {40, 50, MOD - 1}});
+    ASSERT_EQ(modmatrix({{11, 22, 33}, {44, 55, 5}}), a + b);
+    ASSERT_EQ(modmatrix({{MOD - 9, MOD - 18, MOD - 27},
+                         {MOD - 36, MOD - 45, 7}}),
+              a - b);
+}
+
+TEST(ModMatrixTest, Mul) {
+    for (auto [h, k, w] : std::vector<std::array<int, 3>>{
+             {1, 1, 1}, {5, 7, 9}, {8, 8, 8}, {13, 300, 17}, {70, 65, 33}}) {
+        auto a = random_matrix(h, k), b = random_matrix(k, w);
+        auto c = modmatrix(a) * modmatrix(b);
+        ASSERT_EQ(h, c.height());
+        ASSERT_EQ(w, c.width());
+        ASSERT_EQ(naive_mul(a, b), c.val());
+    }
+    ASSERT_EQ(modmatrix(0, 4), modmatrix(0, 3) * modmatrix(3, 4));
+    ASSERT_EQ(modmatrix(3, 4), modmatrix(3, 0) * modmatrix(0, 4));
+}
+
+TEST(ModMatrixTest, MulMax) {
+    // the largest lanes for the lazy accumulation
+    const int n = 40;
+    std::vector<std::vector<u32>> a(n, std::vector<u32>(n, MOD - 1));
+    ASSERT_EQ(naive_mul(a, a), (modmatrix(a) * modmatrix(a)).val());
+}
+
+TEST(ModMatrixTest, MulDynMod) {
+    using dynmodint = DynModInt<43>;
+    using dynmodmatrix = DynModMatrix<43>;
+    const u32 mod = (1U << 30) - 3;
+    dynmodint::set_mod(mod);
+    for (int n : {1, 9, 50}) {
+        auto a = random_matrix(n, n, mod), b = random_matrix(n, n, mod);
+        ASSERT_EQ(naive_mul(a, b, mod),
+                  (dynmodmatrix(a) * dynmodmatrix(b)).val());
+    }
+    dynmodint::set_mod(998244353);
+}
+
+TEST(ModMatrixTest, Pow) {
+    const int n = 10;
+    auto a = random_matrix(n, n);
+    modmatrix p = modmatrix::identity(n);
+    for (int k = 0; k <= 10; k++) {
+        ASSERT_EQ(p, modmatrix(a).pow(k));
+        p *= modmatrix(a);
+    }
+    ASSERT_EQ(modmatrix({{1, 2}, {0, 1}}).pow(u64(1) << 40),
+              modmatrix({{1, u32((u64(2) << 40) % MOD)}, {0, 1}}));
+}
+
+TEST(ModMatrixTest, Det) {
+    ASSERT_EQ(modint(1), modmatrix().det());
+    ASSERT_EQ(modint(-2), modmatrix({{1, 2}, {3, 4}}).det());
+    ASSERT_EQ(modint(0), modmatrix({{1, 2}, {2, 4}}).det());
+    ASSERT_EQ(modint(-1), modmatrix({{0, 1}, {1, 0}}).det());
+    for (int n : {1, 3, 8, 9, 40}) {
+        auto a = random_matrix(n, n);
+        ASSERT_EQ(naive_det(a), modmatrix(a).det());
+        // a zero column and a zero row after the first pivots
+        for (auto& row : a) row[n / 2] = 0;
+        ASSERT_EQ(modint(0), modmatrix(a).det());
+    }
+}
+
+TEST(ModMatrixTest, Rank) {
+    ASSERT_EQ(0, modmatrix(3, 5).rank());
+    for (auto [h, w] : std::vector<std::pair<int, int>>{
+             {1, 1}, {5, 3}, {3, 5}, {20, 20}, {17, 40}}) {
+        for (int r = 2; r <= std::min(h, w); r += 2) {
+            auto a = random_matrix(h, r), b = random_matrix(r, w);
+            ASSERT_EQ(r, (modmatrix(a) * modmatrix(b)).rank());
+        }
+    }
+}
+
+TEST(ModMatrixTest, Inv) {
+    for (int n : {0, 1, 2, 7, 8, 9, 30}) {
+        const modmatrix a(random_matrix(n, n));
+        auto b = a.inv();
+        ASSERT_TRUE(b);
+        ASSERT_EQ(modmatrix::identity(n), a * *b);
+        ASSERT_EQ(modmatrix::identity(n), *b * a);
+    }
+    ASSERT_FALSE(modmatrix({{1, 2}, {2, 4}}).inv());
+}
+
+TEST(ModMatrixTest, Solve) {
+    for (auto [h, w] : std::vector<std::pair<int, int>>{
+             {1, 1}, {5, 5}, {5, 3}, {3, 5}, {20, 33}}) {
+        for (int r : {0, std::min(h, w) / 2, std::min(h, w)}) {
+            const modmatrix a = r ? modmatrix(naive_mul(random_matrix(h, r),
+                                                        random_matrix(r, w)))
+                                  : modmatrix(h, w);
+            // b in the image of a
+            auto x0 = random_matrix(w, 1);
+            auto b = (a * modmatrix(x0)).val();
+            std::vector<u32> bv(h);
+            for (int i = 0; i < h; i++) bv[i] = b[i][0];
+            auto x = a.solve(bv);
+            ASSERT_TRUE(x);
+            ASSERT_EQ(w, std::ssize(*x));
+            std::vector<std::vector<u32>> xm(w);
+            for (int i = 0; i < w; i++) xm[i] = {(*x)[i]};
+            ASSERT_EQ(b, (a * modmatrix(xm)).val());
+        }
+    }
+    ASSERT_FALSE(modmatrix({{1, 2}, {2, 4}}).solve({1, 1}));
+}
+
+TEST(ModMatrixTest, Charpoly) {
+    ASSERT_EQ(ModVec<MOD>({1}), modmatrix().charpoly());
+    // x^2 - 5 x - 2
+    ASSERT_EQ(ModVec<MOD>({MOD - 2, MOD - 5, 1u}),
+              modmatrix({{1, 2}, {3, 4}}).charpoly());
+    for (int n : {1, 3, 8, 9, 30}) {
+        for (int zeros : {0, 1}) {
+            auto a = random_matrix(n, n);
+            // sparse, so that the Hessenberg reduction needs to swap
+            if (zeros) {
+                for (auto& row : a) {
+                    for (auto& x : row) x = randint(0, 3) ? 0 : x;
+                }
+            }
+            const auto p = modmatrix(a).charpoly();
+            ASSERT_EQ(n + 1, p.size());
+            // p(x) = det(x I - A)
+            const u32 x = randint(0u, MOD - 1);
+            auto b = a;
+            for (int i = 0; i < n; i++) {
+                for (int j = 0; j < n; j++) {
+                    b[i][j] = ((i == j ? x : 0) + MOD - a[i][j]) % MOD;
+                }
+            }
+            modint px = 0;
+            for (int i = n; i >= 0; i--) {
+                px = px * modint(x) + modint(p.val(i));
+            }
+            ASSERT_EQ(naive_det(b), px);
+        }
+    }
+}
@@ -0,0 +1,55 @@
+#include <array>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "fastfps/modvec64.hpp"
+
+#include "random.hpp"
+
+using namespace fastfps;
+
+const u64 MOD = 4179340454199820289;
+using modint = ModInt64<MOD>;
+using modvec = ModVec64<MOD>;
+
+TEST(ModVec64Test, Val) {
+    modvec a = modvec({0, 1, 2, 3, 4, 5, MOD + 6});
+    ASSERT_EQ(std::vector<u64>({0, 1, 2, 3, 4, 5, 6}), a.val());
+    ASSERT_EQ(u64(5), a.val(5));
+    ASSERT_EQ(u64(0), a.val(7));
+}
+
+TEST(ModVec64Test, AddSub) {
+    modvec a = modvec({1, 2, 3, 4, 5});
+    modvec b = modvec({10, 20});
+    ASSERT_EQ(modvec({11, 22, 3, 4, 5}), a + b);
+    ASSERT_EQ(modvec({MOD - 9, MOD - 18, 3, 4, 5}), a - b);
+}
+
+TEST(ModVec64Test, Resize) {
+    modvec a = modvec({1, 2, 3, 4, 5, 6});
+    a.resize(2);
+    a.resize(6);
+    ASSERT_EQ(modvec({1, 2, 0, 0, 0, 0}), a);
+}
+
+TEST(ModVec64Test, Mul) {
+    for (int n : {1, 3, 4, 17, 100}) {
+        for (int m : {1, 5, 64}) {
+            std::vector<modint> a(n), b(m);
+            for (auto& x : a) x = randint(u64(0), MOD - 1);
+            for (auto& x : b) x = randint(u64(0), MOD - 1);
+            std::vector<modint> c(n + m - 1);
+            for (int i = 0; i < n; i++) {
+                for (int j = 0; j < m; j++) {
+                    c[i + j] += a[i] * b[j];
+                }
+            }
+            ASSERT_EQ(modvec(c), modvec(a) * modvec(b));
+        }
+    }
+    ASSERT_EQ(modvec({2, 4, 6}), modvec({1, 2, 3}) * modint(2));
+}
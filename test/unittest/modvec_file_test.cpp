@@ -0,0 +1,84 @@
+#include <cstdio>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "fastfps/modint.hpp"
+#include "fastfps/modvec.hpp"
+#include "fastfps/modvec_file.hpp"
+
+#include "random.hpp"
+
+using namespace fastfps;
+
+const u32 MOD = 998244353;
+using modvec = ModVec<MOD>;
+
+static std::string temp_path() {
+    auto dir = std::filesystem::temp_directory_path();
+    return dir / ("fastfps_modvec_file_test_" +
+                  std::to_string(randint(0u, ~0u)) + ".bin");
+}
+
+TEST(ModVecFileTest, SaveLoad) {
+    const auto path = temp_path();
+    for (int n : {0, 1, 7, 8, 9, 1000}) {
+        auto a = random_modvec<modvec>(n);
+        save_modvec(a, path);
+        ASSERT_EQ(64 + (n + 7) / 8 * 32, std::filesystem::file_size(path));
+        ASSERT_EQ(a, load_modvec<modvec>(path));
+
+        auto m = map_modvec<modvec>(path);
+        ASSERT_EQ(size_t(n), m.size());
+        ASSERT_EQ(a.val(), m.val());
+        ASSERT_EQ(0u, std::uintptr_t(m.blocks().data()) % 64);
+    }
+    std::filesystem::remove(path);
+}
+
+TEST(ModVecFileTest, MapExpr) {
+    const auto path = temp_path();
+    auto a = random_modvec<modvec>(100), b = random_modvec<modvec>(50);
+    save_modvec(a, path);
+    auto m = map_modvec<modvec>(path);
+    ASSERT_EQ(a * b, m.view() * b);
+    ASSERT_EQ(a.substr(3, 40) + b, m.view(3, 40) + b);
+    ASSERT_EQ(dot(a, b), dot(m.view(), b));
+    std::filesystem::remove(path);
+}
+
+TEST(ModVecFileTest, CopyOnWrite) {
+    const auto path = temp_path();
+    auto a = random_modvec<modvec>(20);
+    save_modvec(a, path);
+    {
+        auto m = map_modvec<modvec>(path);
+        for (auto& x : m.blocks()) x += x;
+        ASSERT_EQ(modvec(a + a).val(), m.val());
+    }
+    ASSERT_EQ(a, load_modvec<modvec>(path));
+    std::filesystem::remove(path);
+}
+
+TEST(ModVecFileTest, Error) {
+    const auto path = temp_path();
+    ASSERT_THROW(map_modvec<modvec>(path), std::system_error);
+
+    save_modvec(random_modvec<modvec>(10), path);
+    ASSERT_THROW(map_modvec<ModVec<1000000007>>(path), std::runtime_error);
+
+    // truncated
+    std::filesystem::resize_file(path, 64 + 32);
+    ASSERT_THROW(map_modvec<modvec>(path), std::runtime_error);
+
+    FILE* fp = std::fopen(path.c_str(), "wb");
+    std::fputs("not a modvec file, but long enough to hold the header.....",
+               fp);
+    std::fclose(fp);
+    ASSERT_THROW(load_modvec<modvec>(path), std::runtime_error);
+    std::filesystem::remove(path);
+}
@@ -8,6 +8,9 @@
 #include "fastfps/modint.hpp"
 #include "fastfps/modvec.hpp"
 
+#include "alloc_counter.hpp"
+#include "random.hpp"
+
 using namespace fastfps;
 
 const u32 MOD = 998244353;
@@ -77,6 +80,16 @@ TEST(ModVecTest, RShift) {
     }
     ASSERT_EQ(modvec({0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1}).val(),
               (modvec({1}) << 10).val());
+    for (int n : {1, 7, 8, 9, 20}) {
+        for (int s : {1, 3, 4, 7, 8, 13}) {
+            std::vector<u32> a(n), expect(n + s);
+            for (int i = 0; i < n; i++) {
+                a[i] = randint(0u, MOD - 1);
+                expect[i + s] = a[i];
+            }
+            ASSERT_EQ(modvec(expect), modvec(a) << s);
+        }
+    }
 }
 
 TEST(ModVecTest, Resize) {
@@ -145,3 +158,270 @@ TEST(ModVecTest, LinearRecurrence) {
     modvec a = modvec({3, 4, 6, 10, 18, 34});
     ASSERT_EQ(modvec({-1, 3, -2}), a.berlekamp_massey());
 }
+
+TEST(ModVecTest, DynModMul) {
+    using dmvec = DynModVec<0>;
+    for (u32 mod : {998244353u, 469762049u, 167772161u, 754974721u}) {
+        DynModInt<0>::set_mod(mod);
+        for (int n : {1, 5, 17, 100}) {
+            for (int m : {1, 8, 33}) {
+                std::vector<u32> a(n), b(m);
+                for (auto& x : a) x = randint(0u, mod - 1);
+                for (auto& x : b) x = randint(0u, mod - 1);
+                std::vector<u32> expect(n + m - 1);
+                for (int i = 0; i < n; i++) {
+                    for (int j = 0; j < m; j++) {
+                        expect[i + j] =
+                            u32((expect[i + j] + u64(a[i]) * b[j]) % mod);
+                    }
+                }
+                ASSERT_EQ(expect, (dmvec(a) * dmvec(b)).val());
+            }
+        }
+    }
+    DynModInt<0>::set_mod(998244353);
+}
+
+static std::vector<modint> naive_mul(const modvec& a, const modvec& b) {
+    if (a.size() == 0 || b.size() == 0) return {};
+    std::vector<modint> c(a.size() + b.size() - 1);
+    for (size_t i = 0; i < a.size(); i++) {
+        for (size_t j = 0; j < b.size(); j++) {
+            c[i + j] += modint(a.val(i)) * modint(b.val(j));
+        }
+    }
+    return c;
+}
+
+TEST(ModVecTest, MulWrap) {
+    // products of 8 * 2^k + 1 coefficients use a transform of 8 * 2^k
+    for (int len : {9, 17, 33, 129, 1025}) {
+        for (int n : {1, 2, len / 2, len - 1, len}) {
+            auto a = random_modvec<modvec>(n);
+            auto b = random_modvec<modvec>(len + 1 - n);
+            ASSERT_EQ(modvec(naive_mul(a, b)), a * b);
+            ASSERT_EQ(modvec(naive_mul(a, b)), a * modvec(b));
+        }
+    }
+}
+
+static std::vector<u32> naive_mul(const std::vector<u32>& a,
+                                  const std::vector<u32>& b,
+                                  u32 mod) {
+    std::vector<u32> c(a.size() + b.size() - 1);
+    for (size_t i = 0; i < a.size(); i++) {
+        for (size_t j = 0; j < b.size(); j++) {
+            c[i + j] = u32((c[i + j] + u64(a[i]) * b[j]) % mod);
+        }
+    }
+    return c;
+}
+
+TEST(ModVecTest, MulSplit) {
+    // 2-adic order 10: transforms of at most 2^10 coefficients
+    const u32 mod = 536896513;
+    using smallvec = ModVec<mod>;
+    ASSERT_EQ(128, max_fft_size<smallvec::modint8>());
+    for (auto [n, m] : std::vector<std::pair<int, int>>{
+             {513, 512}, {513, 513}, {1, 1024}, {1, 3000}, {2000, 700},
+             {1024, 1025}, {3001, 2999}}) {
+        std::vector<u32> a(n), b(m);
+        for (auto& x : a) x = randint(0u, mod - 1);
+        for (auto& x : b) x = randint(0u, mod - 1);
+        const auto expect = naive_mul(a, b, mod);
+        const smallvec x(a), y(b);
+        ASSERT_EQ(expect, (x * y).val());
+        ASSERT_EQ(expect, (smallvec(x) *= y).val());
+        ASSERT_EQ(expect, (smallvec(x) *= smallvec(y)).val());
+        ASSERT_EQ(naive_mul(expect, a, mod), (x * y * x).val());
+    }
+}
+
+TEST(ModVecTest, MulSplitDynMod) {
+    using dmvec = DynModVec<49>;
+    // 2-adic order 4: transforms of 2 blocks
+    const u32 mod = 536871089;
+    DynModInt<49>::set_mod(mod);
+    ASSERT_EQ(2, max_fft_size<dmvec::modint8>());
+    for (auto [n, m] : std::vector<std::pair<int, int>>{
+             {8, 9}, {1, 16}, {17, 100}, {300, 250}}) {
+        std::vector<u32> a(n), b(m);
+        for (auto& x : a) x = randint(0u, mod - 1);
+        for (auto& x : b) x = randint(0u, mod - 1);
+        ASSERT_EQ(naive_mul(a, b, mod), (dmvec(a) * dmvec(b)).val());
+    }
+    // 2-adic order 1: no transform
+    DynModInt<49>::set_mod(1000000007);
+    ASSERT_EQ(0, max_fft_size<dmvec::modint8>());
+    DynModInt<49>::set_mod(998244353);
+}
+
+TEST(ModVecTest, Expr) {
+    for (int n : {0, 1, 7, 8, 9, 50}) {
+        for (int m : {1, 8, 30}) {
+            auto a = random_modvec<modvec>(n), b = random_modvec<modvec>(m);
+            modvec ab(naive_mul(a, b));
+            modvec aab(naive_mul(ab, a));
+
+            ASSERT_EQ(ab, a * b);
+            ASSERT_EQ(aab, a * b * a);
+            ASSERT_EQ(aab, a * (a * b));
+            ASSERT_EQ(aab, (a * 1) * (b * a));
+
+            // elementwise only
+            modvec s = a * 3 + b - 2 * a;
+            ASSERT_EQ(modvec(a) += b, s);
+
+            // products of sums
+            modvec p = (a + b) * (a - b);
+            modvec a2(naive_mul(a, a)), b2(naive_mul(b, b));
+            ASSERT_EQ(a2 - b2, p);
+
+            // sum of products of different sizes
+            modvec q = a * a + a * b + b;
+            ASSERT_EQ(a2 + ab + b, q);
+        }
+    }
+}
+
+TEST(ModVecTest, ExprAlias) {
+    for (int n : {1, 8, 13, 40}) {
+        auto a = random_modvec<modvec>(n), b = random_modvec<modvec>(n / 2 + 1);
+        modvec expect = modvec(naive_mul(modvec(naive_mul(a, a)), b));
+        expect = a * 2 - expect;
+
+        modvec c = a;
+        c = c * 2 - c * c * b;
+        ASSERT_EQ(expect, c);
+
+        c = a;
+        c -= c * c * b - c;
+        ASSERT_EQ(expect, c);
+
+        c = a;
+        c *= c + c;
+        ASSERT_EQ(modvec(naive_mul(a, a)) * 2, c);
+    }
+}
+
+TEST(ModVecTest, Move) {
+    auto a = random_modvec<modvec>(30), b = random_modvec<modvec>(20);
+    modvec ab(naive_mul(a, b));
+    {
+        modvec x = a;
+        modvec c = std::move(x) + b;
+        ASSERT_EQ(a + b, c);
+    }
+    {
+        modvec x = a, y = b;
+        modvec c = std::move(x) * 2 - std::move(y);
+        ASSERT_EQ(a * 2 - b, c);
+    }
+    {
+        modvec x = a;
+        modvec c = (std::move(x) * b).eval();
+        ASSERT_EQ(ab, c);
+    }
+    {
+        modvec x = a, y = b;
+        x *= std::move(y);
+        ASSERT_EQ(ab, x);
+        x = a;
+        x *= std::move(x);
+        ASSERT_EQ(modvec(naive_mul(a, a)), x);
+    }
+}
+
+TEST(ModVecTest, AllocCount) {
+    const int n = 1000;
+    auto a = random_modvec<modvec>(n), b = random_modvec<modvec>(n),
+         c = random_modvec<modvec>(n);
+    modvec x, y, z;
+    // the number of heap allocations in f() after it is called once
+    auto count = [&](auto f) {
+        f();
+        const long long start = alloc_count();
+        f();
+        return alloc_count() - start;
+    };
+
+    ASSERT_EQ(0, count([&]() { x += b; }));
+    ASSERT_EQ(0, count([&]() { x = a * 3 + b - c; }));
+    ASSERT_EQ(0, count([&]() {
+                  x = a;
+                  x *= b;
+              }));
+    ASSERT_EQ(0, count([&]() {
+                  x = a;
+                  y = b;
+                  x *= std::move(y);
+              }));
+    ASSERT_EQ(0, count([&]() { x = a * b * c; }));
+    // only the buffer of the result
+    ASSERT_EQ(1, count([&]() { modvec w = a * b + c; }));
+    // only the copy to y: w takes the buffer of y
+    ASSERT_EQ(1, count([&]() {
+                  y = a;
+                  modvec w = std::move(y) * 2 + b;
+              }));
+}
+
+TEST(ModVecTest, TaylorShift) {
+    for (int n : {0, 1, 2, 7, 31, 32, 33, 100, 500}) {
+        for (modint c : {modint(0), modint(1), modint(randint(0u, MOD - 1))}) {
+            auto a = random_modvec<modvec>(n);
+            // sum a[i] (x + c)^i, with (x + c)^i by Pascal's rule
+            std::vector<modint> expect(n), pw = {1};
+            for (int i = 0; i < n; i++) {
+                for (int j = 0; j <= i; j++) {
+                    expect[j] += modint(a.val(i)) * pw[j];
+                }
+                pw.push_back(0);
+                for (int j = i + 1; j >= 0; j--) {
+                    pw[j] = (j ? pw[j - 1] : modint(0)) + pw[j] * c;
+                }
+            }
+            ASSERT_EQ(modvec(expect), a.taylor_shift(c));
+        }
+    }
+}
+
+TEST(ModVecTest, Compose) {
+    for (int n : {0, 1, 2, 3, 7, 8, 9, 31, 64, 100, 257}) {
+        for (int m : {1, 5, n + 3}) {
+            for (bool zero : {true, false}) {
+                auto f = random_modvec<modvec>(m);
+                auto g = random_modvec<modvec>(n + 1);
+                if (zero) g -= modvec({g.val(0)});
+                // Horner: f(g) = f[0] + g (f[1] + g (...))
+                std::vector<modint> gv(n), expect(n);
+                for (int i = 0; i < n; i++) gv[i] = modint(g.val(i));
+                for (int i = m - 1; i >= 0; i--) {
+                    std::vector<modint> next(n);
+                    for (int j = 0; j < n; j++) {
+                        for (int k = 0; j + k < n; k++) {
+                            next[j + k] += expect[j] * gv[k];
+                        }
+                    }
+                    if (n) next[0] += modint(f.val(i));
+                    expect = next;
+                }
+                ASSERT_EQ(modvec(expect), f.compose(g, n));
+            }
+        }
+    }
+}
+
+TEST(ModVecTest, CompositionalInverse) {
+    for (int n : {0, 1, 2, 3, 4, 7, 8, 9, 33, 100, 513}) {
+        auto f = random_modvec<modvec>(n + 2);
+        f -= modvec({f.val(0)});
+        if (f.val(1) == 0) f += modvec({0, 1});
+        auto g = f.compositional_inverse(n);
+        ASSERT_EQ(ssize_t(g.size()), n);
+        std::vector<u32> x(n);
+        if (n >= 2) x[1] = 1;
+        ASSERT_EQ(modvec(x), f.compose(g, n));
+        ASSERT_EQ(g.compose(f, n), modvec(x));
+    }
+}
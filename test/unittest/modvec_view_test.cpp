@@ -0,0 +1,89 @@
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "fastfps/modint.hpp"
+#include "fastfps/modvec.hpp"
+
+#include "random.hpp"
+
+using namespace fastfps;
+
+const u32 MOD = 998244353;
+using modint = ModInt<MOD>;
+using modvec = ModVec<MOD>;
+
+static std::vector<u32> random_u32s(int n) {
+    std::vector<u32> a(n);
+    for (auto& x : a) x = randint(0u, MOD - 1);
+    return a;
+}
+
+TEST(ModVecViewTest, Val) {
+    for (int n = 0; n <= 30; n++) {
+        auto a = random_u32s(n);
+        modvec a2(a);
+        for (int st = 0; st <= n; st++) {
+            for (int len = 0; st + len <= n; len++) {
+                auto v = a2.view(st, len);
+                std::vector<u32> expect(a.begin() + st, a.begin() + st + len);
+                ASSERT_EQ(size_t(len), v.size());
+                ASSERT_EQ(expect, v.val());
+                ASSERT_EQ(modvec(expect), modvec(v));
+                ASSERT_EQ(modvec(expect), a2.substr(st, len));
+                if (len) {
+                    ASSERT_EQ(expect[len - 1], v.val(len - 1));
+                }
+                ASSERT_EQ(0u, v.val(len));
+            }
+        }
+    }
+}
+
+TEST(ModVecViewTest, SubView) {
+    auto a = random_u32s(50);
+    modvec a2(a);
+    auto v = a2.view(3, 40).subview(7, 20);
+    std::vector<u32> expect(a.begin() + 10, a.begin() + 30);
+    ASSERT_EQ(expect, v.val());
+}
+
+TEST(ModVecViewTest, Dot) {
+    auto a = random_u32s(40), b = random_u32s(40);
+    modvec a2(a), b2(b);
+    for (int st1 : {0, 3, 8, 13}) {
+        for (int st2 : {0, 5, 16}) {
+            for (int len : {0, 1, 8, 17, 24}) {
+                modint expect;
+                for (int i = 0; i < len; i++) {
+                    expect += modint(a[st1 + i]) * b[st2 + i];
+                }
+                ASSERT_EQ(expect, dot(a2.view(st1, len), b2.view(st2, len)));
+                // the shorter one decides the length
+                ASSERT_EQ(expect, dot(a2.view(st1, len),
+                                      b2.view(st2, 40 - st2)));
+            }
+        }
+    }
+    ASSERT_EQ(dot(a2, b2), dot(a2, b2.view(0, 40)));
+}
+
+TEST(ModVecViewTest, Expr) {
+    auto a = random_u32s(50), b = random_u32s(30);
+    modvec a2(a), b2(b);
+    for (int st = 0; st < 10; st++) {
+        auto va = a2.view(st, 30);
+        modvec sa = a2.substr(st, 30);
+        ASSERT_EQ(sa + b2, va + b2);
+        ASSERT_EQ(sa * b2, va * b2);
+        ASSERT_EQ(sa * sa - b2 * 3, va * va - b2 * 3);
+
+        // aliasing the destination
+        modvec c = a2;
+        c = c.view(st, 30) * 2 + c;
+        ASSERT_EQ(sa * 2 + a2, c);
+        c = a2;
+        c = c.view(st, 30) * b2;
+        ASSERT_EQ(sa * b2, c);
+    }
+}
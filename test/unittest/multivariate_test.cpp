@@ -0,0 +1,81 @@
+#include <array>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "fastfps/modvec.hpp"
+#include "fastfps/multivariate.hpp"
+
+#include "random.hpp"
+
+using namespace fastfps;
+
+const u32 MOD = 998244353;
+using modint = ModInt<MOD>;
+using modvec = ModVec<MOD>;
+
+std::vector<modint> naive(const std::vector<modint>& a,
+                          const std::vector<modint>& b,
+                          const std::vector<int>& base) {
+    int n = int(a.size());
+    std::vector<modint> c(n);
+    auto digits = [&](int i) {
+        std::vector<int> d;
+        for (int x : base) {
+            d.push_back(i % x);
+            i /= x;
+        }
+        return d;
+    };
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            auto di = digits(i), dj = digits(j);
+            bool ok = true;
+            for (int l = 0; l < int(base.size()); l++) {
+                ok &= di[l] + dj[l] < base[l];
+            }
+            if (ok) c[i + j] += a[i] * b[j];
+        }
+    }
+    return c;
+}
+
+TEST(MultivariateTest, Convolution) {
+    for (auto base : std::vector<std::vector<int>>{
+             {}, {1}, {5}, {2, 3}, {3, 1, 4}, {2, 2, 2, 2}, {7, 5}}) {
+        int n = 1;
+        for (int x : base) n *= x;
+        std::vector<modint> a(n), b(n);
+        for (auto& x : a) x = randint(0u, MOD - 1);
+        for (auto& x : b) x = randint(0u, MOD - 1);
+        ASSERT_EQ(modvec(naive(a, b, base)),
+                  multivariate_convolution(modvec(a), modvec(b), base));
+    }
+}
+
+TEST(MultivariateTest, TotalDegree) {
+    for (auto [n, d] : std::vector<std::pair<int, int>>{
+             {1, 0}, {1, 3}, {5, 1}, {4, 2}, {3, 3}, {2, 4}, {6, 2}}) {
+        int size = 1;
+        for (int l = 0; l < d; l++) size *= n;
+        std::vector<modint> a(size), b(size);
+        for (auto& x : a) x = randint(0u, MOD - 1);
+        for (auto& x : b) x = randint(0u, MOD - 1);
+
+        auto degree = [&](int i) {
+            int s = 0;
+            for (int l = 0; l < d; l++, i /= n) s += i % n;
+            return s;
+        };
+        std::vector<modint> c(size);
+        for (int i = 0; i < size; i++) {
+            for (int j = 0; j < size; j++) {
+                if (degree(i) + degree(j) < n) c[i + j] += a[i] * b[j];
+            }
+        }
+        ASSERT_EQ(modvec(c),
+                  total_degree_convolution(modvec(a), modvec(b), n, d));
+    }
+}
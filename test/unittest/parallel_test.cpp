@@ -0,0 +1,86 @@
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "fastfps/parallel.hpp"
+
+using namespace fastfps;
+
+TEST(ParallelTest, For) {
+    for (int threads : {1, 4}) {
+        set_num_threads(threads);
+        ASSERT_EQ(threads, num_threads());
+        for (int n : {0, 1, 2, 100, 10000}) {
+            for (int grain : {1, 7, 100000}) {
+                std::vector<std::atomic<int>> cnt(n);
+                parallel_for(n, [&](ssize_t i) { cnt[i]++; }, grain);
+                for (int i = 0; i < n; i++) ASSERT_EQ(1, cnt[i]);
+            }
+        }
+    }
+}
+
+TEST(ParallelTest, Nested) {
+    set_num_threads(4);
+    const int n = 50, m = 50;
+    std::vector<std::atomic<int>> cnt(n * m);
+    parallel_for(n, [&](ssize_t i) {
+        parallel_for(m, [&](ssize_t j) { cnt[i * m + j]++; });
+    });
+    for (int i = 0; i < n * m; i++) ASSERT_EQ(1, cnt[i]);
+}
+
+static long long fib(int n) {
+    if (n < 2) return n;
+    long long a, b;
+    parallel_invoke([&] { a = fib(n - 1); }, [&] { b = fib(n - 2); });
+    return a + b;
+}
+
+TEST(ParallelTest, Invoke) {
+    for (int threads : {1, 3, 8}) {
+        set_num_threads(threads);
+        ASSERT_EQ(6765, fib(20));
+    }
+}
+
+TEST(ParallelTest, OtherThreads) {
+    // threads outside the pool share its deque 0
+    set_num_threads(4);
+    std::vector<std::thread> ts;
+    std::vector<long long> res(4);
+    for (int t = 0; t < 4; t++) {
+        ts.emplace_back([&, t] { res[t] = fib(15 + t); });
+    }
+    for (auto& t : ts) t.join();
+    ASSERT_EQ((std::vector<long long>{610, 987, 1597, 2584}), res);
+}
+
+TEST(ParallelTest, Exception) {
+    for (int threads : {1, 4}) {
+        set_num_threads(threads);
+        // the other side is still running when the exception is thrown
+        std::atomic<bool> finished = false;
+        auto slow = [&] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            finished = true;
+        };
+        auto fail = [] { throw std::runtime_error("fail"); };
+
+        ASSERT_THROW(parallel_invoke(slow, fail), std::runtime_error);
+        ASSERT_TRUE(finished);
+        finished = false;
+        ASSERT_THROW(parallel_invoke(fail, slow), std::runtime_error);
+        ASSERT_EQ(threads > 1, finished.load());
+
+        ASSERT_THROW(
+            parallel_for(100, [&](ssize_t i) { if (i == 37) fail(); }),
+            std::runtime_error);
+        // the pool is still usable
+        ASSERT_EQ(6765, fib(20));
+    }
+}
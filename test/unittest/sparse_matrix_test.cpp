@@ -0,0 +1,140 @@
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "fastfps/dynmodint.hpp"
+#include "fastfps/sparse_matrix.hpp"
+
+#include "random.hpp"
+
+using namespace fastfps;
+
+const u32 MOD = 998244353;
+using modint = ModInt<MOD>;
+using modvec = ModVec<MOD>;
+using sparse_matrix = SparseMatrix<MOD>;
+using entry = sparse_matrix::Entry;
+
+// about k nonzero entries per row (with duplicates)
+static sparse_matrix random_sparse(int h, int w, int k) {
+    std::vector<entry> e;
+    for (int i = 0; i < h; i++) {
+        for (int j = 0; j < k && w; j++) {
+            e.push_back({i, randint(0, w - 1), modint(randint(0u, MOD - 1))});
+        }
+    }
+    return sparse_matrix(h, w, e);
+}
+
+TEST(SparseMatrixTest, Entries) {
+    sparse_matrix a(3, 4, {{2, 1, modint(5)},
+                           {0, 3, modint(1)},
+                           {2, 1, modint(3)},
+                           {1, 0, modint(7)},
+                           {1, 0, modint(-7)}});
+    ASSERT_EQ(3, a.height());
+    ASSERT_EQ(4, a.width());
+    ASSERT_EQ(2, a.nonzeros());
+    auto e = a.entries();
+    ASSERT_EQ(2u, e.size());
+    ASSERT_EQ(0, e[0].row);
+    ASSERT_EQ(3, e[0].col);
+    ASSERT_EQ(modint(1), e[0].value);
+    ASSERT_EQ(2, e[1].row);
+    ASSERT_EQ(1, e[1].col);
+    ASSERT_EQ(modint(8), e[1].value);
+    ASSERT_EQ(ModMatrix<MOD>({{0, 0, 0, 1}, {0, 0, 0, 0}, {0, 8, 0, 0}}),
+              a.dense());
+}
+
+TEST(SparseMatrixTest, Mul) {
+    for (auto [h, w, k] : std::vector<std::array<int, 3>>{
+             {1, 1, 1}, {5, 7, 2}, {8, 8, 8}, {13, 300, 5}, {70, 65, 1}}) {
+        auto a = random_sparse(h, w, k);
+        auto x = random_modvec<modvec>(w);
+        auto y = a * x;
+        ASSERT_EQ(h, std::ssize(y));
+        std::vector<std::vector<u32>> xm(w);
+        for (int i = 0; i < w; i++) xm[i] = {x.val(i)};
+        auto yd = a.dense() * ModMatrix<MOD>(xm);
+        for (int i = 0; i < h; i++) ASSERT_EQ(yd.val(i, 0), y.val(i));
+    }
+    ASSERT_EQ(modvec(3), sparse_matrix(3, 0, {}) * modvec());
+}
+
+TEST(SparseMatrixTest, MulDynMod) {
+    using dynmodint = DynModInt<44>;
+    using dynsparse = DynSparseMatrix<44>;
+    const u32 mod = (1U << 30) - 3;
+    dynmodint::set_mod(mod);
+    const int n = 30;
+    std::vector<dynsparse::Entry> e;
+    std::vector<std::vector<u64>> a(n, std::vector<u64>(n));
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < 3; j++) {
+            const int c = randint(0, n - 1);
+            const u32 v = randint(0u, mod - 1);
+            e.push_back({i, c, dynmodint(v)});
+            a[i][c] = (a[i][c] + v) % mod;
+        }
+    }
+    std::vector<u32> x(n);
+    for (auto& v : x) v = randint(0u, mod - 1);
+    const auto y = dynsparse(n, n, e) * DynModVec<44>(x);
+    for (int i = 0; i < n; i++) {
+        u64 s = 0;
+        for (int j = 0; j < n; j++) s = (s + a[i][j] * x[j]) % mod;
+        ASSERT_EQ(u32(s), y.val(i));
+    }
+    dynmodint::set_mod(998244353);
+}
+
+TEST(SparseMatrixTest, Minpoly) {
+    ASSERT_EQ(modvec({1}), wiedemann_minpoly(sparse_matrix()));
+    ASSERT_EQ(modvec({MOD - 1, 1u}),
+              wiedemann_minpoly(sparse_matrix(
+                  3, 3, {{0, 0, 1}, {1, 1, 1}, {2, 2, 1}})));
+    // (x - 1) (x - 2)
+    ASSERT_EQ(modvec({2u, MOD - 3, 1u}),
+              wiedemann_minpoly(sparse_matrix(
+                  4, 4, {{0, 0, 1}, {1, 1, 2}, {2, 2, 1}, {3, 3, 2}})));
+    // a random matrix: the minimal polynomial is the characteristic one
+    for (int n : {1, 8, 9, 40}) {
+        auto a = random_sparse(n, n, n);
+        ASSERT_EQ(a.dense().charpoly(), wiedemann_minpoly(a));
+    }
+}
+
+TEST(SparseMatrixTest, Solve) {
+    for (int n : {0, 1, 2, 7, 8, 9, 100}) {
+        auto a = random_sparse(n, n, 4);
+        // make it regular w.h.p.
+        auto e = a.entries();
+        for (int i = 0; i < n; i++) {
+            e.push_back({i, i, modint(randint(1u, MOD - 1))});
+        }
+        a = sparse_matrix(n, n, e);
+        auto b = random_modvec<modvec>(n);
+        auto x = wiedemann_solve(a, b);
+        ASSERT_TRUE(x);
+        ASSERT_EQ(b, a * *x);
+    }
+    ASSERT_FALSE(
+        wiedemann_solve(sparse_matrix(2, 2, {{0, 0, 1}, {1, 0, 1}}),
+                        modvec({1, 2})));
+}
+
+TEST(SparseMatrixTest, Det) {
+    ASSERT_EQ(modint(1), wiedemann_det(sparse_matrix()));
+    ASSERT_EQ(modint(-1), wiedemann_det(sparse_matrix(
+                              2, 2, {{0, 1, 1}, {1, 0, 1}})));
+    // repeated eigenvalues
+    ASSERT_EQ(modint(12), wiedemann_det(sparse_matrix(
+                              3, 3, {{0, 0, 2}, {1, 1, 2}, {2, 2, 3}})));
+    for (int n : {1, 3, 8, 9, 60}) {
+        for (int k : {1, 3, 10}) {
+            auto a = random_sparse(n, n, k);
+            ASSERT_EQ(a.dense().det(), wiedemann_det(a));
+        }
+    }
+}
@@ -0,0 +1,148 @@
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "fastfps/modint.hpp"
+#include "fastfps/modvec.hpp"
+
+#include "random.hpp"
+
+using namespace fastfps;
+
+const u32 MOD = 998244353;
+using modint = ModInt<MOD>;
+using modvec = ModVec<MOD>;
+using sparse = SparseModVec<MOD>;
+
+// terms at the indices, the first one is c0
+static sparse random_sparse(const std::vector<int>& indices, modint c0) {
+    std::vector<sparse::Term> t;
+    for (int i : indices) {
+        t.push_back({i, i ? modint(randint(1u, MOD - 1)) : c0});
+    }
+    return sparse(t);
+}
+
+static const std::vector<std::vector<int>> INDICES = {
+    {0},
+    {0, 1},
+    {0, 3, 7},
+    {0, 1, 8, 9, 16},
+    {0, 2, 13, 30, 31, 100},
+    {0, 5, 6, 7, 8, 9, 10, 63, 64, 65, 200},
+};
+
+static std::vector<modint> naive_inv(const sparse& f, int n) {
+    std::vector<modint> g(n);
+    const modint i0 = modint(f.val(0)).inv();
+    for (int i = 0; i < n; i++) {
+        modint s = (i == 0);
+        for (int j = 1; j <= i; j++) s -= modint(f.val(j)) * g[i - j];
+        g[i] = s * i0;
+    }
+    return g;
+}
+
+TEST(SparseModVecTest, Construct) {
+    sparse a({{5, modint(3)}, {1, modint(2)}, {5, modint(4)}, {2, modint(0)}});
+    ASSERT_EQ(2u, a.size());
+    ASSERT_EQ(2u, a.val(1));
+    ASSERT_EQ(7u, a.val(5));
+    ASSERT_EQ(0u, a.val(2));
+    ASSERT_EQ(modvec({0, 2, 0, 0, 0, 7, 0}), a.dense(7));
+    ASSERT_EQ(a, sparse(a.dense(100)));
+}
+
+TEST(SparseModVecTest, Inv) {
+    for (const auto& indices : INDICES) {
+        for (int n : {0, 1, 7, 8, 9, 64, 300}) {
+            auto f = random_sparse(indices, modint(randint(1u, MOD - 1)));
+            ASSERT_EQ(modvec(naive_inv(f, n)), sparse_inv(f, n));
+        }
+    }
+}
+
+TEST(SparseModVecTest, DenseInv) {
+    for (const auto& indices : INDICES) {
+        for (int n : {1, 9, 300}) {
+            auto f = random_sparse(indices, modint(1));
+            ASSERT_EQ(modvec(naive_inv(f, n)), f.dense(n).inv(n));
+        }
+    }
+}
+
+TEST(SparseModVecTest, Exp) {
+    for (const auto& indices : INDICES) {
+        for (int n : {0, 1, 7, 8, 9, 64, 300}) {
+            auto f = random_sparse(indices, modint(0));
+            // i g[i] = sum j f[j] g[i - j]
+            std::vector<modint> g(n);
+            for (int i = 0; i < n; i++) {
+                if (i == 0) {
+                    g[i] = 1;
+                    continue;
+                }
+                for (int j = 1; j <= i; j++) {
+                    g[i] += modint(j) * modint(f.val(j)) * g[i - j];
+                }
+                g[i] *= modint(i).inv();
+            }
+            ASSERT_EQ(modvec(g), sparse_exp(f, n));
+        }
+    }
+}
+
+TEST(SparseModVecTest, Log) {
+    for (const auto& indices : INDICES) {
+        for (int n : {0, 1, 7, 8, 9, 64, 300}) {
+            auto f = random_sparse(indices, modint(1));
+            // i g[i] = i f[i] - sum f[j] (i - j) g[i - j]
+            std::vector<modint> g(n);
+            for (int i = 1; i < n; i++) {
+                g[i] = modint(i) * modint(f.val(i));
+                for (int j = 1; j < i; j++) {
+                    g[i] -= modint(f.val(j)) * modint(i - j) * g[i - j];
+                }
+                g[i] *= modint(i).inv();
+            }
+            ASSERT_EQ(modvec(g), sparse_log(f, n));
+        }
+    }
+}
+
+TEST(SparseModVecTest, Pow) {
+    for (const auto& indices : INDICES) {
+        for (int shift : {0, 1, 10}) {
+            std::vector<int> idx;
+            for (int i : indices) idx.push_back(i + shift);
+            auto f = random_sparse(idx, modint(randint(1u, MOD - 1)));
+            for (int n : {0, 1, 9, 64, 150}) {
+                for (u64 k : {0, 1, 2, 5, 31}) {
+                    std::vector<modint> g(n), fd(n);
+                    if (n) g[0] = 1;
+                    for (int i = 0; i < n; i++) fd[i] = modint(f.val(i));
+                    auto mul = [&](const std::vector<modint>& a,
+                                   const std::vector<modint>& b) {
+                        std::vector<modint> c(n);
+                        for (int i = 0; i < n; i++) {
+                            for (int j = 0; i + j < n; j++) {
+                                c[i + j] += a[i] * b[j];
+                            }
+                        }
+                        return c;
+                    };
+                    for (u64 e = k; e; e /= 2) {
+                        if (e & 1) g = mul(g, fd);
+                        fd = mul(fd, fd);
+                    }
+                    ASSERT_EQ(modvec(g), sparse_pow(f, k, n));
+                }
+            }
+        }
+    }
+    // x^(sk) with sk >= n
+    sparse x(std::vector<sparse::Term>{{3, modint(1)}});
+    ASSERT_EQ(modvec(10), sparse_pow(x, 4, 10));
+    ASSERT_EQ(modvec(10), sparse_pow(x, u64(1) << 62, 10));
+    ASSERT_EQ(modvec({0, 0, 0, 0, 0, 0, 0, 0, 0, 1}), sparse_pow(x, 3, 10));
+}
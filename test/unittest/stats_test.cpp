@@ -0,0 +1,55 @@
+// built as a separate executable with FASTFPS_STATS defined
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "fastfps/modint.hpp"
+#include "fastfps/modvec.hpp"
+#include "fastfps/stats.hpp"
+
+using namespace fastfps;
+
+const u32 MOD = 998244353;
+using modvec = ModVec<MOD>;
+
+static_assert(Stats::enabled);
+
+TEST(StatsTest, Mul) {
+    std::vector<u32> a0(1000, 1), b0(1000, 2);
+    modvec a(a0), b(b0);
+    reset_stats();
+
+    modvec c = a * b;
+    auto s = stats();
+    // 1999 coefficients: 250 blocks -> 256
+    ASSERT_EQ(2u, s.fft_count[8]);
+    ASSERT_EQ(1u, s.ifft_count[8]);
+    ASSERT_EQ(2 * 8 * 256u, s.get_elements(StatsPhase::FFT));
+    ASSERT_EQ(8 * 256u, s.get_elements(StatsPhase::IFFT));
+    ASSERT_EQ(8 * 256u, s.get_elements(StatsPhase::POINTWISE));
+    ASSERT_EQ(0u, s.get_elements(StatsPhase::CONVERT));
+    ASSERT_LT(0u, s.get_ticks(StatsPhase::FFT));
+    ASSERT_LT(0u, s.alloc_count);
+    ASSERT_LE(c.blocks().size_bytes(), s.alloc_bytes);
+
+    c.val();
+    ASSERT_EQ(1999u, stats().get_elements(StatsPhase::CONVERT));
+
+    reset_stats();
+    s = stats();
+    ASSERT_EQ(0u, s.fft_count[8]);
+    ASSERT_EQ(0u, s.get_ticks(StatsPhase::FFT));
+    ASSERT_EQ(0u, s.alloc_bytes);
+}
+
+TEST(StatsTest, MulAssign) {
+    std::vector<u32> a0(100, 1), b0(100, 2);
+    modvec a(a0), b(b0);
+    reset_stats();
+    a *= b;
+    // 199 coefficients: 25 blocks -> 32
+    auto s = stats();
+    ASSERT_EQ(2u, s.fft_count[5]);
+    ASSERT_EQ(1u, s.ifft_count[5]);
+    ASSERT_EQ(8 * 32u, s.get_elements(StatsPhase::POINTWISE));
+}
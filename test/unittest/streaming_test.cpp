@@ -0,0 +1,87 @@
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "fastfps/dynmodint.hpp"
+#include "fastfps/streaming.hpp"
+
+#include "random.hpp"
+
+using namespace fastfps;
+
+const u32 MOD = 998244353;
+using modvec = ModVec<MOD>;
+using streaming = StreamingConvolver<MOD>;
+
+// pushes x in random chunks and concatenates the output
+template <class convolver, class modvec>
+static std::vector<u32> stream(convolver& conv, const modvec& x) {
+    std::vector<u32> y;
+    auto emit = [&](const modvec& c) {
+        EXPECT_LE(std::ssize(c), conv.block());
+        for (size_t i = 0; i < c.size(); i++) y.push_back(c.val(i));
+    };
+    for (ssize_t i = 0; i < std::ssize(x);) {
+        const int c = std::min(randint(0, 40), int(x.size() - i));
+        conv.push(x.view(i, c), [&](const modvec& d) {
+            EXPECT_EQ(conv.block(), std::ssize(d));
+            emit(d);
+        });
+        i += c;
+    }
+    conv.finish(emit);
+    return y;
+}
+
+template <class modvec> static std::vector<u32> vals(const modvec& a) {
+    std::vector<u32> v(a.size());
+    for (size_t i = 0; i < a.size(); i++) v[i] = a.val(i);
+    return v;
+}
+
+TEST(StreamingTest, Convolve) {
+    for (int k : {1, 2, 7, 8, 9, 100}) {
+        for (int block : {0, 1, 8, 30}) {
+            const auto kernel = random_modvec<modvec>(k);
+            streaming conv(kernel, block);
+            ASSERT_EQ(k, conv.kernel_size());
+            ASSERT_EQ(0, conv.block() % 8);
+            ASSERT_LE(std::max(block, 1), int(conv.block()));
+            ASSERT_LE(conv.block() + k - 1, conv.fft_size());
+            for (int n : {0, 1, 13, 64, 500}) {
+                const auto x = random_modvec<modvec>(n);
+                const auto expect =
+                    n ? vals(modvec(x * kernel)) : std::vector<u32>();
+                ASSERT_EQ(expect, stream(conv, x));
+            }
+        }
+    }
+}
+
+TEST(StreamingTest, WholeBlocks) {
+    const auto kernel = random_modvec<modvec>(5);
+    streaming conv(kernel, 16);
+    const auto x = random_modvec<modvec>(int(3 * conv.block()));
+    int chunks = 0;
+    conv.push(x, [&](const modvec&) { chunks++; });
+    ASSERT_EQ(3, chunks);
+    std::vector<u32> tail;
+    conv.finish([&](const modvec& c) {
+        for (size_t i = 0; i < c.size(); i++) tail.push_back(c.val(i));
+    });
+    const modvec y = x * kernel;
+    ASSERT_EQ(vals(modvec(y.view(3 * conv.block(), 4))), tail);
+}
+
+TEST(StreamingTest, DynMod) {
+    using dynmodvec = DynModVec<48>;
+    const u32 mod = 469762049;
+    DynModInt<48>::set_mod(mod);
+    std::vector<u32> a(37), b(300);
+    for (auto& x : a) x = randint(0u, mod - 1);
+    for (auto& x : b) x = randint(0u, mod - 1);
+    const dynmodvec kernel(a), x(b);
+    DynStreamingConvolver<48> conv(kernel);
+    ASSERT_EQ(vals(dynmodvec(x * kernel)), stream(conv, x));
+    DynModInt<48>::set_mod(998244353);
+}
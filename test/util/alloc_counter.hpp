@@ -0,0 +1,100 @@
+#pragma once
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Counts the calls of the global operator new.
+// The replacement functions are not inline: include this header from
+// exactly one translation unit of a binary.
+//
+// Every replaceable form of operator new / delete (single / array, aligned,
+// nothrow, sized) is replaced, all backed by malloc / free, so no allocation
+// of the default (or sanitizer) operator new is freed by the ones below.
+
+inline std::atomic<long long> global_alloc_count = 0;
+
+inline long long alloc_count() {
+    return global_alloc_count.load(std::memory_order_relaxed);
+}
+
+namespace alloc_counter_internal {
+
+inline void* alloc(std::size_t size) noexcept {
+    global_alloc_count.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+inline void* alloc(std::size_t size, std::align_val_t al) noexcept {
+    global_alloc_count.fetch_add(1, std::memory_order_relaxed);
+    const std::size_t a = std::size_t(al);
+    const std::size_t n = (size + a - 1) / a * a;
+    return std::aligned_alloc(a, n ? n : a);
+}
+
+inline void* checked(void* p) {
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+}  // namespace alloc_counter_internal
+
+#pragma GCC diagnostic push
+// operator new / delete below are both backed by malloc / free
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+
+void* operator new(std::size_t size) {
+    return alloc_counter_internal::checked(alloc_counter_internal::alloc(size));
+}
+void* operator new[](std::size_t size) {
+    return alloc_counter_internal::checked(alloc_counter_internal::alloc(size));
+}
+void* operator new(std::size_t size, std::align_val_t al) {
+    return alloc_counter_internal::checked(
+        alloc_counter_internal::alloc(size, al));
+}
+void* operator new[](std::size_t size, std::align_val_t al) {
+    return alloc_counter_internal::checked(
+        alloc_counter_internal::alloc(size, al));
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return alloc_counter_internal::alloc(size);
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return alloc_counter_internal::alloc(size);
+}
+void* operator new(std::size_t size, std::align_val_t al,
+                   const std::nothrow_t&) noexcept {
+    return alloc_counter_internal::alloc(size, al);
+}
+void* operator new[](std::size_t size, std::align_val_t al,
+                     const std::nothrow_t&) noexcept {
+    return alloc_counter_internal::alloc(size, al);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+void operator delete(void* p, std::align_val_t,
+                     const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+void operator delete[](void* p, std::align_val_t,
+                       const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+
+#pragma GCC diagnostic pop
@@ -1,5 +1,7 @@
 
+#include <cstdint>
 #include <random>
+#include <vector>
 
 inline std::mt19937 global_mt19937;
 
@@ -9,6 +11,14 @@ inline T randint(T a, T b) {
     return std::uniform_int_distribution<T>(a, b)(global_mt19937);
 }
 
+// random vector of n coefficients, uniform over the modulus of modvec
+template <class modvec>
+inline modvec random_modvec(int n) {
+    std::vector<std::uint32_t> a(n);
+    for (auto& x : a) x = randint<std::uint32_t>(0, modvec::modint8::mod() - 1);
+    return modvec(a);
+}
+
 inline bool randbool() {
     return randint(0, 1) == 0;
 }